@@ -3,6 +3,8 @@
 
 #include "DistributedGraph.h"
 #include "BasePolicies.h"
+#include "galois/graphs/PartitionFile.h"
+#include <string>
 #include <utility>
 #include <cmath>
 #include <limits>
@@ -542,6 +544,80 @@ class FennelP : public galois::graphs::CustomMasterAssignment {
   }
 };
 
+/**
+ * Edge cut that takes the masters from a precomputed partition file (see
+ * galois/graphs/PartitionFile.h), e.g., one written by gmetis or bipart
+ * with -partitionFile, so a high quality partition can be computed once and
+ * reused by every run. Part i of the file is host i; each host reads only
+ * the parts of the nodes it reads from the graph, and the master assignment
+ * phase shares them with the hosts that need them.
+ */
+class FileP : public galois::graphs::CustomMasterAssignment {
+  //! parts of the nodes this host reads
+  std::vector<uint32_t> _parts;
+  //! first node this host reads
+  uint64_t _partsOffset;
+
+ public:
+  /**
+   * Partition file used by FileP; must be set before partitioning.
+   */
+  static std::string& partitionFile() {
+    static std::string file;
+    return file;
+  }
+
+  FileP(uint32_t hostID, uint32_t numHosts, uint64_t numNodes,
+        uint64_t numEdges) :
+      galois::graphs::CustomMasterAssignment(hostID, numHosts, numNodes,
+                                             numEdges), _partsOffset(0) {
+    if (partitionFile().empty()) {
+      GALOIS_DIE("file partitioning policy needs a partition file");
+    }
+  }
+
+  /**
+   * Saves the read assignment and reads the parts of this host's read nodes
+   * from the partition file.
+   */
+  void saveGIDToHost(std::vector<std::pair<uint64_t, uint64_t>>& gid2host) {
+    galois::graphs::CustomMasterAssignment::saveGIDToHost(gid2host);
+    uint64_t start, end;
+    std::tie(start, end) = _gid2host[_hostID];
+    _parts = galois::graphs::readPartitionFile(partitionFile(), _numNodes,
+                                               _numHosts, start, end);
+    _partsOffset = start;
+  }
+
+  template<typename EdgeTy>
+  uint32_t getMaster(uint32_t src,
+      galois::graphs::BufferedGraph<EdgeTy>&,
+      const std::vector<uint32_t>&,
+      std::unordered_map<uint64_t, uint32_t>&,
+      const std::vector<uint64_t>&,
+      std::vector<galois::CopyableAtomic<uint64_t>>& nodeAccum,
+      const std::vector<uint64_t>&,
+      std::vector<galois::CopyableAtomic<uint64_t>>&) {
+    assert(src >= _partsOffset && src - _partsOffset < _parts.size());
+    uint32_t host = _parts[src - _partsOffset];
+    galois::atomicAdd(nodeAccum[host], (uint64_t)1);
+    return host;
+  }
+
+  // edge cut: all edges on source
+  uint32_t getEdgeOwner(uint32_t src, uint32_t, uint64_t) const {
+    return retrieveMaster(src);
+  }
+
+  bool noCommunication() { return false; }
+  bool isVertexCut() const { return false; }
+  void serializePartition(boost::archive::binary_oarchive&) { return; }
+  void deserializePartition(boost::archive::binary_iarchive&) { return; }
+  std::pair<unsigned, unsigned> cartesianGrid() {
+    return std::make_pair(0u, 0u);
+  }
+};
+
 class SugarP : public galois::graphs::CustomMasterAssignment {
   // used in hybrid cut
   uint32_t _vCutThreshold;
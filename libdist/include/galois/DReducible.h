@@ -26,7 +26,9 @@
 #ifndef GALOIS_DISTACCUMULATOR_H
 #define GALOIS_DISTACCUMULATOR_H
 
+#include <cstring>
 #include <limits>
+#include <tuple>
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
 #include "galois/AtomicHelpers.h"
@@ -35,6 +37,46 @@
 
 namespace galois {
 
+template <typename... Reducers>
+class DGReduceFused;
+
+namespace runtime {
+namespace internal {
+
+#ifndef GALOIS_USE_LWCI
+/**
+ * Returns the MPI datatype corresponding to a type; dies if the type has no
+ * MPI equivalent.
+ *
+ * @tparam Ty type to get the MPI datatype of
+ */
+template <typename Ty>
+MPI_Datatype mpiDatatype() {
+  if (typeid(Ty) == typeid(int32_t)) {
+    return MPI_INT;
+  } else if (typeid(Ty) == typeid(int64_t)) {
+    return MPI_LONG;
+  } else if (typeid(Ty) == typeid(uint32_t)) {
+    return MPI_UNSIGNED;
+  } else if (typeid(Ty) == typeid(uint64_t)) {
+    return MPI_UNSIGNED_LONG;
+  } else if (typeid(Ty) == typeid(float)) {
+    return MPI_FLOAT;
+  } else if (typeid(Ty) == typeid(double)) {
+    return MPI_DOUBLE;
+  } else if (typeid(Ty) == typeid(long double)) {
+    return MPI_LONG_DOUBLE;
+  } else {
+    GALOIS_DIE("type of distributed reducer not supported for MPI reduction");
+  }
+  return MPI_DATATYPE_NULL;
+}
+#endif
+
+} // namespace internal
+} // namespace runtime
+
+
 /**
  * Distributed sum-reducer for getting the sum of some value across multiple
  * hosts.
@@ -48,6 +90,13 @@ class DGAccumulator {
 
   galois::GAccumulator<Ty> mdata;
   Ty local_mdata, global_mdata;
+  bool reducing = false; // true while a reduction started by start_reduce
+                         // has not been completed
+#ifdef GALOIS_USE_LWCI
+  lc_colreq request;
+#else
+  MPI_Request request;
+#endif
 
 #ifdef GALOIS_USE_LWCI
   /**
@@ -57,43 +106,60 @@ class DGAccumulator {
     lc_alreduce(&local_mdata, &global_mdata, sizeof(Ty),
                 &galois::runtime::internal::ompi_op_sum<Ty>, lc_col_ep);
   }
+
+  //! Starts a non-blocking reduction using LWCI
+  inline void start_reduce_lwci() {
+    lc_ialreduce(&local_mdata, &global_mdata, sizeof(Ty),
+                 &galois::runtime::internal::ompi_op_sum<Ty>, lc_col_ep, &request);
+  }
 #else
   /**
    * Sum reduction using MPI
    */
   inline void reduce_mpi() {
-    if (typeid(Ty) == typeid(int32_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_INT, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(int64_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_LONG, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(uint32_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_UNSIGNED, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(uint64_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_UNSIGNED_LONG, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(float)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_FLOAT, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(double)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_DOUBLE, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(long double)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_LONG_DOUBLE, MPI_SUM,
-                    MPI_COMM_WORLD);
-    } else {
-      static_assert(true,
-                    "Type of DGAccumulator not supported for MPI reduction");
-    }
+    MPI_Allreduce(&local_mdata, &global_mdata, 1,
+                  galois::runtime::internal::mpiDatatype<Ty>(), MPI_SUM,
+                  MPI_COMM_WORLD);
+  }
+
+  //! Starts a non-blocking reduction using MPI
+  inline void start_reduce_mpi() {
+    MPI_Iallreduce(&local_mdata, &global_mdata, 1,
+                   galois::runtime::internal::mpiDatatype<Ty>(), MPI_SUM,
+                   MPI_COMM_WORLD, &request);
   }
 #endif
 
+  //! Waits for the reduction started by start_reduce, if any, to complete
+  void wait() {
+    if (!reducing)
+      return;
+#ifdef GALOIS_USE_LWCI
+    while (!request.flag) {
+      lc_col_progress(&request);
+    }
+#else
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+#endif
+    reducing = false;
+  }
+
+  template <typename... Reducers>
+  friend class DGReduceFused;
+
 public:
   //! Default constructor
   DGAccumulator() {}
 
+  //! Waits for an outstanding start_reduce before going away
+  ~DGAccumulator() { wait(); }
+
+  //! Move constructor; must not be used while a reduction is outstanding
+  DGAccumulator(DGAccumulator&&) = default;
+
+  //! Combines two partially reduced values
+  static Ty combine(const Ty& a, const Ty& b) { return a + b; }
+
   /**
    * Adds to accumulated value
    *
@@ -143,7 +209,10 @@ public:
    *
    * @returns the value of the last reduce call
    */
-  Ty read() { return global_mdata; }
+  Ty read() {
+    wait();
+    return global_mdata;
+  }
 
   /**
    * Reset the entire accumulator.
@@ -151,12 +220,33 @@ public:
    * @returns the value of the last reduce call
    */
   Ty reset() {
+    wait();
     Ty retval = global_mdata;
     mdata.reset();
     local_mdata = global_mdata = 0;
     return retval;
   }
 
+  /**
+   * Starts a sum reduction across all hosts without waiting for it to
+   * finish, e.g. at the end of a compute phase so that the reduction
+   * overlaps the sync that follows. The next call to reduce, read or reset
+   * completes it. All hosts must start and complete their reductions in the
+   * same order.
+   */
+  void start_reduce() {
+    wait();
+    if (local_mdata == 0)
+      local_mdata = mdata.reduce();
+
+#ifdef GALOIS_USE_LWCI
+    start_reduce_lwci();
+#else
+    start_reduce_mpi();
+#endif
+    reducing = true;
+  }
+
   /**
    * Reduce data across all hosts, saves the value, and returns the
    * reduced value
@@ -172,15 +262,18 @@ public:
     galois::CondStatTimer<MORE_COMM_STATS> reduceTimer(timer_str.c_str(),
                                                        "DGReducible");
     reduceTimer.start();
-
-    if (local_mdata == 0)
-      local_mdata = mdata.reduce();
+    if (reducing) {
+      wait();
+    } else {
+      if (local_mdata == 0)
+        local_mdata = mdata.reduce();
 
 #ifdef GALOIS_USE_LWCI
-    reduce_lwci();
+      reduce_lwci();
 #else
-    reduce_mpi();
+      reduce_mpi();
 #endif
+    }
 
     reduceTimer.stop();
 
@@ -203,6 +296,13 @@ class DGReduceMax {
 
   galois::GReduceMax<Ty> mdata; // local max reducer
   Ty local_mdata, global_mdata;
+  bool reducing = false; // true while a reduction started by start_reduce
+                         // has not been completed
+#ifdef GALOIS_USE_LWCI
+  lc_colreq request;
+#else
+  MPI_Request request;
+#endif
 
 #ifdef GALOIS_USE_LWCI
   /**
@@ -212,39 +312,47 @@ class DGReduceMax {
     lc_alreduce(&local_mdata, &global_mdata, sizeof(Ty),
                 &galois::runtime::internal::ompi_op_max<Ty>, lc_col_ep);
   }
+
+  //! Starts a non-blocking reduction using LWCI
+  inline void start_reduce_lwci() {
+    lc_ialreduce(&local_mdata, &global_mdata, sizeof(Ty),
+                 &galois::runtime::internal::ompi_op_max<Ty>, lc_col_ep, &request);
+  }
 #else
   /**
    * Use MPI to reduce max across hosts
    */
   inline void reduce_mpi() {
-    if (typeid(Ty) == typeid(int32_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_INT, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(int64_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_LONG, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(uint32_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_UNSIGNED, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(uint64_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_UNSIGNED_LONG, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(float)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_FLOAT, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(double)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_DOUBLE, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(long double)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_LONG_DOUBLE, MPI_MAX,
-                    MPI_COMM_WORLD);
-    } else {
-      static_assert(true, "Type of DGReduceMax not supported for MPI "
-                          "reduction");
-    }
+    MPI_Allreduce(&local_mdata, &global_mdata, 1,
+                  galois::runtime::internal::mpiDatatype<Ty>(), MPI_MAX,
+                  MPI_COMM_WORLD);
+  }
+
+  //! Starts a non-blocking reduction using MPI
+  inline void start_reduce_mpi() {
+    MPI_Iallreduce(&local_mdata, &global_mdata, 1,
+                   galois::runtime::internal::mpiDatatype<Ty>(), MPI_MAX,
+                   MPI_COMM_WORLD, &request);
   }
 #endif
 
+  //! Waits for the reduction started by start_reduce, if any, to complete
+  void wait() {
+    if (!reducing)
+      return;
+#ifdef GALOIS_USE_LWCI
+    while (!request.flag) {
+      lc_col_progress(&request);
+    }
+#else
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+#endif
+    reducing = false;
+  }
+
+  template <typename... Reducers>
+  friend class DGReduceFused;
+
 public:
   /**
    * Default constructor; initializes everything to 0.
@@ -254,6 +362,15 @@ public:
     global_mdata = 0;
   }
 
+  //! Waits for an outstanding start_reduce before going away
+  ~DGReduceMax() { wait(); }
+
+  //! Move constructor; must not be used while a reduction is outstanding
+  DGReduceMax(DGReduceMax&&) = default;
+
+  //! Combines two partially reduced values
+  static Ty combine(const Ty& a, const Ty& b) { return std::max(a, b); }
+
   /**
    * Update the local max-reduced value.
    *
@@ -281,7 +398,10 @@ public:
    *
    * @returns the global value stored in the accumulator
    */
-  Ty read() { return global_mdata; }
+  Ty read() {
+    wait();
+    return global_mdata;
+  }
 
   /**
    * Reset this accumulator.
@@ -290,12 +410,33 @@ public:
    * never reduced, it will be 0
    */
   Ty reset() {
+    wait();
     Ty retval = global_mdata;
     mdata.reset();
     local_mdata = global_mdata = 0;
     return retval;
   }
 
+  /**
+   * Starts a max reduction across all hosts without waiting for it to
+   * finish, e.g. at the end of a compute phase so that the reduction
+   * overlaps the sync that follows. The next call to reduce, read or reset
+   * completes it. All hosts must start and complete their reductions in the
+   * same order.
+   */
+  void start_reduce() {
+    wait();
+    if (local_mdata == 0)
+      local_mdata = mdata.reduce();
+
+#ifdef GALOIS_USE_LWCI
+    start_reduce_lwci();
+#else
+    start_reduce_mpi();
+#endif
+    reducing = true;
+  }
+
   /**
    * Do a max reduction across all hosts by sending data to all other hosts
    * and reducing received data.
@@ -309,14 +450,18 @@ public:
                                                        "DGReduceMax");
 
     reduceTimer.start();
-    if (local_mdata == 0)
-      local_mdata = mdata.reduce();
+    if (reducing) {
+      wait();
+    } else {
+      if (local_mdata == 0)
+        local_mdata = mdata.reduce();
 
 #ifdef GALOIS_USE_LWCI
-    reduce_lwci();
+      reduce_lwci();
 #else
-    reduce_mpi();
+      reduce_mpi();
 #endif
+    }
     reduceTimer.stop();
 
     return global_mdata;
@@ -338,6 +483,13 @@ class DGReduceMin {
 
   galois::GReduceMin<Ty> mdata; // local min reducer
   Ty local_mdata, global_mdata;
+  bool reducing = false; // true while a reduction started by start_reduce
+                         // has not been completed
+#ifdef GALOIS_USE_LWCI
+  lc_colreq request;
+#else
+  MPI_Request request;
+#endif
 
 #ifdef GALOIS_USE_LWCI
   /**
@@ -347,38 +499,46 @@ class DGReduceMin {
     lc_alreduce(&local_mdata, &global_mdata, sizeof(Ty),
                 &galois::runtime::internal::ompi_op_min<Ty>, lc_col_ep);
   }
+
+  //! Starts a non-blocking reduction using LWCI
+  inline void start_reduce_lwci() {
+    lc_ialreduce(&local_mdata, &global_mdata, sizeof(Ty),
+                 &galois::runtime::internal::ompi_op_min<Ty>, lc_col_ep, &request);
+  }
 #else
   /**
    * Use MPI to reduce min across hosts
    */
   inline void reduce_mpi() {
-    if (typeid(Ty) == typeid(int32_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_INT, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(int64_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_LONG, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(uint32_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_UNSIGNED, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(uint64_t)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_UNSIGNED_LONG, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(float)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_FLOAT, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(double)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_DOUBLE, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else if (typeid(Ty) == typeid(long double)) {
-      MPI_Allreduce(&local_mdata, &global_mdata, 1, MPI_LONG_DOUBLE, MPI_MIN,
-                    MPI_COMM_WORLD);
-    } else {
-      static_assert(true, "Type of DGReduceMin not supported for MPI "
-                          "reduction");
-    }
+    MPI_Allreduce(&local_mdata, &global_mdata, 1,
+                  galois::runtime::internal::mpiDatatype<Ty>(), MPI_MIN,
+                  MPI_COMM_WORLD);
   }
+
+  //! Starts a non-blocking reduction using MPI
+  inline void start_reduce_mpi() {
+    MPI_Iallreduce(&local_mdata, &global_mdata, 1,
+                   galois::runtime::internal::mpiDatatype<Ty>(), MPI_MIN,
+                   MPI_COMM_WORLD, &request);
+  }
+#endif
+
+  //! Waits for the reduction started by start_reduce, if any, to complete
+  void wait() {
+    if (!reducing)
+      return;
+#ifdef GALOIS_USE_LWCI
+    while (!request.flag) {
+      lc_col_progress(&request);
+    }
+#else
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
 #endif
+    reducing = false;
+  }
+
+  template <typename... Reducers>
+  friend class DGReduceFused;
 
 public:
   /**
@@ -390,6 +550,15 @@ public:
     ;
   }
 
+  //! Waits for an outstanding start_reduce before going away
+  ~DGReduceMin() { wait(); }
+
+  //! Move constructor; must not be used while a reduction is outstanding
+  DGReduceMin(DGReduceMin&&) = default;
+
+  //! Combines two partially reduced values
+  static Ty combine(const Ty& a, const Ty& b) { return std::min(a, b); }
+
   /**
    * Update the local min-reduced value.
    *
@@ -417,7 +586,10 @@ public:
    *
    * @returns the global value stored in the accumulator
    */
-  Ty read() { return global_mdata; }
+  Ty read() {
+    wait();
+    return global_mdata;
+  }
 
   /**
    * Reset this accumulator.
@@ -426,12 +598,33 @@ public:
    * never reduced, it will be 0
    */
   Ty reset() {
+    wait();
     Ty retval = global_mdata;
     mdata.reset();
     local_mdata = global_mdata = std::numeric_limits<Ty>::max();
     return retval;
   }
 
+  /**
+   * Starts a min reduction across all hosts without waiting for it to
+   * finish, e.g. at the end of a compute phase so that the reduction
+   * overlaps the sync that follows. The next call to reduce, read or reset
+   * completes it. All hosts must start and complete their reductions in the
+   * same order.
+   */
+  void start_reduce() {
+    wait();
+    if (local_mdata == std::numeric_limits<Ty>::max())
+      local_mdata = mdata.reduce();
+
+#ifdef GALOIS_USE_LWCI
+    start_reduce_lwci();
+#else
+    start_reduce_mpi();
+#endif
+    reducing = true;
+  }
+
   /**
    * Do a min reduction across all hosts by sending data to all other hosts
    * and reducing received data.
@@ -445,19 +638,210 @@ public:
                                                        "DGReduceMin");
 
     reduceTimer.start();
-    if (local_mdata == std::numeric_limits<Ty>::max())
-      local_mdata = mdata.reduce();
+    if (reducing) {
+      wait();
+    } else {
+      if (local_mdata == std::numeric_limits<Ty>::max())
+        local_mdata = mdata.reduce();
 
 #ifdef GALOIS_USE_LWCI
-    reduce_lwci();
+      reduce_lwci();
 #else
-    reduce_mpi();
+      reduce_mpi();
 #endif
+    }
     reduceTimer.stop();
 
     return global_mdata;
   }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Reduces several distributed reducers (DGAccumulator, DGReduceMax and
+ * DGReduceMin) across all hosts with a single collective instead of one
+ * collective each. The local values of the reducers are packed into one
+ * buffer that is reduced field by field with each reducer's own combine.
+ * After reduce, read on each reducer returns its reduced value.
+ *
+ * @tparam Reducers types of the distributed reducers to reduce together
+ */
+template <typename... Reducers>
+class DGReduceFused {
+  //! Size of the packed local values in bytes
+  static constexpr size_t numBytes =
+      (sizeof(decltype(std::declval<Reducers&>().read_local())) + ... + 0);
+
+  std::tuple<Reducers&...> reducers;
+  uint8_t local_mdata[numBytes];
+  uint8_t global_mdata[numBytes];
+  bool reducing;
+#ifdef GALOIS_USE_LWCI
+  lc_colreq request;
+#else
+  MPI_Request request;
+#endif
+
+  //! Combines the field at offset of 2 packed buffers into dst
+  template <typename R>
+  static void combineField(uint8_t* dst, const uint8_t* src, size_t& offset) {
+    using Ty = decltype(std::declval<R&>().read_local());
+    Ty a, b;
+    std::memcpy(&a, dst + offset, sizeof(Ty));
+    std::memcpy(&b, src + offset, sizeof(Ty));
+    a = R::combine(a, b);
+    std::memcpy(dst + offset, &a, sizeof(Ty));
+    offset += sizeof(Ty);
+  }
+
+  //! Combines count packed buffers of src into the ones of dst
+  static void combine(uint8_t* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      size_t offset = 0;
+      (combineField<Reducers>(dst + i * numBytes, src + i * numBytes, offset),
+       ...);
+    }
+  }
+
+#ifdef GALOIS_USE_LWCI
+  //! LWCI reduction operator on packed buffers
+  static void lwciOp(void* dst, void* src, size_t count) {
+    combine((uint8_t*)dst, (const uint8_t*)src, count / numBytes);
+  }
+#else
+  //! MPI reduction operator on packed buffers
+  static void mpiOp(void* in, void* inout, int* len, MPI_Datatype*) {
+    combine((uint8_t*)inout, (const uint8_t*)in, *len);
+  }
+
+  //! MPI datatype of a packed buffer; created on first use
+  static MPI_Datatype mpiType() {
+    static MPI_Datatype type = [] {
+      MPI_Datatype t;
+      MPI_Type_contiguous(numBytes, MPI_BYTE, &t);
+      MPI_Type_commit(&t);
+      return t;
+    }();
+    return type;
+  }
+
+  //! MPI operator combining packed buffers; created on first use
+  static MPI_Op mpiReduceOp() {
+    static MPI_Op op = [] {
+      MPI_Op o;
+      MPI_Op_create(&mpiOp, 1, &o);
+      return o;
+    }();
+    return op;
+  }
+#endif
+
+  //! Packs the local value of each reducer into local_mdata
+  void pack() {
+    size_t offset = 0;
+    std::apply(
+        [&](auto&... r) {
+          ((std::memcpy(local_mdata + offset, &r.local_mdata,
+                        sizeof(r.local_mdata)),
+            offset += sizeof(r.local_mdata)),
+           ...);
+        },
+        reducers);
+  }
+
+  //! Unpacks global_mdata into the global value of each reducer
+  void unpack() {
+    size_t offset = 0;
+    std::apply(
+        [&](auto&... r) {
+          ((std::memcpy(&r.global_mdata, global_mdata + offset,
+                        sizeof(r.global_mdata)),
+            offset += sizeof(r.global_mdata)),
+           ...);
+        },
+        reducers);
+  }
+
+  //! Computes the local value of each reducer and packs them
+  void prepare() {
+    std::apply([](auto&... r) { (r.wait(), ...); }, reducers);
+    std::apply([](auto&... r) { (r.read_local(), ...); }, reducers);
+    pack();
+  }
+
+  //! Waits for the reduction started by start_reduce, if any, to complete
+  void wait() {
+    if (!reducing)
+      return;
+#ifdef GALOIS_USE_LWCI
+    while (!request.flag) {
+      lc_col_progress(&request);
+    }
+#else
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+#endif
+    reducing = false;
+    unpack();
+  }
+
+public:
+  /**
+   * Constructor
+   *
+   * @param rs distributed reducers to reduce together; they must outlive
+   * this object
+   */
+  DGReduceFused(Reducers&... rs) : reducers(rs...), reducing(false) {}
+
+  //! Waits for an outstanding start_reduce before going away
+  ~DGReduceFused() { wait(); }
+
+  /**
+   * Starts reducing all reducers across all hosts without waiting for it to
+   * finish. The next call to reduce completes it.
+   */
+  void start_reduce() {
+    wait();
+    prepare();
+#ifdef GALOIS_USE_LWCI
+    lc_ialreduce(local_mdata, global_mdata, numBytes, &lwciOp, lc_col_ep,
+                 &request);
+#else
+    MPI_Iallreduce(local_mdata, global_mdata, 1, mpiType(), mpiReduceOp(),
+                   MPI_COMM_WORLD, &request);
+#endif
+    reducing = true;
+  }
+
+  /**
+   * Reduces all reducers across all hosts (or completes the reduction
+   * started by start_reduce) and saves the reduced value in each of them.
+   *
+   * @param runID optional argument used to create a statistics timer
+   * for later reporting
+   */
+  void reduce(std::string runID = std::string()) {
+    std::string timer_str("ReduceDGFused_" + runID);
+
+    galois::CondStatTimer<MORE_COMM_STATS> reduceTimer(timer_str.c_str(),
+                                                       "DGReduceFused");
+    reduceTimer.start();
+    if (reducing) {
+      wait();
+    } else {
+      prepare();
+#ifdef GALOIS_USE_LWCI
+      lc_alreduce(local_mdata, global_mdata, numBytes, &lwciOp, lc_col_ep);
+#else
+      MPI_Allreduce(local_mdata, global_mdata, 1, mpiType(), mpiReduceOp(),
+                    MPI_COMM_WORLD);
+#endif
+      unpack();
+    }
+    reduceTimer.stop();
+  }
+};
+
 } // namespace galois
 #endif
@@ -137,6 +137,12 @@ public:
     return retval;
   }
 
+  /**
+   * Does nothing: termination is already detected without blocking. Lets
+   * apps call start_reduce whether they use this or a DGAccumulator.
+   */
+  void start_reduce() {}
+
   void initiate_snapshot() {
 #ifdef GALOIS_USE_LWCI
     lc_ialreduce(&snapshot, &global_snapshot, sizeof(Ty),
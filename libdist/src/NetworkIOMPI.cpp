@@ -20,12 +20,20 @@
 /**
  * @file NetworkIOMPI.cpp
  *
- * Contains an implementation of network IO that uses MPI.
+ * Contains an implementation of network IO that uses MPI, and shared memory
+ * between hosts on the same machine.
  */
 
 #include "galois/runtime/NetworkIO.h"
 #include "galois/runtime/Tracer.h"
+#include "galois/substrate/EnvCheck.h"
 #include "galois/substrate/SimpleLock.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /**
  * MPI implementation of network IO. ASSUMES THAT MPI IS INITIALIZED
@@ -183,8 +191,325 @@ private:
     }
   };
 
+  /**
+   * Shared-memory transport between hosts on the same machine. Each host
+   * owns a segment with one single-producer single-consumer byte ring per
+   * co-located host (itself included). A message is streamed through the
+   * ring of its destination as a header (tag, size) followed by its data, so
+   * messages larger than the ring are fine. Data is copied straight from the
+   * buffer handed to enqueue into the ring and from the ring into the buffer
+   * handed up by dequeue, with no staging copies or MPI calls in between.
+   * Only used if GALOIS_DIST_SHM is set.
+   */
+  struct shmQueueTy {
+    //! Size of the data area of a ring; a power of 2
+    static constexpr size_t ringBytes = 1 << 22;
+
+    //! Positions in a ring; they only grow, so head <= tail always
+    struct ringHeader {
+      alignas(64) std::atomic<uint64_t> head; //!< next byte to read
+      alignas(64) std::atomic<uint64_t> tail; //!< next byte to write
+    };
+
+    //! Bytes taken by a ring in a segment
+    static constexpr size_t ringStride = sizeof(ringHeader) + ringBytes;
+
+    struct ring {
+      ringHeader* header;
+      uint8_t* data;
+    };
+
+    //! Header of a message in a ring
+    struct msgHeader {
+      uint32_t tag;
+      uint32_t unused;
+      uint64_t size;
+    };
+
+    //! Message being written to a ring
+    struct outMessage {
+      uint32_t tag;
+      vTy data;
+      size_t written; //!< bytes of data written so far
+      bool started;   //!< whether the header is written
+      outMessage(uint32_t t, vTy&& d)
+          : tag(t), data(std::move(d)), written(0), started(false) {}
+    };
+
+    //! Message being read from a ring
+    struct inMessage {
+      message m;
+      size_t read; //!< bytes of data read so far
+      bool started; //!< whether the header is read
+      inMessage() : read(0), started(false) {}
+    };
+
+    //! Per co-located host state
+    struct peer {
+      uint32_t host;
+      ring in;  //!< written by the peer, read by this host
+      ring out; //!< written by this host, read by the peer
+      void* segment = nullptr; //!< segment of the peer, holding out
+      std::deque<outMessage> sending;
+      std::deque<uint64_t> unread; //!< ends of written, not yet read messages
+      inMessage receiving;
+    };
+
+    galois::runtime::MemUsageTracker& memUsageTracker;
+    std::atomic<size_t>& inflightSends;
+    std::atomic<size_t>& inflightRecvs;
+
+    std::vector<peer> peers;
+    //! index into peers of each host; -1 if not on this machine
+    std::vector<int> peerOf;
+    void* segment;
+    size_t segmentBytes;
+
+    std::deque<message> done;
+
+    shmQueueTy(galois::runtime::MemUsageTracker& tracker,
+               std::atomic<size_t>& sends, std::atomic<size_t>& recvs)
+        : memUsageTracker(tracker), inflightSends(sends), inflightRecvs(recvs),
+          segment(nullptr), segmentBytes(0) {}
+
+    ~shmQueueTy() {
+      for (auto& p : peers) {
+        munmap(p.segment, segmentBytes);
+      }
+      if (segment) {
+        munmap(segment, segmentBytes);
+      }
+    }
+
+    //! @returns true if messages to host go through shared memory
+    bool local(uint32_t host) const {
+      return host < peerOf.size() && peerOf[host] >= 0;
+    }
+
+    static std::string segmentName(int leader, int host) {
+      return "/galois_" + std::to_string(leader) + "_" + std::to_string(host);
+    }
+
+    static void* mapSegment(int fd, size_t bytes) {
+      void* m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      return (m == MAP_FAILED) ? nullptr : m;
+    }
+
+    //! @returns true if ok is true on all hosts of comm
+    static bool allAgree(bool ok, MPI_Comm comm) {
+      int in = ok, out = 0;
+      handleError(MPI_Allreduce(&in, &out, 1, MPI_INT, MPI_MIN, comm));
+      return out;
+    }
+
+    /**
+     * Finds the hosts on this machine and maps the rings shared with them.
+     * Collective over all hosts. If any host on a machine fails to set up
+     * its segment, all hosts of that machine keep using MPI.
+     */
+    void initialize(int ID, int NUM) {
+      // opt-in until it is shown to beat the MPI library's own shared memory
+      // transport; must be set on all hosts or none
+      if (!galois::substrate::EnvCheck("GALOIS_DIST_SHM")) {
+        return;
+      }
+
+      MPI_Comm node;
+      handleError(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, ID,
+                                      MPI_INFO_NULL, &node));
+      int localNum;
+      handleError(MPI_Comm_size(node, &localNum));
+      if (localNum == 1) {
+        MPI_Comm_free(&node);
+        return;
+      }
+      std::vector<int> hosts(localNum);
+      handleError(
+          MPI_Allgather(&ID, 1, MPI_INT, hosts.data(), 1, MPI_INT, node));
+      int leader = getpid();
+      handleError(MPI_Bcast(&leader, 1, MPI_INT, 0, node));
+      int localID = std::find(hosts.begin(), hosts.end(), ID) - hosts.begin();
+
+      // create this host's segment: ring i is written by co-located host i
+      segmentBytes = localNum * ringStride;
+      std::string name = segmentName(leader, ID);
+      int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      bool ok = (fd >= 0);
+      if (ok) {
+        ok      = (ftruncate(fd, segmentBytes) == 0);
+        segment = ok ? mapSegment(fd, segmentBytes) : nullptr;
+        ok      = ok && segment;
+        close(fd);
+      }
+      if (!ok) {
+        galois::gWarn("[", ID, "] cannot create shared memory segment ", name,
+                      ": ", strerror(errno), "; using MPI on this machine");
+      }
+
+      // map the segments of the other hosts
+      if (allAgree(ok, node)) {
+        peers.resize(localNum);
+        for (int i = 0; i < localNum && ok; ++i) {
+          auto& p = peers[i];
+          p.host  = hosts[i];
+          p.in.header =
+              reinterpret_cast<ringHeader*>((uint8_t*)segment + i * ringStride);
+          p.in.data = (uint8_t*)p.in.header + sizeof(ringHeader);
+          fd = shm_open(segmentName(leader, hosts[i]).c_str(), O_RDWR, 0600);
+          p.segment = (fd >= 0) ? mapSegment(fd, segmentBytes) : nullptr;
+          if (fd >= 0) {
+            close(fd);
+          }
+          ok = (p.segment != nullptr);
+          if (ok) {
+            p.out.header = reinterpret_cast<ringHeader*>(
+                (uint8_t*)p.segment + localID * ringStride);
+            p.out.data = (uint8_t*)p.out.header + sizeof(ringHeader);
+          }
+        }
+        if (!ok) {
+          galois::gWarn("[", ID, "] cannot map shared memory segments: ",
+                        strerror(errno), "; using MPI on this machine");
+        }
+        ok = allAgree(ok, node);
+      } else {
+        ok = false;
+      }
+      // everyone has mapped (or given up on) the segment; drop its name
+      if (segment) {
+        shm_unlink(name.c_str());
+      }
+
+      if (ok) {
+        peerOf.assign(NUM, -1);
+        for (int i = 0; i < localNum; ++i) {
+          peerOf[hosts[i]] = i;
+        }
+      } else {
+        for (auto& p : peers) {
+          if (p.segment) {
+            munmap(p.segment, segmentBytes);
+          }
+        }
+        peers.clear();
+        if (segment) {
+          munmap(segment, segmentBytes);
+          segment = nullptr;
+        }
+      }
+      MPI_Comm_free(&node);
+    }
+
+    //! Copies n bytes from src to the ring starting at position pos
+    static void copyIn(ring& r, uint64_t pos, const uint8_t* src, size_t n) {
+      size_t offset = pos & (ringBytes - 1);
+      size_t first  = std::min(n, ringBytes - offset);
+      std::memcpy(r.data + offset, src, first);
+      std::memcpy(r.data, src + first, n - first);
+    }
+
+    //! Copies n bytes from the ring starting at position pos to dst
+    static void copyOut(ring& r, uint64_t pos, uint8_t* dst, size_t n) {
+      size_t offset = pos & (ringBytes - 1);
+      size_t first  = std::min(n, ringBytes - offset);
+      std::memcpy(dst, r.data + offset, first);
+      std::memcpy(dst + first, r.data, n - first);
+    }
+
+    void send(message m) {
+      auto& p = peers[peerOf[m.host]];
+      galois::runtime::trace("SHM SEND", m.host, m.tag, m.data.size(),
+                             galois::runtime::printVec(m.data));
+      p.sending.emplace_back(m.tag, std::move(m.data));
+    }
+
+    /**
+     * Writes as much of the pending messages to p as its ring has room for.
+     * A message stays in flight until p has read all of it, like the
+     * synchronous MPI sends do.
+     */
+    void write(peer& p) {
+      ring& r       = p.out;
+      uint64_t tail = r.header->tail.load(std::memory_order_relaxed);
+      uint64_t head = r.header->head.load(std::memory_order_acquire);
+
+      while (!p.unread.empty() && p.unread.front() <= head) {
+        p.unread.pop_front();
+        --inflightSends;
+      }
+
+      size_t space = ringBytes - (tail - head);
+      while (!p.sending.empty()) {
+        auto& f = p.sending.front();
+        if (!f.started) {
+          if (space < sizeof(msgHeader)) {
+            break;
+          }
+          msgHeader h{f.tag, 0, f.data.size()};
+          copyIn(r, tail, (const uint8_t*)&h, sizeof(msgHeader));
+          tail += sizeof(msgHeader);
+          space -= sizeof(msgHeader);
+          f.started = true;
+        }
+        size_t n = std::min(space, f.data.size() - f.written);
+        copyIn(r, tail, f.data.data() + f.written, n);
+        tail += n;
+        space -= n;
+        f.written += n;
+        if (f.written < f.data.size()) {
+          break;
+        }
+        memUsageTracker.decrementMemUsage(f.data.size());
+        p.unread.push_back(tail);
+        p.sending.pop_front();
+      }
+      r.header->tail.store(tail, std::memory_order_release);
+    }
+
+    //! Reads what p has written to its ring
+    void read(peer& p) {
+      ring& r       = p.in;
+      uint64_t head = r.header->head.load(std::memory_order_relaxed);
+      uint64_t tail = r.header->tail.load(std::memory_order_acquire);
+      auto& cur     = p.receiving;
+
+      while (head != tail) {
+        if (!cur.started) {
+          msgHeader h;
+          copyOut(r, head, (uint8_t*)&h, sizeof(msgHeader));
+          head += sizeof(msgHeader);
+          cur.m       = message(p.host, h.tag, vTy(h.size));
+          cur.read    = 0;
+          cur.started = true;
+          // counted before the sender sees the message read
+          ++inflightRecvs;
+          memUsageTracker.incrementMemUsage(h.size);
+        }
+        size_t n = std::min<size_t>(tail - head, cur.m.data.size() - cur.read);
+        copyOut(r, head, cur.m.data.data() + cur.read, n);
+        head += n;
+        cur.read += n;
+        if (cur.read == cur.m.data.size()) {
+          galois::runtime::trace("SHM RECV", cur.m.host, cur.m.tag,
+                                 cur.m.data.size());
+          done.emplace_back(std::move(cur.m));
+          cur.started = false;
+        }
+      }
+      r.header->head.store(head, std::memory_order_release);
+    }
+
+    void progress() {
+      for (auto& p : peers) {
+        write(p);
+        read(p);
+      }
+    }
+  };
+
   sendQueueTy sendQueue;
   recvQueueTy recvQueue;
+  shmQueueTy shmQueue;
 
 public:
   /**
@@ -198,10 +523,12 @@ public:
       std::atomic<size_t>& sends, std::atomic<size_t>& recvs, 
       uint32_t& ID, uint32_t& NUM)
       : NetworkIO(tracker, sends, recvs),
-        sendQueue(tracker, inflightSends), recvQueue(tracker, inflightRecvs) {
+        sendQueue(tracker, inflightSends), recvQueue(tracker, inflightRecvs),
+        shmQueue(tracker, inflightSends, inflightRecvs) {
     auto p = getIDAndHostNum();
     ID     = p.first;
     NUM    = p.second;
+    shmQueue.initialize(ID, NUM);
   }
 
   /**
@@ -209,7 +536,11 @@ public:
    */
   virtual void enqueue(message m) {
     memUsageTracker.incrementMemUsage(m.data.size());
-    sendQueue.send(std::move(m));
+    if (shmQueue.local(m.host)) {
+      shmQueue.send(std::move(m));
+    } else {
+      sendQueue.send(std::move(m));
+    }
   }
 
   /**
@@ -221,6 +552,11 @@ public:
       recvQueue.done.pop_front();
       return msg;
     }
+    if (!shmQueue.done.empty()) {
+      auto msg = std::move(shmQueue.done.front());
+      shmQueue.done.pop_front();
+      return msg;
+    }
     return message{~0U, 0, vTy()};
   }
 
@@ -230,6 +566,7 @@ public:
   virtual void progress() {
     sendQueue.complete();
     recvQueue.probe();
+    shmQueue.progress();
   }
 }; // end NetworkIOMPI class
 
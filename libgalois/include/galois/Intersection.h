@@ -0,0 +1,137 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file Intersection.h
+ *
+ * Kernels intersecting two sorted sets of node ids, the inner loop of
+ * triangle counting, k-truss and clique listing. Inputs must be sorted in
+ * increasing order and free of duplicates.
+ *
+ * Besides the scalar merge there are block merges using AVX2 and AVX-512
+ * (compare a block of one list against every rotation of a block of the
+ * other) and a galloping search for pairs of very different sizes. The
+ * default (AUTO) picks galloping for skewed pairs and otherwise the widest
+ * block merge the CPU supports, which is detected once at run time, so the
+ * library does not need to be built for a specific instruction set.
+ *
+ * For a hub, a set that is intersected with many others, NodeBitmap turns
+ * each intersection into one probe per element of the other set.
+ */
+
+#ifndef GALOIS_INTERSECTION_H
+#define GALOIS_INTERSECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace galois {
+namespace intersection {
+
+enum Kernel {
+  //! galloping for skewed pairs, otherwise the best block merge available
+  AUTO,
+  SCALAR,
+  GALLOP,
+  AVX2,
+  AVX512
+};
+
+//! Widest block merge supported by this CPU, or SCALAR
+Kernel bestKernel();
+
+//! Whether k can run on this CPU
+bool isSupported(Kernel k);
+
+const char* kernelName(Kernel k);
+
+//! Size ratio from which AUTO gallops through the larger set
+constexpr size_t gallopRatio = 64;
+
+//! Number of elements common to a and b
+size_t count(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+             Kernel k = AUTO);
+
+/**
+ * Writes the elements common to a and b to out in increasing order.
+ * out must have room for min(na, nb) elements.
+ *
+ * @returns number of elements written
+ */
+size_t intersect(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                 uint32_t* out, Kernel k = AUTO);
+size_t intersect(const uint64_t* a, size_t na, const uint64_t* b, size_t nb,
+                 uint64_t* out, Kernel k = AUTO);
+
+/**
+ * For every common element, writes its index in a to posA and its index in
+ * b to posB, in increasing order. Both must have room for min(na, nb)
+ * elements. Useful when the caller has per-element state next to the sets
+ * (e.g., edge data).
+ *
+ * @returns number of common elements
+ */
+size_t intersectPositions(const uint32_t* a, size_t na, const uint32_t* b,
+                          size_t nb, uint32_t* posA, uint32_t* posB,
+                          Kernel k = AUTO);
+
+/**
+ * Membership bitmap over node ids [0, universe) for a set that is
+ * intersected with many others. Setting and clearing cost the size of the
+ * set, so one bitmap (e.g., per thread) can be reused for every hub.
+ */
+class NodeBitmap {
+  std::vector<uint64_t> bits;
+
+public:
+  NodeBitmap() = default;
+  explicit NodeBitmap(size_t universe) { resize(universe); }
+
+  //! Makes room for ids [0, universe) and empties the bitmap
+  void resize(size_t universe) { bits.assign((universe + 63) / 64, 0); }
+
+  size_t universe() const { return bits.size() * 64; }
+
+  void set(const uint32_t* a, size_t na) {
+    for (size_t i = 0; i < na; ++i)
+      bits[a[i] / 64] |= uint64_t(1) << (a[i] % 64);
+  }
+
+  //! Empties the bitmap given the set last passed to set()
+  void clear(const uint32_t* a, size_t na) {
+    for (size_t i = 0; i < na; ++i)
+      bits[a[i] / 64] = 0;
+  }
+
+  bool test(uint32_t x) const { return bits[x / 64] >> (x % 64) & 1; }
+
+  //! Number of elements of b in the bitmap; b need not be sorted
+  size_t count(const uint32_t* b, size_t nb) const {
+    size_t r = 0;
+    for (size_t i = 0; i < nb; ++i)
+      r += test(b[i]);
+    return r;
+  }
+};
+
+} // namespace intersection
+} // namespace galois
+
+#endif
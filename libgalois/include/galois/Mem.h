@@ -26,9 +26,7 @@ namespace galois {
 
 //! [PerIterAllocTy example]
 //! Base allocator for per-iteration allocator
-typedef galois::runtime::BumpWithMallocHeap<
-    galois::runtime::FreeListHeap<galois::runtime::SystemHeap>>
-    IterAllocBaseTy;
+typedef galois::runtime::IterAllocHeap IterAllocBaseTy;
 
 //! Per-iteration allocator that conforms to STL allocator interface
 typedef galois::runtime::ExternalHeapAllocator<char, IterAllocBaseTy>
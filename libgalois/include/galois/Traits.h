@@ -210,6 +210,16 @@ struct no_pushes : public trait_has_type<bool>, no_pushes_tag {};
 struct per_iter_alloc_tag {};
 struct per_iter_alloc : public trait_has_type<bool>, per_iter_alloc_tag {};
 
+/**
+ * Like per_iter_alloc, but per-iteration memory comes from pages of
+ * runtime::NumaPageArena that are recycled across iterations. Meant for
+ * operators that allocate heavily in every iteration.
+ */
+struct per_iter_arena_tag {};
+struct per_iter_arena : public trait_has_type<bool>,
+                        per_iter_alloc_tag,
+                        per_iter_arena_tag {};
+
 /**
  * Indicates the operator doesn't need its execution stats recorded
  */
@@ -65,6 +65,8 @@ protected:
 
   void __resetAlloc() { IterationAllocatorBase.clear(); }
 
+  void __useArenaAlloc() { IterationAllocatorBase.useArena(); }
+
   void __setFirstPass(void) { firstPassFlag = true; }
 
   void __resetFirstPass(void) { firstPassFlag = false; }
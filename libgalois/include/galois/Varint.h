@@ -0,0 +1,91 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file Varint.h
+ *
+ * Byte-oriented variable length integer encoding (LEB128 style): 7 bits of
+ * payload per byte, high bit set on every byte but the last. Small values
+ * (e.g., gaps between sorted neighbor ids) take a single byte.
+ */
+
+#ifndef GALOIS_VARINT_H
+#define GALOIS_VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace galois {
+
+//! Number of bytes needed to varint encode v
+inline size_t varintSize(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    ++n;
+  }
+  return n;
+}
+
+/**
+ * Varint encode v into out.
+ *
+ * @returns pointer one past the last byte written
+ */
+inline uint8_t* encodeVarint(uint8_t* out, uint64_t v) {
+  while (v >= 0x80) {
+    *out++ = static_cast<uint8_t>(v) | 0x80;
+    v >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(v);
+  return out;
+}
+
+/**
+ * Decode a varint starting at in into v.
+ *
+ * @returns pointer one past the last byte read
+ */
+inline const uint8_t* decodeVarint(const uint8_t* in, uint64_t& v) {
+  uint64_t b = *in++;
+  v          = b & 0x7F;
+  if (b < 0x80)
+    return in;
+  unsigned shift = 7;
+  do {
+    b = *in++;
+    v |= (b & 0x7F) << shift;
+    shift += 7;
+  } while (b >= 0x80);
+  return in;
+}
+
+//! Map signed values to unsigned ones so that small magnitudes stay small
+inline uint64_t zigzagEncode(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+//! Inverse of zigzagEncode
+inline int64_t zigzagDecode(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+} // namespace galois
+
+#endif
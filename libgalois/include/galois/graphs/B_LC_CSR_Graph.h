@@ -135,6 +135,11 @@ protected:
     }
   }
 
+  //! Number of entries in inEdgeData; none if edges have no data
+  uint64_t numInEdgeData() const {
+    return std::is_void<EdgeTy>::value ? 0 : BaseGraph::numEdges;
+  }
+
   /**
    * Determine the in-edge indices for every node by accumulating how many
    * in-edges each node has, getting a prefix sum, and saving it to the
@@ -240,6 +245,59 @@ public:
     incomingEdgeConstructTimer.stop();
   }
 
+  /////////////////////////////////////////////////////////////////////////////
+  // Snapshots
+  /////////////////////////////////////////////////////////////////////////////
+
+  /**
+   * Writes the graph including its in-edges to a snapshot file; see
+   * LC_CSR_Graph::saveSnapshot.
+   */
+  void saveSnapshot(const std::string& filename, uint64_t flags = 0) {
+    if (isInSortedByDst())
+      flags |= GraphSnapshot::IN_SORTED_BY_DST;
+    GraphSnapshotWriter writer = BaseGraph::makeSnapshotWriter(flags);
+    BaseGraph::addSnapshotSection(writer, GraphSnapshot::IN_INDEX,
+                                  inEdgeIndData, BaseGraph::numNodes);
+    BaseGraph::addSnapshotSection(writer, GraphSnapshot::IN_DST, inEdgeDst,
+                                  BaseGraph::numEdges);
+    BaseGraph::addSnapshotSection(writer, GraphSnapshot::IN_DATA, inEdgeData,
+                                  numInEdgeData());
+    writer.write(filename);
+  }
+
+  /**
+   * Loads a snapshot written by saveSnapshot in place; see
+   * LC_CSR_Graph::loadSnapshot. If the snapshot has no in-edges (e.g., it
+   * was written from an LC_CSR_Graph), they are constructed.
+   *
+   * @returns the GraphSnapshot::Flags of the stored graph
+   */
+  uint64_t loadSnapshot(const std::string& filename) {
+    uint64_t flags = BaseGraph::loadSnapshot(filename);
+
+    EdgeIndData oldIndData;
+    EdgeDst oldDst;
+    EdgeDataRep oldData;
+    swap(inEdgeIndData, oldIndData);
+    swap(inEdgeDst, oldDst);
+    swap(inEdgeData, oldData);
+
+    const GraphSnapshot& snap = *BaseGraph::snapshot;
+    if (BaseGraph::numNodes && !snap.hasSection(GraphSnapshot::IN_INDEX)) {
+      constructIncomingEdges();
+      return flags & ~uint64_t(GraphSnapshot::IN_SORTED_BY_DST);
+    }
+
+    BaseGraph::mapSnapshotSection(snap, GraphSnapshot::IN_INDEX,
+                                  inEdgeIndData, BaseGraph::numNodes);
+    BaseGraph::mapSnapshotSection(snap, GraphSnapshot::IN_DST, inEdgeDst,
+                                  BaseGraph::numEdges);
+    BaseGraph::mapSnapshotSection(snap, GraphSnapshot::IN_DATA, inEdgeData,
+                                  numInEdgeData());
+    return flags;
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Access functions
   /////////////////////////////////////////////////////////////////////////////
@@ -405,6 +463,19 @@ public:
               });
   }
 
+  //! Returns true if the in-edges of every node are sorted by source
+  bool isInSortedByDst() {
+    galois::GReduceLogicalAND sorted;
+    galois::do_all(galois::iterate((size_t)0, this->size()),
+                   [&](GraphNode N) {
+                     sorted.update(
+                         std::is_sorted(inEdgeDst.begin() + *in_raw_begin(N),
+                                        inEdgeDst.begin() + *in_raw_end(N)));
+                   },
+                   galois::no_stats(), galois::steal());
+    return sorted.reduce();
+  }
+
   /**
    * Sorts all incoming edges of all nodes in parallel. Comparison is over
    * getEdgeDst(e).
@@ -685,8 +685,8 @@ public:
   //! nodes
   void phase1() { outIdx.resize(numNodes); }
 
-  //! Increments degree of id by delta
-  void incrementDegree(size_t id, int delta = 1) {
+  //! Increments degree of id by delta; a 64-bit delta holds any degree
+  void incrementDegree(size_t id, int64_t delta = 1) {
     assert(id < numNodes);
     outIdx[id] += delta;
   }
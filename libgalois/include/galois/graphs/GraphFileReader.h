@@ -0,0 +1,101 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GraphFileReader.h
+ *
+ * Positional reader for Galois binary graphs (.gr). Unlike FileGraph, which
+ * maps the whole file and is then copied into the graph, this reads ranges of
+ * the file straight into caller provided memory, so several threads can each
+ * fill the part of a graph they own while the file is read only once.
+ */
+
+#ifndef GALOIS_GRAPHS_GRAPHFILEREADER_H
+#define GALOIS_GRAPHS_GRAPHFILEREADER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace galois {
+namespace graphs {
+
+class GraphFileReader {
+  int fd;
+  uint64_t graphVersion;
+  uint64_t sizeofEdge;
+  uint64_t numNodes;
+  uint64_t numEdges;
+  std::atomic<uint64_t> bytesRead;
+
+  //! Read exactly len bytes at offset, retrying short reads
+  void readAt(void* dst, size_t len, uint64_t offset);
+
+  uint64_t outIdxOffset() const { return 4 * sizeof(uint64_t); }
+  uint64_t outsOffset() const {
+    return outIdxOffset() + numNodes * sizeof(uint64_t);
+  }
+  uint64_t edgeDataOffset() const {
+    return outsOffset() + (numEdges + numEdges % 2) * sizeofEdgeDst();
+  }
+  size_t sizeofEdgeDst() const {
+    return graphVersion == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+  }
+
+public:
+  //! Opens filename and reads its header
+  explicit GraphFileReader(const std::string& filename);
+  ~GraphFileReader();
+
+  GraphFileReader(const GraphFileReader&) = delete;
+  GraphFileReader& operator=(const GraphFileReader&) = delete;
+
+  uint64_t size() const { return numNodes; }
+  uint64_t sizeEdges() const { return numEdges; }
+  //! Size of the edge data of one edge in the file (0 if none)
+  uint64_t edgeDataSize() const { return sizeofEdge; }
+  uint64_t version() const { return graphVersion; }
+
+  //! Total number of bytes read from the file so far
+  uint64_t getBytesRead() const { return bytesRead.load(); }
+
+  /**
+   * Reads the edge end indices (prefix sum of degrees) of nodes [begin, end)
+   * into dst.
+   */
+  void readOutIdx(uint64_t* dst, uint64_t begin, uint64_t end);
+
+  /**
+   * Reads the destinations of edges [begin, end) into dst. Version 2 files
+   * store 64-bit destinations, which are narrowed.
+   */
+  void readEdgeDst(uint32_t* dst, uint64_t begin, uint64_t end);
+
+  /**
+   * Reads the raw edge data (edgeDataSize() bytes each) of edges [begin, end)
+   * into dst.
+   */
+  void readEdgeData(void* dst, uint64_t begin, uint64_t end);
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file GraphSnapshot.h
+ *
+ * On-disk snapshot of a fully constructed in-memory graph. A snapshot holds
+ * the arrays of a graph exactly as they are laid out in memory (after any
+ * transpose, sort or in-edge construction), each starting on a page
+ * boundary, so a graph can be loaded by mapping the file and pointing its
+ * arrays into the mapping instead of reading and rebuilding it.
+ *
+ * Layout:
+ *   Header (padded to one page)
+ *   section[i] for each present section, page aligned
+ *
+ * Arrays are stored in native byte order and the header records the sizes of
+ * the node and edge data types, so snapshots are meant to be produced and
+ * consumed by the same build of an application; use .gr files for exchange.
+ */
+
+#ifndef GALOIS_GRAPHS_GRAPHSNAPSHOT_H
+#define GALOIS_GRAPHS_GRAPHSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * A snapshot file mapped into memory. The mapping is private and writable:
+ * pages are shared with the page cache until they are written to, at which
+ * point the process gets its own copy and the file itself is never
+ * modified.
+ */
+class GraphSnapshot {
+public:
+  //! Arrays that can be stored in a snapshot
+  enum Section : uint32_t {
+    OUT_INDEX = 0,
+    OUT_DST,
+    OUT_DATA,
+    NODE_DATA,
+    IN_INDEX,
+    IN_DST,
+    IN_DATA,
+    NUM_SECTIONS
+  };
+
+  //! Properties of the stored graph
+  enum Flags : uint64_t {
+    //! out-edges of every node are sorted by destination
+    SORTED_BY_DST = 1 << 0,
+    //! in-edges of every node are sorted by source
+    IN_SORTED_BY_DST = 1 << 1,
+    //! the graph is the transpose of its input
+    TRANSPOSED = 1 << 2
+  };
+
+  static const uint64_t MAGIC   = 0x50414e5347434c47ULL; // "GLCGSNAP"
+  static const uint64_t VERSION = 1;
+
+  struct SectionInfo {
+    uint64_t offset;
+    uint64_t bytes;
+  };
+
+  struct Header {
+    uint64_t magic;
+    uint64_t version;
+    uint64_t flags;
+    uint64_t numNodes;
+    uint64_t numEdges;
+    //! size of the stored per-node record (0 if node data is not stored)
+    uint64_t nodeDataSize;
+    //! size of the data of one edge (0 if edges have no data)
+    uint64_t edgeDataSize;
+    SectionInfo sections[NUM_SECTIONS];
+  };
+
+private:
+  void* base;
+  size_t length;
+  Header hdr;
+
+public:
+  //! Maps filename and validates its header
+  explicit GraphSnapshot(const std::string& filename);
+  ~GraphSnapshot();
+
+  GraphSnapshot(const GraphSnapshot&) = delete;
+  GraphSnapshot& operator=(const GraphSnapshot&) = delete;
+
+  const Header& header() const { return hdr; }
+  uint64_t flags() const { return hdr.flags; }
+  uint64_t size() const { return hdr.numNodes; }
+  uint64_t sizeEdges() const { return hdr.numEdges; }
+
+  bool hasSection(Section s) const { return hdr.sections[s].bytes != 0; }
+
+  /**
+   * Returns a pointer to section s in the mapping. Dies if the section does
+   * not hold exactly bytes bytes, which catches snapshots written for a
+   * different graph type. An empty section yields a null pointer.
+   */
+  void* section(Section s, uint64_t bytes) const;
+};
+
+/**
+ * Collects the arrays of a graph and writes them as a snapshot. The data
+ * passed to addSection is not copied and must stay valid until write.
+ */
+class GraphSnapshotWriter {
+  GraphSnapshot::Header hdr;
+  std::vector<const void*> data;
+
+public:
+  GraphSnapshotWriter(uint64_t numNodes, uint64_t numEdges,
+                      uint64_t nodeDataSize, uint64_t edgeDataSize,
+                      uint64_t flags);
+
+  void addSection(GraphSnapshot::Section s, const void* ptr, uint64_t bytes);
+
+  /**
+   * Writes the snapshot to a temporary file next to filename and renames it
+   * into place, so readers never observe a partially written snapshot.
+   */
+  void write(const std::string& filename);
+};
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -21,6 +21,7 @@
 #define GALOIS_GRAPH_LCGRAPH_H
 
 #include "LC_CSR_Graph.h"
+#include "LC_Compressed_Graph.h"
 #include "LC_InlineEdge_Graph.h"
 #include "LC_Linear_Graph.h"
 #include "LC_Morph_Graph.h"
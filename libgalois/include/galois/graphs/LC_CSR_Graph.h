@@ -23,9 +23,15 @@
 #include "galois/Galois.h"
 #include "galois/graphs/Details.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/GraphFileReader.h"
 #include "galois/graphs/GraphHelpers.h"
+#include "galois/graphs/GraphSnapshot.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 /*
  * Headers for boost serialization
@@ -158,6 +164,10 @@ public:
   typedef iterator const_local_iterator;
 
 protected:
+  //! Mapping that arrays loaded by loadSnapshot point into; declared before
+  //! the arrays so it is released after them
+  std::shared_ptr<GraphSnapshot> snapshot;
+
   NodeData nodeData;
   EdgeIndData edgeIndData;
   EdgeDst edgeDst;
@@ -220,6 +230,40 @@ protected:
     edgeData.set(*nn, {});
   }
 
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void readEdgeValues(GraphFileReader&, uint64_t, uint64_t,
+                      typename std::enable_if<!_A1>::type* = 0) {}
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void readEdgeValues(GraphFileReader&, uint64_t begin, uint64_t end,
+                      typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    for (uint64_t e = begin; e < end; ++e)
+      edgeData.set(e, {});
+  }
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void readEdgeValues(GraphFileReader& reader, uint64_t begin, uint64_t end,
+                      typename std::enable_if<_A1 && _A2>::type* = 0) {
+    typedef typename LargeArray<FileEdgeTy>::value_type FileValue;
+    if (std::is_same<FileValue, EdgeTy>::value &&
+        std::is_trivially_copyable<EdgeTy>::value) {
+      reader.readEdgeData(edgeData.data() + begin, begin, end);
+      return;
+    }
+    // convert through a bounded staging buffer
+    const uint64_t chunk = 1 << 16;
+    std::vector<FileValue> buf(std::min(chunk, end - begin));
+    for (uint64_t b = begin; b < end; b += chunk) {
+      uint64_t e = std::min(b + chunk, end);
+      reader.readEdgeData(buf.data(), b, e);
+      for (uint64_t i = b; i < e; ++i)
+        edgeData.set(i, buf[i - b]);
+    }
+  }
+
   size_t getId(GraphNode N) { return N; }
 
   GraphNode getNode(size_t n) { return n; }
@@ -407,6 +451,21 @@ public:
 
   GraphNode getEdgeDst(edge_iterator ni) { return edgeDst[*ni]; }
 
+  /**
+   * Pointer to the destination of edge ni. The destinations of the edges of
+   * a node are contiguous, so getEdgeDstPtr(edge_begin(N)) and
+   * getEdgeDstPtr(edge_end(N)) delimit the neighbors of N as a plain array,
+   * for kernels that work on arrays (e.g., galois/Intersection.h).
+   */
+  const GraphNode* getEdgeDstPtr(edge_iterator ni) const {
+    return edgeDst.data() + *ni;
+  }
+
+  //! Pointer to the data of edge ni; see getEdgeDstPtr
+  edge_data_type* getEdgeDataPtr(edge_iterator ni) {
+    return edgeData.data() + *ni;
+  }
+
   size_t size() const { return numNodes; }
   size_t sizeEdges() const { return numEdges; }
 
@@ -763,6 +822,200 @@ public:
     }
   }
 
+  /**
+   * Returns true if the edge data in the file can be read directly by
+   * constructNodesFrom/constructEdgesFrom (i.e., it is not needed or it has
+   * the size of FileEdgeTy).
+   */
+  bool canConstructFrom(const GraphFileReader& reader) const {
+    return !EdgeData::has_value || !LargeArray<FileEdgeTy>::has_value ||
+           reader.edgeDataSize() == LargeArray<FileEdgeTy>::size_of::value;
+  }
+
+  /**
+   * First phase of streaming a graph from disk: reads the edge indices of an
+   * even share of the nodes into place and constructs their node data.
+   */
+  void constructNodesFrom(GraphFileReader& reader, unsigned tid,
+                          unsigned total) {
+    // at this point memory should already be allocated
+    uint64_t begin = numNodes * tid / total;
+    uint64_t end   = numNodes * (tid + 1) / total;
+    if (begin == end)
+      return;
+
+    reader.readOutIdx(edgeIndData.data() + begin, begin, end);
+    for (uint64_t n = begin; n < end; ++n) {
+      nodeData.constructAt(n);
+      this->outOfLineConstructAt(n);
+    }
+  }
+
+  /**
+   * Second phase of streaming a graph from disk: reads the destinations and
+   * data of the edges of this thread's share of the nodes into place. All
+   * edge indices must have been read.
+   */
+  void constructEdgesFrom(GraphFileReader& reader, unsigned tid,
+                          unsigned total) {
+    auto r = divideByNode(NodeData::size_of::value +
+                              EdgeIndData::size_of::value +
+                              LC_CSR_Graph::size_of_out_of_line::value,
+                          EdgeDst::size_of::value + EdgeData::size_of::value,
+                          tid, total)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    if (r.first == r.second)
+      return;
+    uint64_t begin = *raw_begin(*r.first);
+    uint64_t end   = *raw_end(*r.second - 1);
+    if (begin == end)
+      return;
+
+    reader.readEdgeDst(edgeDst.data() + begin, begin, end);
+    readEdgeValues(reader, begin, end);
+  }
+
+protected:
+  //! Node data can be used in place from a snapshot only if it is trivially
+  //! copyable; otherwise it is constructed when the snapshot is loaded
+  static const bool snapshotNodeData =
+      std::is_trivially_copyable<NodeInfo>::value;
+
+  template <typename ArrayTy>
+  static void addSnapshotSection(GraphSnapshotWriter& writer,
+                                 GraphSnapshot::Section s,
+                                 const ArrayTy& array, uint64_t n) {
+    if (ArrayTy::size_of::value && n)
+      writer.addSection(s, array.begin(), n * ArrayTy::size_of::value);
+  }
+
+  //! Points array at section s of snap without copying
+  template <typename ArrayTy>
+  static void mapSnapshotSection(const GraphSnapshot& snap,
+                                 GraphSnapshot::Section s, ArrayTy& array,
+                                 uint64_t n) {
+    ArrayTy mapped(snap.section(s, n * ArrayTy::size_of::value), n);
+    swap(array, mapped);
+  }
+
+  //! Writer holding the out-edges and node data of this graph
+  GraphSnapshotWriter makeSnapshotWriter(uint64_t flags) {
+    static_assert(std::is_trivially_copyable<
+                      typename LargeArray<EdgeTy>::value_type>::value,
+                  "snapshots need trivially copyable edge data");
+    if (isSortedByDst())
+      flags |= GraphSnapshot::SORTED_BY_DST;
+
+    GraphSnapshotWriter writer(
+        numNodes, numEdges, snapshotNodeData ? NodeData::size_of::value : 0,
+        EdgeData::size_of::value, flags);
+    addSnapshotSection(writer, GraphSnapshot::OUT_INDEX, edgeIndData,
+                       numNodes);
+    addSnapshotSection(writer, GraphSnapshot::OUT_DST, edgeDst, numEdges);
+    addSnapshotSection(writer, GraphSnapshot::OUT_DATA, edgeData, numEdges);
+    if (snapshotNodeData)
+      addSnapshotSection(writer, GraphSnapshot::NODE_DATA, nodeData,
+                         numNodes);
+    return writer;
+  }
+
+public:
+  //! Returns true if the out-edges of every node are sorted by destination
+  bool isSortedByDst() {
+    galois::GReduceLogicalAND sorted;
+    galois::do_all(galois::iterate(size_t{0}, this->size()),
+                   [&](GraphNode N) {
+                     sorted.update(
+                         std::is_sorted(edgeDst.begin() + *raw_begin(N),
+                                        edgeDst.begin() + *raw_end(N)));
+                   },
+                   galois::no_stats(), galois::steal());
+    return sorted.reduce();
+  }
+
+  /**
+   * Writes this graph, as constructed, to a snapshot file that loadSnapshot
+   * can use in place. Whether edges are sorted by destination is detected
+   * and recorded; other properties of how the graph was derived from its
+   * input (e.g., GraphSnapshot::TRANSPOSED) are passed in flags. Node data
+   * is stored only if it is trivially copyable.
+   */
+  void saveSnapshot(const std::string& filename, uint64_t flags = 0) {
+    makeSnapshotWriter(flags).write(filename);
+  }
+
+  /**
+   * Replaces this graph with the one stored in a snapshot. The edge arrays
+   * (and node data, if it was stored with the same record size) point into
+   * a private mapping of the file, so nothing is read or copied up front:
+   * pages are faulted in on first access and copied only when written.
+   * Mapped pages are placed by the kernel, so UseNumaAlloc only applies to
+   * arrays that have to be constructed.
+   *
+   * @returns the GraphSnapshot::Flags of the stored graph
+   */
+  uint64_t loadSnapshot(const std::string& filename) {
+    static_assert(std::is_trivially_copyable<
+                      typename LargeArray<EdgeTy>::value_type>::value,
+                  "snapshots need trivially copyable edge data");
+    galois::StatTimer timer("LoadSnapshot");
+    timer.start();
+
+    auto snap = std::make_shared<GraphSnapshot>(filename);
+    if (snap->size() > std::numeric_limits<GraphNode>::max())
+      GALOIS_DIE("graph snapshot has too many nodes: ", snap->size());
+    if (snap->header().edgeDataSize != EdgeData::size_of::value)
+      GALOIS_DIE("graph snapshot has edge data of size ",
+                 snap->header().edgeDataSize, " but graph expects ",
+                 EdgeData::size_of::value);
+
+    deallocate();
+    numNodes = snap->size();
+    numEdges = snap->sizeEdges();
+    mapSnapshotSection(*snap, GraphSnapshot::OUT_INDEX, edgeIndData,
+                       numNodes);
+    mapSnapshotSection(*snap, GraphSnapshot::OUT_DST, edgeDst, numEdges);
+    mapSnapshotSection(*snap, GraphSnapshot::OUT_DATA, edgeData, numEdges);
+
+    bool mapNodes = snapshotNodeData && numNodes &&
+                    snap->header().nodeDataSize == NodeData::size_of::value;
+    if (mapNodes) {
+      mapSnapshotSection(*snap, GraphSnapshot::NODE_DATA, nodeData, numNodes);
+    } else if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+    }
+    if (UseNumaAlloc) {
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideByNode(NodeData::size_of::value +
+                                EdgeIndData::size_of::value +
+                                LC_CSR_Graph::size_of_out_of_line::value,
+                            EdgeDst::size_of::value + EdgeData::size_of::value,
+                            tid, total)
+                   .first;
+      this->setLocalRange(*r.first, *r.second);
+
+      for (uint64_t n = *r.first; n < *r.second; ++n) {
+        if (!mapNodes)
+          nodeData.constructAt(n);
+        this->outOfLineConstructAt(n);
+      }
+    });
+
+    snapshot = std::move(snap);
+    timer.stop();
+    return snapshot->flags();
+  }
+
   /**
    * Returns the reference to the edgeIndData LargeArray
    * (a prefix sum of edges)
@@ -811,16 +1064,19 @@ public:
                   });
 
 
- galois::on_each(
-        [&](unsigned tid, unsigned total) {
-        std::vector<unsigned> dummy_scale_factor; // dummy passed in to function call
-
-          auto r = divideByNode(0, 1, tid, total).first;
+    determineLocalRanges();
+  }
 
-        //galois::gPrint("[", tid, "] : Ranges : ", *r.first, ", ", *r.second, "\n");
-        this->setLocalRange(*r.first, *r.second);
-        }
-        );
+  /**
+   * Divides the nodes among the threads, by edges, for local iteration;
+   * needed after building the graph with allocateFrom, fixEndEdge and
+   * constructEdge, or after swapping in a graph built that way.
+   */
+  void determineLocalRanges() {
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideByNode(0, 1, tid, total).first;
+      this->setLocalRange(*r.first, *r.second);
+    });
   }
 };
 } // namespace graphs
@@ -0,0 +1,738 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_GRAPH_LC_COMPRESSED_GRAPH_H
+#define GALOIS_GRAPH_LC_COMPRESSED_GRAPH_H
+
+#include "galois/Galois.h"
+#include "galois/Varint.h"
+#include "galois/gIO.h"
+#include "galois/graphs/Details.h"
+#include "galois/graphs/FileGraph.h"
+#include "galois/graphs/GraphHelpers.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+struct read_compressed_graph_tag {};
+
+/**
+ * Local computation graph (i.e., graph structure does not change) whose
+ * adjacency lists are compressed. Neighbors of every node are sorted by
+ * destination and stored as varint encoded gaps: the first neighbor relative
+ * to the source node (zigzag encoded) and every following neighbor relative
+ * to its predecessor. Edge data, if any, is stored uncompressed in the same
+ * (sorted) order.
+ *
+ * Every node's byte stream starts with a skip index that records, for every
+ * skipInterval-th edge, its destination and the position of the gap that
+ * follows it. It is used to search sorted adjacency lists without decoding
+ * them from the start.
+ *
+ * Edges are visited with the same edges()/edge_begin()/getEdgeDst() interface
+ * as {@link LC_CSR_Graph}. Dereferencing an edge iterator gives the edge
+ * index, so getEdgeData() and per-edge arrays indexed by *ii keep working, but
+ * unlike LC_CSR_Graph an edge index cannot be converted back to an iterator.
+ *
+ * The graph can be read from a .gr file (or an in-memory {@link FileGraph})
+ * and persisted with toFile(); readGraph() recognizes files written by
+ * toFile() and loads them without re-encoding.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template <typename NodeTy, typename EdgeTy, bool HasNoLockable = false,
+          bool UseNumaAlloc =
+              false, // true => numa-blocked, false => numa-interleaved
+          bool HasOutOfLineLockable = false, typename FileEdgeTy = EdgeTy>
+class LC_Compressed_Graph
+    : private boost::noncopyable,
+      private internal::LocalIteratorFeature<UseNumaAlloc>,
+      private internal::OutOfLineLockableFeature<HasOutOfLineLockable &&
+                                                 !HasNoLockable> {
+public:
+  template <bool _has_id>
+  struct with_id {
+    typedef LC_Compressed_Graph type;
+  };
+
+  template <typename _node_data>
+  struct with_node_data {
+    typedef LC_Compressed_Graph<_node_data, EdgeTy, HasNoLockable,
+                                UseNumaAlloc, HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  template <typename _edge_data>
+  struct with_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, _edge_data, HasNoLockable,
+                                UseNumaAlloc, HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  template <typename _file_edge_data>
+  struct with_file_edge_data {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                                HasOutOfLineLockable, _file_edge_data>
+        type;
+  };
+
+  //! If true, do not use abstract locks in graph
+  template <bool _has_no_lockable>
+  struct with_no_lockable {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, _has_no_lockable,
+                                UseNumaAlloc, HasOutOfLineLockable, FileEdgeTy>
+        type;
+  };
+
+  //! If true, use NUMA-aware graph allocation
+  template <bool _use_numa_alloc>
+  struct with_numa_alloc {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable,
+                                _use_numa_alloc, HasOutOfLineLockable,
+                                FileEdgeTy>
+        type;
+  };
+
+  //! If true, store abstract locks separate from nodes
+  template <bool _has_out_of_line_lockable>
+  struct with_out_of_line_lockable {
+    typedef LC_Compressed_Graph<NodeTy, EdgeTy, HasNoLockable, UseNumaAlloc,
+                                _has_out_of_line_lockable, FileEdgeTy>
+        type;
+  };
+
+  typedef read_compressed_graph_tag read_tag;
+
+  //! Number of edges between two consecutive skip index entries
+  static const uint32_t skipInterval = 64;
+  //! First word of a file written by toFile()
+  static const uint64_t fileMagic = 0x31524743534c4147ULL; // "GALSCGR1"
+
+protected:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef LargeArray<uint8_t> EdgeBytes;
+  typedef internal::NodeInfoBaseTypes<NodeTy,
+                                      !HasNoLockable && !HasOutOfLineLockable>
+      NodeInfoTypes;
+  typedef internal::NodeInfoBase<NodeTy,
+                                 !HasNoLockable && !HasOutOfLineLockable>
+      NodeInfo;
+  typedef LargeArray<uint64_t> EdgeIndData;
+  typedef LargeArray<NodeInfo> NodeData;
+
+  //! Skip index entry: destination of an edge and the offset (relative to the
+  //! start of the node's gap stream) of the gap following it
+  struct SkipEntry {
+    uint32_t dst;
+    uint32_t offset;
+  };
+
+public:
+  typedef uint32_t GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef FileEdgeTy file_edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename EdgeData::reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  typedef boost::counting_iterator<uint32_t> iterator;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+protected:
+  //! Decoding state of an edge_iterator
+  struct EdgeCursor {
+    const uint8_t* base; //!< start of the gap stream of the node
+    const uint8_t* next; //!< next gap to decode
+    uint64_t first;
+    uint64_t at;
+    uint64_t last;
+    GraphNode src;
+    GraphNode dst;
+
+    EdgeCursor()
+        : base(nullptr), next(nullptr), first(0), at(0), last(0), src(0),
+          dst(0) {}
+
+    EdgeCursor(const uint8_t* b, uint64_t f, uint64_t a, uint64_t l,
+               GraphNode s)
+        : base(b), next(b), first(f), at(l), last(l), src(s), dst(0) {
+      seek(a);
+    }
+
+    //! Restart decoding at the first edge
+    void restart() {
+      uint64_t code;
+      next = decodeVarint(base, code);
+      at   = first;
+      dst  = static_cast<GraphNode>(src + zigzagDecode(code));
+    }
+
+    //! Restart decoding at the skip index entry for edge first + k * interval
+    void jumpToBlock(uint64_t k) {
+      const uint8_t* skips = base - numSkips(last - first) * sizeof(SkipEntry);
+      SkipEntry entry;
+      std::memcpy(&entry, skips + (k - 1) * sizeof(SkipEntry),
+                  sizeof(SkipEntry));
+      next = base + entry.offset;
+      at   = first + k * skipInterval;
+      dst  = entry.dst;
+    }
+
+    void increment() {
+      if (++at < last) {
+        uint64_t gap;
+        next = decodeVarint(next, gap);
+        dst += gap;
+      }
+    }
+
+    void seek(uint64_t target) {
+      if (target >= last || target == at) {
+        at = target;
+        return;
+      }
+      uint64_t block = (target - first) / skipInterval;
+      if (at >= last || target < at || block > (at - first) / skipInterval) {
+        if (block)
+          jumpToBlock(block);
+        else
+          restart();
+      }
+      while (at < target)
+        increment();
+    }
+  };
+
+public:
+  /**
+   * Result of dereferencing an edge_iterator. Converts to the edge index
+   * (what *ii is for LC_CSR_Graph) or back to an edge_iterator, so code that
+   * iterates over raw edge iterator ranges keeps working.
+   */
+  class edge_reference {
+    friend class LC_Compressed_Graph;
+    EdgeCursor cursor;
+
+  public:
+    explicit edge_reference(const EdgeCursor& c) : cursor(c) {}
+    operator uint64_t() const { return cursor.at; }
+  };
+
+  /**
+   * Iterator over the edges of a node. Increments decode one gap and cache
+   * the current destination. Arbitrary jumps use the skip index and decode at
+   * most skipInterval gaps, so the iterator is random access (with bounded
+   * rather than constant cost per jump).
+   */
+  class edge_iterator
+      : public boost::iterator_facade<edge_iterator, uint64_t,
+                                      boost::random_access_traversal_tag,
+                                      edge_reference> {
+    friend class boost::iterator_core_access;
+    friend class LC_Compressed_Graph;
+
+    EdgeCursor cursor;
+
+    explicit edge_iterator(const EdgeCursor& c) : cursor(c) {}
+
+    void increment() { cursor.increment(); }
+
+    void decrement() { cursor.seek(cursor.at - 1); }
+
+    void advance(ptrdiff_t n) { cursor.seek(cursor.at + n); }
+
+    ptrdiff_t distance_to(const edge_iterator& other) const {
+      return other.cursor.at - (ptrdiff_t)cursor.at;
+    }
+
+    bool equal(const edge_iterator& other) const {
+      return cursor.at == other.cursor.at;
+    }
+
+    edge_reference dereference() const { return edge_reference(cursor); }
+
+  public:
+    edge_iterator() = default;
+    edge_iterator(const edge_reference& ref) : cursor(ref.cursor) {}
+  };
+
+  typedef int ReadGraphAuxData;
+
+protected:
+  NodeData nodeData;
+  EdgeIndData edgeIndData;
+  EdgeIndData byteIndData;
+  EdgeBytes edgeBytes;
+  EdgeData edgeData;
+
+  uint64_t numNodes;
+  uint64_t numEdges;
+
+  //! Per-thread scratch space for sorting the neighbors of a node
+  substrate::PerThreadStorage<std::vector<std::pair<GraphNode, uint64_t>>>
+      scratch;
+
+  static uint64_t numSkips(uint64_t degree) {
+    return degree ? (degree - 1) / skipInterval : 0;
+  }
+
+  uint64_t edgeIndBegin(GraphNode N) const {
+    return (N == 0) ? 0 : edgeIndData[N - 1];
+  }
+
+  uint64_t byteIndBegin(GraphNode N) const {
+    return (N == 0) ? 0 : byteIndData[N - 1];
+  }
+
+  const uint8_t* gapBegin(GraphNode N, uint64_t degree) const {
+    return edgeBytes.data() + byteIndBegin(N) +
+           numSkips(degree) * sizeof(SkipEntry);
+  }
+
+  edge_iterator raw_begin(GraphNode N) const {
+    uint64_t first = edgeIndBegin(N);
+    uint64_t last  = edgeIndData[N];
+    return edge_iterator(
+        EdgeCursor(gapBegin(N, last - first), first, first, last, N));
+  }
+
+  edge_iterator raw_end(GraphNode N) const {
+    uint64_t first = edgeIndBegin(N);
+    uint64_t last  = edgeIndData[N];
+    return edge_iterator(
+        EdgeCursor(gapBegin(N, last - first), first, last, last, N));
+  }
+
+  template <bool _A1 = HasNoLockable, bool _A2 = HasOutOfLineLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<!_A1 && !_A2>::type* = 0) {
+    galois::runtime::acquire(&nodeData[N], mflag);
+  }
+
+  template <bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    this->outOfLineAcquire(N, mflag);
+  }
+
+  template <bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag,
+                   typename std::enable_if<_A2>::type* = 0) {}
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph, uint64_t e, uint64_t fileEdge,
+                          typename std::enable_if<!_A1 || _A2>::type* = 0) {
+    typedef LargeArray<FileEdgeTy> FED;
+    if (EdgeData::has_value)
+      edgeData.set(e, graph.getEdgeData<typename FED::value_type>(
+                          FileGraph::edge_iterator(fileEdge)));
+  }
+
+  template <bool _A1 = EdgeData::has_value,
+            bool _A2 = LargeArray<FileEdgeTy>::has_value>
+  void constructEdgeValue(FileGraph& graph, uint64_t e, uint64_t fileEdge,
+                          typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    edgeData.set(e, {});
+  }
+
+  //! Collects the neighbors of N in the file graph, sorted by destination
+  std::vector<std::pair<GraphNode, uint64_t>>& sortedNeighbors(FileGraph& graph,
+                                                               GraphNode N) {
+    auto& nbrs = *scratch.getLocal();
+    nbrs.clear();
+    for (auto nn : graph.edges(N))
+      nbrs.emplace_back(graph.getEdgeDst(nn), *nn);
+    std::stable_sort(nbrs.begin(), nbrs.end(),
+                     [](const std::pair<GraphNode, uint64_t>& a,
+                        const std::pair<GraphNode, uint64_t>& b) {
+                       return a.first < b.first;
+                     });
+    return nbrs;
+  }
+
+  //! Number of bytes needed to encode the (sorted) neighbors of N
+  static uint64_t
+  encodedSize(GraphNode N,
+              const std::vector<std::pair<GraphNode, uint64_t>>& nbrs) {
+    if (nbrs.empty())
+      return 0;
+    uint64_t bytes = numSkips(nbrs.size()) * sizeof(SkipEntry);
+    bytes += varintSize(zigzagEncode(int64_t(nbrs[0].first) - int64_t(N)));
+    for (size_t i = 1; i < nbrs.size(); ++i)
+      bytes += varintSize(nbrs[i].first - nbrs[i - 1].first);
+    return bytes;
+  }
+
+  void allocateArrays() {
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      edgeIndData.allocateBlocked(numNodes);
+      byteIndData.allocateBlocked(numNodes);
+      edgeData.allocateBlocked(numEdges);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      byteIndData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
+  void allocateBytes(uint64_t numBytes) {
+    if (UseNumaAlloc)
+      edgeBytes.allocateBlocked(numBytes);
+    else
+      edgeBytes.allocateInterleaved(numBytes);
+  }
+
+  template <typename T>
+  static void readArray(std::ifstream& in, T* data, uint64_t count,
+                        const std::string& filename) {
+    if (count && !in.read(reinterpret_cast<char*>(data), count * sizeof(T)))
+      GALOIS_DIE("failed reading ", "'", filename, "'");
+  }
+
+  template <typename T>
+  static void writeArray(std::ofstream& out, const T* data, uint64_t count,
+                         const std::string& filename) {
+    if (count &&
+        !out.write(reinterpret_cast<const char*>(data), count * sizeof(T)))
+      GALOIS_DIE("failed writing to ", "'", filename, "'");
+  }
+
+public:
+  LC_Compressed_Graph() : numNodes(0), numEdges(0) {}
+
+  node_data_reference getData(GraphNode N,
+                              MethodFlag mflag = MethodFlag::WRITE) {
+    NodeInfo& NI = nodeData[N];
+    acquireNode(N, mflag);
+    return NI.getData();
+  }
+
+  edge_data_reference getEdgeData(edge_iterator ni,
+                                  MethodFlag mflag = MethodFlag::UNPROTECTED) {
+    return edgeData[*ni];
+  }
+
+  GraphNode getEdgeDst(edge_iterator ni) const { return ni.cursor.dst; }
+
+  size_t size() const { return numNodes; }
+  size_t sizeEdges() const { return numEdges; }
+  //! Number of bytes used by the compressed adjacency lists
+  size_t sizeEdgeBytes() const {
+    return numNodes ? byteIndData[numNodes - 1] : 0;
+  }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const {
+    return const_local_iterator(this->localBegin(numNodes));
+  }
+
+  const_local_iterator local_end() const {
+    return const_local_iterator(this->localEnd(numNodes));
+  }
+
+  local_iterator local_begin() {
+    return local_iterator(this->localBegin(numNodes));
+  }
+
+  local_iterator local_end() {
+    return local_iterator(this->localEnd(numNodes));
+  }
+
+  //! Out degree of N; constant time unlike std::distance over edges
+  uint64_t getDegree(GraphNode N) const {
+    return edgeIndData[N] - edgeIndBegin(N);
+  }
+
+  edge_iterator edge_begin(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    if (!HasNoLockable && galois::runtime::shouldLock(mflag)) {
+      for (edge_iterator ii = raw_begin(N), ee = raw_end(N); ii != ee; ++ii) {
+        acquireNode(ii.cursor.dst, mflag);
+      }
+    }
+    return raw_begin(N);
+  }
+
+  edge_iterator edge_end(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(N, mflag);
+    return raw_end(N);
+  }
+
+  edge_iterator findEdge(GraphNode N1, GraphNode N2) {
+    return findEdgeSortedByDst(N1, N2);
+  }
+
+  /**
+   * Finds the edge N1 -> N2. Uses the skip index to jump to the block that
+   * may contain N2 and decodes at most skipInterval edges.
+   */
+  edge_iterator findEdgeSortedByDst(GraphNode N1, GraphNode N2) {
+    edge_iterator ei = edge_end(N1);
+    EdgeCursor c     = edge_begin(N1).cursor;
+    if (c.at == c.last || c.dst > N2)
+      return ei;
+
+    // binary search for the number of skip entries not past N2
+    uint64_t lo = 0, hi = numSkips(c.last - c.first);
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      c.jumpToBlock(mid + 1);
+      if (c.dst <= N2)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo)
+      c.jumpToBlock(lo);
+    else
+      c.restart();
+
+    for (; c.at != c.last && c.dst < N2; c.increment())
+      ;
+    return (c.at != c.last && c.dst == N2) ? edge_iterator(c) : ei;
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return internal::make_no_deref_range(edge_begin(N, mflag),
+                                         edge_end(N, mflag));
+  }
+
+  runtime::iterable<NoDerefIterator<edge_iterator>>
+  out_edges(GraphNode N, MethodFlag mflag = MethodFlag::WRITE) {
+    return edges(N, mflag);
+  }
+
+  //! Neighbors are always stored sorted by destination; provided for
+  //! interface compatibility with LC_CSR_Graph
+  void sortEdgesByDst(GraphNode, MethodFlag = MethodFlag::WRITE) {}
+
+  //! Neighbors are always stored sorted by destination; provided for
+  //! interface compatibility with LC_CSR_Graph
+  void sortAllEdgesByDst(MethodFlag = MethodFlag::WRITE) {}
+
+  /**
+   * Computes the encoded size of every adjacency list and allocates
+   * storage. Must not be called during parallel execution.
+   */
+  void allocateFrom(FileGraph& graph, const ReadGraphAuxData&) {
+    numNodes = graph.size();
+    numEdges = graph.sizeEdges();
+    allocateArrays();
+
+    galois::do_all(galois::iterate(UINT64_C(0), numNodes),
+                   [&](uint64_t n) {
+                     edgeIndData[n] = *graph.edge_end(n);
+                     byteIndData[n] = encodedSize(n, sortedNeighbors(graph, n));
+                   },
+                   galois::no_stats(), galois::steal(),
+                   galois::loopname("COMPRESSED_GRAPH_SIZES"));
+
+    for (uint64_t n = 1; n < numNodes; ++n) {
+      byteIndData[n] += byteIndData[n - 1];
+    }
+
+    allocateBytes(sizeEdgeBytes());
+  }
+
+  void constructNodesFrom(FileGraph& graph, unsigned tid, unsigned total,
+                          const ReadGraphAuxData&) {
+    auto r = graph
+                 .divideByNode(
+                     NodeData::size_of::value + 2 * EdgeIndData::size_of::value +
+                         LC_Compressed_Graph::size_of_out_of_line::value,
+                     EdgeData::size_of::value + 1, tid, total)
+                 .first;
+
+    this->setLocalRange(*r.first, *r.second);
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      nodeData.constructAt(*ii);
+      this->outOfLineConstructAt(*ii);
+    }
+  }
+
+  void constructEdgesFrom(FileGraph& graph, unsigned tid, unsigned total,
+                          const ReadGraphAuxData&) {
+    auto r = graph
+                 .divideByNode(
+                     NodeData::size_of::value + 2 * EdgeIndData::size_of::value +
+                         LC_Compressed_Graph::size_of_out_of_line::value,
+                     EdgeData::size_of::value + 1, tid, total)
+                 .first;
+
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      GraphNode src = *ii;
+      auto& nbrs    = sortedNeighbors(graph, src);
+      if (nbrs.empty())
+        continue;
+
+      uint64_t e     = edgeIndBegin(src);
+      uint8_t* skips = edgeBytes.data() + byteIndBegin(src);
+      uint8_t* base  = skips + numSkips(nbrs.size()) * sizeof(SkipEntry);
+      uint8_t* out   = encodeVarint(
+          base, zigzagEncode(int64_t(nbrs[0].first) - int64_t(src)));
+      constructEdgeValue(graph, e++, nbrs[0].second);
+
+      for (size_t i = 1; i < nbrs.size(); ++i) {
+        out = encodeVarint(out, nbrs[i].first - nbrs[i - 1].first);
+        constructEdgeValue(graph, e++, nbrs[i].second);
+        if (i % skipInterval == 0) {
+          SkipEntry entry{nbrs[i].first, static_cast<uint32_t>(out - base)};
+          std::memcpy(skips, &entry, sizeof(SkipEntry));
+          skips += sizeof(SkipEntry);
+        }
+      }
+      assert(out == edgeBytes.data() + byteIndData[src]);
+    }
+  }
+
+  /**
+   * Builds the graph from an in-memory file graph.
+   */
+  void createFrom(FileGraph& graph) {
+    ReadGraphAuxData aux;
+    allocateFrom(graph, aux);
+    galois::on_each([&](unsigned tid, unsigned total) {
+      constructNodesFrom(graph, tid, total, aux);
+    });
+    galois::on_each([&](unsigned tid, unsigned total) {
+      constructEdgesFrom(graph, tid, total, aux);
+    });
+  }
+
+  /**
+   * Builds the graph from a file: either a compressed graph written by
+   * toFile() or a regular .gr file, which is compressed while loading.
+   */
+  void createFrom(const std::string& filename) {
+    uint64_t magic = 0;
+    {
+      std::ifstream in(filename, std::ios::binary);
+      if (!in)
+        GALOIS_DIE("failed opening ", "'", filename, "'");
+      in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    }
+
+    if (magic == fileMagic) {
+      fromFile(filename);
+    } else {
+      FileGraph f;
+      f.fromFileInterleaved<FileEdgeTy>(filename);
+      createFrom(f);
+    }
+  }
+
+  /**
+   * Loads a compressed graph written by toFile().
+   */
+  void fromFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+      GALOIS_DIE("failed opening ", "'", filename, "'");
+
+    uint64_t header[5];
+    readArray(in, header, 5, filename);
+    if (header[0] != fileMagic)
+      GALOIS_DIE("'", filename, "' is not a compressed graph");
+    if (header[1] != EdgeData::size_of::value)
+      GALOIS_DIE("edge data size mismatch in '", filename, "': ", header[1],
+                 " != ", EdgeData::size_of::value);
+
+    numNodes = header[2];
+    numEdges = header[3];
+    allocateArrays();
+    allocateBytes(header[4]);
+
+    readArray(in, edgeIndData.data(), numNodes, filename);
+    readArray(in, byteIndData.data(), numNodes, filename);
+    readArray(in, edgeBytes.data(), header[4], filename);
+    if (EdgeData::has_value)
+      readArray(in, edgeData.data(), numEdges, filename);
+
+    galois::on_each([&](unsigned tid, unsigned total) {
+      auto r = divideNodesBinarySearch(
+                   numNodes, numEdges,
+                   NodeData::size_of::value + 2 * EdgeIndData::size_of::value,
+                   EdgeData::size_of::value + 1, tid, total, edgeIndData)
+                   .first;
+      this->setLocalRange(*r.first, *r.second);
+      for (auto n = *r.first; n < *r.second; ++n) {
+        nodeData.constructAt(n);
+        this->outOfLineConstructAt(n);
+      }
+    });
+  }
+
+  /**
+   * Writes the compressed graph (structure and edge data, but not node data)
+   * to a file that can be read back with readGraph() or fromFile().
+   */
+  void toFile(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out)
+      GALOIS_DIE("failed opening ", "'", filename, "'");
+
+    uint64_t header[5] = {fileMagic, EdgeData::size_of::value, numNodes,
+                          numEdges, sizeEdgeBytes()};
+    writeArray(out, header, 5, filename);
+    writeArray(out, edgeIndData.data(), numNodes, filename);
+    writeArray(out, byteIndData.data(), numNodes, filename);
+    writeArray(out, edgeBytes.data(), sizeEdgeBytes(), filename);
+    if (EdgeData::has_value)
+      writeArray(out, edgeData.data(), numEdges, filename);
+  }
+
+  /**
+   * Returns the reference to the edgeIndData LargeArray
+   * (a prefix sum of edges)
+   *
+   * @returns reference to LargeArray edgeIndData
+   */
+  const EdgeIndData& getEdgePrefixSum() const { return edgeIndData; }
+};
+
+template <typename GraphTy, typename... Args>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag,
+                       Args&&... args) {
+  graph.createFrom(std::forward<Args>(args)...);
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file PartitionFile.h
+ *
+ * Binary k-way partition of a graph, as written by the multilevel
+ * partitioners and read by partitioning policies that take a precomputed
+ * partition. The file is one uint32_t per node, in node order and native
+ * byte order, holding the part of the node; there is no header, so the file
+ * size gives the number of nodes it was written for, and a reader can fetch
+ * the parts of any contiguous range of nodes with a single read.
+ */
+
+#ifndef GALOIS_GRAPHS_PARTITIONFILE_H
+#define GALOIS_GRAPHS_PARTITIONFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+/**
+ * Writes parts[0, numNodes) to filename. Blocks of the file are written by
+ * all active threads in parallel into a temporary file next to filename,
+ * which is then renamed into place.
+ */
+void writePartitionFile(const std::string& filename, const uint32_t* parts,
+                        uint64_t numNodes);
+
+/**
+ * Reads the parts of nodes [begin, end) from filename. Dies if the file
+ * was not written for a graph of numNodes nodes or if a part is not less
+ * than numParts.
+ */
+std::vector<uint32_t> readPartitionFile(const std::string& filename,
+                                        uint64_t numNodes, uint32_t numParts,
+                                        uint64_t begin, uint64_t end);
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,524 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file Reorder.h
+ *
+ * Vertex reordering (relabeling) for locality. Each ordering computes a
+ * permutation P with P[i] = j, where i is a node of the original graph and j
+ * its id in the reordered graph (the convention of graphs::permute), and
+ * relabel() rewrites a FileGraph or an LC_CSR_Graph with it in parallel.
+ *
+ * Orderings work on any graph with size(), edge_begin(n), edge_end(n) and
+ * getEdgeDst(ii), i.e., both FileGraph and the LC graphs.
+ */
+
+#ifndef GALOIS_GRAPHS_REORDER_H
+#define GALOIS_GRAPHS_REORDER_H
+
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/ParallelSTL.h"
+#include "galois/graphs/FileGraph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+namespace internal {
+
+template <typename GraphTy>
+uint64_t reorderDegree(GraphTy& graph, uint32_t n) {
+  return std::distance(graph.edge_begin(n), graph.edge_end(n));
+}
+
+//! Out-degrees of all nodes, computed in parallel
+template <typename GraphTy>
+void reorderDegrees(GraphTy& graph, LargeArray<uint64_t>& degrees) {
+  degrees.create(graph.size());
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(graph.size())),
+                 [&](uint64_t n) { degrees[n] = reorderDegree(graph, n); },
+                 galois::no_stats(), galois::loopname("Reorder-Degrees"));
+}
+
+//! Turn a list of nodes in their new order into a permutation
+template <typename PTy>
+void orderToPermutation(const LargeArray<uint32_t>& order, PTy& perm) {
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(order.size())),
+                 [&](uint64_t i) { perm[order[i]] = i; }, galois::no_stats(),
+                 galois::loopname("Reorder-Invert"));
+}
+
+/**
+ * Max priority queue over node ids whose keys only change by +1/-1 (the
+ * unit heap of Gorder). Nodes with the same key are kept in a doubly linked
+ * list, so every operation is O(1) amortized.
+ */
+class UnitHeap {
+  constexpr static uint32_t none = ~0u;
+
+  std::vector<uint32_t> key;
+  std::vector<uint32_t> prev;
+  std::vector<uint32_t> next;
+  std::vector<uint32_t> head;
+  std::vector<bool> removed;
+  uint32_t top;
+
+  void unlink(uint32_t n) {
+    if (prev[n] != none)
+      next[prev[n]] = next[n];
+    else
+      head[key[n]] = next[n];
+    if (next[n] != none)
+      prev[next[n]] = prev[n];
+  }
+
+  void pushFront(uint32_t n) {
+    if (head.size() <= key[n])
+      head.resize(key[n] + 1, none);
+    prev[n] = none;
+    next[n] = head[key[n]];
+    if (next[n] != none)
+      prev[next[n]] = n;
+    head[key[n]] = n;
+  }
+
+public:
+  //! All nodes start with key 0; the node pushed last is popped first
+  template <typename Iter>
+  UnitHeap(size_t size, Iter b, Iter e)
+      : key(size, 0), prev(size, none), next(size, none), head(1, none),
+        removed(size, false), top(0) {
+    for (; b != e; ++b)
+      pushFront(*b);
+  }
+
+  void increment(uint32_t n) {
+    if (removed[n])
+      return;
+    unlink(n);
+    ++key[n];
+    pushFront(n);
+    top = std::max(top, key[n]);
+  }
+
+  void decrement(uint32_t n) {
+    if (removed[n] || key[n] == 0)
+      return;
+    unlink(n);
+    --key[n];
+    pushFront(n);
+  }
+
+  void remove(uint32_t n) {
+    if (removed[n])
+      return;
+    unlink(n);
+    removed[n] = true;
+  }
+
+  //! Pops a node with the largest key; heap must not be empty
+  uint32_t pop() {
+    while (head[top] == none) {
+      assert(top > 0);
+      --top;
+    }
+    uint32_t n = head[top];
+    remove(n);
+    return n;
+  }
+};
+
+//! Constructs edge e of out from edge ii of in; graphs without edge data
+//! only get the destination
+template <typename GraphTy>
+void relabelEdge(GraphTy&, typename GraphTy::edge_iterator, GraphTy& out,
+                 uint64_t e, uint32_t dst, std::true_type) {
+  out.constructEdge(e, dst);
+}
+
+template <typename GraphTy>
+void relabelEdge(GraphTy& in, typename GraphTy::edge_iterator ii,
+                 GraphTy& out, uint64_t e, uint32_t dst, std::false_type) {
+  out.constructEdge(e, dst, in.getEdgeData(ii));
+}
+
+} // namespace internal
+
+/**
+ * Sort nodes by out-degree (highest first by default). Ties keep their
+ * original relative order.
+ *
+ * @param graph graph to reorder
+ * @param perm output permutation with room for graph.size() entries
+ * @param descending put high degree nodes first
+ */
+template <typename GraphTy, typename PTy>
+void degreeSortPermutation(GraphTy& graph, PTy& perm, bool descending = true) {
+  LargeArray<uint64_t> degrees;
+  internal::reorderDegrees(graph, degrees);
+
+  LargeArray<uint32_t> order;
+  order.create(graph.size());
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(graph.size())),
+                 [&](uint64_t n) { order[n] = n; }, galois::no_stats());
+
+  galois::ParallelSTL::sort(order.begin(), order.end(),
+                            [&](uint32_t a, uint32_t b) {
+                              if (degrees[a] != degrees[b])
+                                return descending ? degrees[a] > degrees[b]
+                                                  : degrees[a] < degrees[b];
+                              return a < b;
+                            });
+
+  internal::orderToPermutation(order, perm);
+}
+
+/**
+ * Hub clustering: nodes with more than the average out-degree are moved,
+ * in their original relative order, in front of all other nodes. This
+ * packs the frequently accessed hubs together while preserving most of the
+ * existing order.
+ *
+ * @param graph graph to reorder
+ * @param perm output permutation with room for graph.size() entries
+ */
+template <typename GraphTy, typename PTy>
+void hubClusterPermutation(GraphTy& graph, PTy& perm) {
+  size_t numNodes = graph.size();
+  if (numNodes == 0)
+    return;
+  double avgDegree = double(graph.sizeEdges()) / numNodes;
+
+  // count hubs per block, then assign ids to both classes block by block
+  const size_t blockSize = 4096;
+  size_t numBlocks       = (numNodes + blockSize - 1) / blockSize;
+  std::vector<size_t> hubsBefore(numBlocks + 1, 0);
+
+  galois::do_all(galois::iterate(size_t(0), numBlocks),
+                 [&](size_t b) {
+                   size_t count = 0;
+                   size_t end   = std::min(numNodes, (b + 1) * blockSize);
+                   for (size_t n = b * blockSize; n < end; ++n)
+                     if (internal::reorderDegree(graph, n) > avgDegree)
+                       ++count;
+                   hubsBefore[b + 1] = count;
+                 },
+                 galois::no_stats(), galois::loopname("Reorder-HubCount"));
+
+  for (size_t b = 1; b <= numBlocks; ++b)
+    hubsBefore[b] += hubsBefore[b - 1];
+  size_t numHubs = hubsBefore[numBlocks];
+
+  galois::do_all(galois::iterate(size_t(0), numBlocks),
+                 [&](size_t b) {
+                   size_t hub    = hubsBefore[b];
+                   size_t nonHub = numHubs + b * blockSize - hubsBefore[b];
+                   size_t end    = std::min(numNodes, (b + 1) * blockSize);
+                   for (size_t n = b * blockSize; n < end; ++n) {
+                     if (internal::reorderDegree(graph, n) > avgDegree)
+                       perm[n] = hub++;
+                     else
+                       perm[n] = nonHub++;
+                   }
+                 },
+                 galois::no_stats(), galois::loopname("Reorder-HubAssign"));
+}
+
+/**
+ * Reverse Cuthill-McKee: BFS from a minimum degree node of each component,
+ * visiting neighbors in increasing degree order, then reverse the order.
+ * Reduces the bandwidth of the adjacency matrix. Meant for symmetric graphs;
+ * for directed graphs only out-edges are followed.
+ *
+ * Degrees and the component start order are computed in parallel; the
+ * traversal itself is serial.
+ *
+ * @param graph graph to reorder
+ * @param perm output permutation with room for graph.size() entries
+ */
+template <typename GraphTy, typename PTy>
+void rcmPermutation(GraphTy& graph, PTy& perm) {
+  size_t numNodes = graph.size();
+  LargeArray<uint64_t> degrees;
+  internal::reorderDegrees(graph, degrees);
+
+  // candidate start nodes in increasing degree order
+  LargeArray<uint32_t> starts;
+  starts.create(numNodes);
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t n) { starts[n] = n; }, galois::no_stats());
+  galois::ParallelSTL::sort(starts.begin(), starts.end(),
+                            [&](uint32_t a, uint32_t b) {
+                              if (degrees[a] != degrees[b])
+                                return degrees[a] < degrees[b];
+                              return a < b;
+                            });
+
+  LargeArray<uint32_t> order;
+  order.create(numNodes);
+  std::vector<bool> visited(numNodes, false);
+  size_t tail = 0;
+
+  for (auto start : starts) {
+    if (visited[start])
+      continue;
+    visited[start] = true;
+    size_t headIdx = tail;
+    order[tail++]  = start;
+
+    // order itself is the BFS queue
+    while (headIdx < tail) {
+      uint32_t src = order[headIdx++];
+      size_t first = tail;
+      for (auto ii = graph.edge_begin(src), ei = graph.edge_end(src); ii != ei;
+           ++ii) {
+        uint32_t dst = graph.getEdgeDst(ii);
+        if (!visited[dst]) {
+          visited[dst]  = true;
+          order[tail++] = dst;
+        }
+      }
+      std::sort(order.begin() + first, order.begin() + tail,
+                [&](uint32_t a, uint32_t b) {
+                  if (degrees[a] != degrees[b])
+                    return degrees[a] < degrees[b];
+                  return a < b;
+                });
+    }
+  }
+  assert(tail == numNodes);
+
+  std::reverse(order.begin(), order.end());
+  internal::orderToPermutation(order, perm);
+}
+
+/**
+ * Windowed locality ordering in the style of Gorder (Wei et al., SIGMOD'16).
+ * Nodes are placed greedily: the next node is the one with the highest score
+ * against the last window placed nodes, where the score of u against v is
+ * the number of edges between them plus the number of common in-neighbors.
+ * In-neighbors with more than sqrt(|V|) out-edges are ignored for the common
+ * neighbor term, as in Gorder.
+ *
+ * The transpose is built in parallel; the greedy placement is serial and
+ * costs O(sum over nodes of in-degree * out-degree of in-neighbors).
+ *
+ * @param graph graph to reorder
+ * @param perm output permutation with room for graph.size() entries
+ * @param window number of recently placed nodes that contribute to scores
+ */
+template <typename GraphTy, typename PTy>
+void gorderPermutation(GraphTy& graph, PTy& perm, unsigned window = 5) {
+  size_t numNodes = graph.size();
+  if (numNodes == 0)
+    return;
+
+  LargeArray<uint64_t> degrees;
+  internal::reorderDegrees(graph, degrees);
+
+  // transpose: in-edge prefix sum and sources
+  std::vector<std::atomic<uint64_t>> inCount(numNodes);
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t n) { inCount[n] = 0; }, galois::no_stats());
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t src) {
+                   for (auto ii = graph.edge_begin(src),
+                             ei = graph.edge_end(src);
+                        ii != ei; ++ii)
+                     inCount[graph.getEdgeDst(ii)] += 1;
+                 },
+                 galois::steal(), galois::no_stats(),
+                 galois::loopname("Reorder-InDegrees"));
+
+  std::vector<uint64_t> inIndex(numNodes + 1, 0);
+  for (size_t n = 0; n < numNodes; ++n)
+    inIndex[n + 1] = inIndex[n] + inCount[n];
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t n) { inCount[n] = inIndex[n]; },
+                 galois::no_stats());
+
+  std::vector<uint32_t> inSrc(inIndex[numNodes]);
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t src) {
+                   for (auto ii = graph.edge_begin(src),
+                             ei = graph.edge_end(src);
+                        ii != ei; ++ii)
+                     inSrc[inCount[graph.getEdgeDst(ii)]++] = src;
+                 },
+                 galois::steal(), galois::no_stats(),
+                 galois::loopname("Reorder-InEdges"));
+
+  // ties (and the start of each new region) go to high in-degree nodes
+  LargeArray<uint32_t> order;
+  order.create(numNodes);
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t n) { order[n] = n; }, galois::no_stats());
+  galois::ParallelSTL::sort(order.begin(), order.end(),
+                            [&](uint32_t a, uint32_t b) {
+                              uint64_t da = inIndex[a + 1] - inIndex[a];
+                              uint64_t db = inIndex[b + 1] - inIndex[b];
+                              if (da != db)
+                                return da < db;
+                              return a > b;
+                            });
+  internal::UnitHeap heap(numNodes, order.begin(), order.end());
+
+  const uint64_t hugeDegree = std::sqrt(double(numNodes));
+
+  auto update = [&](uint32_t v, bool add) {
+    auto touch = [&](uint32_t u) {
+      if (add)
+        heap.increment(u);
+      else
+        heap.decrement(u);
+    };
+    for (auto ii = graph.edge_begin(v), ei = graph.edge_end(v); ii != ei; ++ii)
+      touch(graph.getEdgeDst(ii));
+    for (uint64_t i = inIndex[v]; i < inIndex[v + 1]; ++i) {
+      uint32_t parent = inSrc[i];
+      touch(parent);
+      if (degrees[parent] > hugeDegree)
+        continue;
+      for (auto ii = graph.edge_begin(parent), ei = graph.edge_end(parent);
+           ii != ei; ++ii)
+        touch(graph.getEdgeDst(ii));
+    }
+  };
+
+  for (size_t i = 0; i < numNodes; ++i) {
+    uint32_t v = heap.pop();
+    order[i]   = v;
+    update(v, true);
+    if (i >= window)
+      update(order[i - window], false);
+  }
+
+  internal::orderToPermutation(order, perm);
+}
+
+/**
+ * Relabel a FileGraph in parallel. Same result as graphs::permute: each
+ * node keeps the order of its edges.
+ *
+ * @param in original graph
+ * @param p permutation with p[i] = new id of node i
+ * @param out relabeled graph; the previous out is destroyed
+ */
+template <typename EdgeTy, typename PTy>
+void relabel(FileGraph& in, const PTy& p, FileGraph& out) {
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  FileGraphWriter g;
+  EdgeData edgeData;
+
+  size_t numNodes = in.size();
+  size_t numEdges = in.sizeEdges();
+  g.setNumNodes(numNodes);
+  g.setNumEdges(numEdges);
+  g.setSizeofEdgeData(EdgeData::has_value ? sizeof(edge_value_type) : 0);
+
+  // each new node is written by exactly one old node, so no races
+  g.phase1();
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t src) {
+                   g.incrementDegree(p[src], internal::reorderDegree(in, src));
+                 },
+                 galois::no_stats(), galois::loopname("Relabel-Degrees"));
+
+  g.phase2();
+  edgeData.create(numEdges);
+  galois::do_all(
+      galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+      [&](uint64_t src) {
+        for (auto jj = in.edge_begin(src), ej = in.edge_end(src); jj != ej;
+             ++jj) {
+          auto dst = in.getEdgeDst(jj);
+          if (EdgeData::has_value) {
+            edgeData.set(g.addNeighbor(p[src], p[dst]),
+                         in.getEdgeData<edge_value_type>(jj));
+          } else {
+            g.addNeighbor(p[src], p[dst]);
+          }
+        }
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("Relabel-Edges"));
+
+  edge_value_type* rawEdgeData = g.finish<edge_value_type>();
+  if (EdgeData::has_value)
+    std::uninitialized_copy(std::make_move_iterator(edgeData.begin()),
+                            std::make_move_iterator(edgeData.end()),
+                            rawEdgeData);
+
+  out = std::move(g);
+}
+
+/**
+ * Relabel an LC_CSR_Graph (or any graph with the same construction
+ * interface: allocateFrom, constructNodes, fixEndEdge, constructEdge) in
+ * parallel. Edge data is copied; node data is default constructed.
+ *
+ * @param in original graph
+ * @param p permutation with p[i] = new id of node i
+ * @param out relabeled graph; must be empty
+ */
+template <typename GraphTy, typename PTy>
+void relabel(GraphTy& in, const PTy& p, GraphTy& out) {
+  uint32_t numNodes = in.size();
+  uint64_t numEdges = in.sizeEdges();
+
+  out.allocateFrom(numNodes, numEdges);
+  out.constructNodes();
+
+  // newEnd[j] = end of the edges of new node j
+  LargeArray<uint64_t> newEnd;
+  newEnd.create(numNodes);
+  galois::do_all(galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+                 [&](uint64_t src) {
+                   newEnd[p[src]] = internal::reorderDegree(in, src);
+                 },
+                 galois::no_stats(), galois::loopname("Relabel-Degrees"));
+  for (uint32_t n = 1; n < numNodes; ++n)
+    newEnd[n] += newEnd[n - 1];
+
+  galois::do_all(
+      galois::iterate(UINT64_C(0), uint64_t(numNodes)),
+      [&](uint64_t src) {
+        uint32_t n = p[src];
+        uint64_t e = n ? newEnd[n - 1] : 0;
+        for (auto ii = in.edge_begin(src), ei = in.edge_end(src); ii != ei;
+             ++ii, ++e)
+          internal::relabelEdge(
+              in, ii, out, e, p[in.getEdgeDst(ii)],
+              std::is_void<typename GraphTy::edge_data_type>());
+        out.fixEndEdge(n, e);
+      },
+      galois::steal(), galois::no_stats(), galois::loopname("Relabel-Edges"));
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
@@ -0,0 +1,450 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file SpMV.h
+ *
+ * Graph kernels written as sparse matrix products over a semiring. A graph is
+ * read as a sparse matrix A whose row r holds the edges of node r, so for a
+ * transposed (pull) graph y = A x gathers x over the in-neighbors of every
+ * node, and for a push graph spmspv scatters a sparse x along out-edges.
+ *
+ * A semiring provides value_type, zero(), add(a, b) and multiply(w, x), where
+ * w is the data of an edge, or Pattern for graphs without edge data.
+ *
+ * CacheBlockedCSR is a copy of a pull graph split by source (column) into
+ * segments narrow enough that the part of x a segment reads stays in the last
+ * level cache. Each segment is multiplied in turn and adds into y, trading
+ * one sequential pass over y per segment for random reads of x that hit in
+ * cache instead of going to memory.
+ */
+
+#ifndef GALOIS_GRAPHS_SPMV_H
+#define GALOIS_GRAPHS_SPMV_H
+
+#include "galois/Bag.h"
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace galois {
+namespace graphs {
+
+//! Value of an edge in a graph without edge data
+struct Pattern {};
+
+//! Arithmetic (+, *) semiring
+template <typename T>
+struct PlusTimes {
+  typedef T value_type;
+  T zero() const { return T(0); }
+  T add(const T& a, const T& b) const { return a + b; }
+  template <typename W>
+  T multiply(const W& w, const T& x) const {
+    return w * x;
+  }
+  T multiply(Pattern, const T& x) const { return x; }
+};
+
+//! Tropical (min, +) semiring; a pattern edge has length 1
+template <typename T>
+struct MinPlus {
+  typedef T value_type;
+  T zero() const { return std::numeric_limits<T>::max(); }
+  T add(const T& a, const T& b) const { return std::min(a, b); }
+  template <typename W>
+  T multiply(const W& w, const T& x) const {
+    return x == zero() ? x : T(x + w);
+  }
+  T multiply(Pattern, const T& x) const { return x == zero() ? x : T(x + 1); }
+};
+
+//! Boolean (or, and) semiring: reachability
+struct LorLand {
+  typedef bool value_type;
+  bool zero() const { return false; }
+  bool add(bool a, bool b) const { return a || b; }
+  template <typename W>
+  bool multiply(const W&, bool x) const {
+    return x;
+  }
+};
+
+/**
+ * Size in bytes of the part of a dense vector that CacheBlockedCSR keeps
+ * cache resident: half of the last level cache, leaving the rest for the
+ * matrix and y streaming through.
+ */
+size_t defaultSegmentBytes();
+
+namespace internal {
+
+template <typename Graph>
+using EdgeValueOf =
+    typename std::conditional<std::is_void<typename Graph::edge_data_type>::value,
+                              Pattern,
+                              typename Graph::edge_data_type>::type;
+
+template <typename Graph, typename Value = EdgeValueOf<Graph>>
+typename std::enable_if<std::is_same<Value, Pattern>::value, Pattern>::type
+edgeValue(Graph&, typename Graph::edge_iterator) {
+  return Pattern();
+}
+
+template <typename Graph, typename Value = EdgeValueOf<Graph>>
+typename std::enable_if<!std::is_same<Value, Pattern>::value,
+                        const Value&>::type
+edgeValue(Graph& graph, typename Graph::edge_iterator e) {
+  return graph.getEdgeData(e);
+}
+
+//! Edge values of a CacheBlockedCSR; nothing is stored for pattern graphs
+template <typename Value>
+class EdgeValues {
+  LargeArray<Value> values;
+
+public:
+  void allocate(size_t n) { values.allocateInterleaved(n); }
+  void set(size_t i, const Value& v) { values.set(i, v); }
+  const Value& operator[](size_t i) const { return values[i]; }
+};
+
+template <>
+class EdgeValues<Pattern> {
+public:
+  void allocate(size_t) {}
+  void set(size_t, Pattern) {}
+  Pattern operator[](size_t) const { return Pattern(); }
+};
+
+} // namespace internal
+
+/**
+ * y[r] = sum over the edges (r, c) of A[r][c] * x[c], with sum and product
+ * taken from the semiring. x and y are indexed by node.
+ *
+ * @param graph pull graph
+ */
+template <typename Graph, typename XVec, typename YVec, typename Semiring>
+void spmv(Graph& graph, const XVec& x, YVec& y, const Semiring& sr) {
+  typedef typename Semiring::value_type T;
+  galois::do_all(
+      galois::iterate(graph),
+      [&](typename Graph::GraphNode r) {
+        T sum = sr.zero();
+        for (auto e : graph.edges(r, MethodFlag::UNPROTECTED)) {
+          sum = sr.add(sum, sr.multiply(internal::edgeValue(graph, e),
+                                        x[graph.getEdgeDst(e)]));
+        }
+        y[r] = sum;
+      },
+      galois::steal(), galois::chunk_size<64>(), galois::no_stats(),
+      galois::loopname("SpMV"));
+}
+
+/**
+ * A copy of a pull graph split into column segments. Segment s holds, for
+ * every row with at least one column in [s * width, (s + 1) * width), that
+ * row's columns in the range. Segments are stored one after another in flat
+ * arrays:
+ *
+ *   rows[i]    row of the i-th (segment, row) pair
+ *   rowEnd[i]  end of its columns in cols; it starts at rowEnd[i - 1]
+ *   cols[j]    column of the j-th entry, values[j] its edge value
+ *
+ * @tparam Value edge value type, Pattern for graphs without edge data
+ */
+template <typename Value = Pattern>
+class CacheBlockedCSR {
+  //! Rows per block when building; blocks are the unit of parallelism
+  static constexpr size_t BUILD_BLOCK = 1024;
+
+  uint64_t numRows;
+  uint64_t numEntries;
+  unsigned segmentShift;
+  uint32_t numSegments;
+  //! segmentRowBegin[s] is the index in rows of the first row of segment s
+  std::vector<uint64_t> segmentRowBegin;
+  LargeArray<uint32_t> rows;
+  LargeArray<uint64_t> rowEnd;
+  LargeArray<uint32_t> cols;
+  internal::EdgeValues<Value> values;
+
+  uint32_t segmentOf(uint32_t col) const { return col >> segmentShift; }
+
+  /**
+   * Counts the entries of row r in every segment into count and appends the
+   * segments that have any to touched.
+   */
+  template <typename Graph>
+  void countRow(Graph& graph, typename Graph::GraphNode r,
+                std::vector<uint64_t>& count,
+                std::vector<uint32_t>& touched) const {
+    for (auto e : graph.edges(r, MethodFlag::UNPROTECTED)) {
+      uint32_t s = segmentOf(graph.getEdgeDst(e));
+      if (count[s]++ == 0) {
+        touched.push_back(s);
+      }
+    }
+  }
+
+public:
+  CacheBlockedCSR() : numRows(0), numEntries(0), segmentShift(0),
+                      numSegments(0) {}
+
+  /**
+   * Copies graph, which must have at most 2^32 nodes.
+   *
+   * @param segmentWidth maximum number of columns per segment; rounded down
+   * to a power of two
+   */
+  template <typename Graph>
+  CacheBlockedCSR(Graph& graph, size_t segmentWidth) {
+    static_assert(std::is_same<Value, internal::EdgeValueOf<Graph>>::value,
+                  "edge value type must match the graph's edge data");
+    numRows    = graph.size();
+    numEntries = graph.sizeEdges();
+
+    segmentShift = 0;
+    while ((size_t(2) << segmentShift) <= std::max<size_t>(segmentWidth, 1) &&
+           segmentShift < 31) {
+      ++segmentShift;
+    }
+    numSegments =
+        numRows ? uint32_t(((numRows - 1) >> segmentShift) + 1) : 0;
+
+    const size_t numBlocks = (numRows + BUILD_BLOCK - 1) / BUILD_BLOCK;
+    // per (segment, block) counts, segment major so that a prefix sum gives
+    // the position of each block within each segment
+    std::vector<uint64_t> blockRows(numSegments * numBlocks + 1);
+    std::vector<uint64_t> blockEntries(numSegments * numBlocks + 1);
+
+    auto blockRange = [&](size_t b) {
+      return std::make_pair(b * BUILD_BLOCK,
+                            std::min<size_t>((b + 1) * BUILD_BLOCK, numRows));
+    };
+
+    galois::do_all(
+        galois::iterate(size_t(0), numBlocks),
+        [&](size_t b) {
+          std::vector<uint64_t> count(numSegments);
+          std::vector<uint32_t> touched;
+          auto range = blockRange(b);
+          for (size_t r = range.first; r < range.second; ++r) {
+            countRow(graph, r, count, touched);
+            for (uint32_t s : touched) {
+              blockRows[s * numBlocks + b] += 1;
+              blockEntries[s * numBlocks + b] += count[s];
+              count[s] = 0;
+            }
+            touched.clear();
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("CacheBlockedCSRCount"));
+
+    uint64_t rowSum   = 0;
+    uint64_t entrySum = 0;
+    for (size_t i = 0; i < blockRows.size(); ++i) {
+      uint64_t r      = blockRows[i];
+      uint64_t e      = blockEntries[i];
+      blockRows[i]    = rowSum;
+      blockEntries[i] = entrySum;
+      rowSum += r;
+      entrySum += e;
+    }
+
+    segmentRowBegin.resize(numSegments + 1);
+    for (uint32_t s = 0; s <= numSegments; ++s) {
+      segmentRowBegin[s] = blockRows[s * numBlocks];
+    }
+
+    rows.allocateInterleaved(rowSum);
+    rowEnd.allocateInterleaved(rowSum);
+    cols.allocateInterleaved(numEntries);
+    values.allocate(numEntries);
+
+    galois::do_all(
+        galois::iterate(size_t(0), numBlocks),
+        [&](size_t b) {
+          std::vector<uint64_t> count(numSegments);
+          std::vector<uint64_t> fill(numSegments);
+          std::vector<uint32_t> touched;
+          std::vector<uint64_t> rowPos(numSegments);
+          for (uint32_t s = 0; s < numSegments; ++s) {
+            rowPos[s] = blockRows[s * numBlocks + b];
+            fill[s]   = blockEntries[s * numBlocks + b];
+          }
+          auto range = blockRange(b);
+          for (size_t r = range.first; r < range.second; ++r) {
+            countRow(graph, r, count, touched);
+            for (uint32_t s : touched) {
+              rows[rowPos[s]]   = r;
+              rowEnd[rowPos[s]] = fill[s] + count[s];
+              ++rowPos[s];
+              count[s] = 0;
+            }
+            touched.clear();
+            for (auto e : graph.edges(r, MethodFlag::UNPROTECTED)) {
+              uint32_t c   = graph.getEdgeDst(e);
+              uint64_t pos = fill[segmentOf(c)]++;
+              cols[pos]    = c;
+              values.set(pos, internal::edgeValue(graph, e));
+            }
+          }
+        },
+        galois::steal(), galois::no_stats(),
+        galois::loopname("CacheBlockedCSRFill"));
+  }
+
+  size_t size() const { return numRows; }
+  size_t sizeEdges() const { return numEntries; }
+  uint32_t segments() const { return numSegments; }
+  size_t segmentWidth() const { return size_t(1) << segmentShift; }
+
+  /**
+   * y = A x over the semiring, as spmv but one column segment at a time.
+   * y must not alias x.
+   */
+  template <typename XVec, typename YVec, typename Semiring>
+  void multiply(const XVec& x, YVec& y, const Semiring& sr) const {
+    typedef typename Semiring::value_type T;
+    galois::do_all(
+        galois::iterate(uint64_t(0), numRows),
+        [&](uint64_t r) { y[r] = sr.zero(); }, galois::no_stats(),
+        galois::loopname("SpMVClear"));
+
+    for (uint32_t s = 0; s < numSegments; ++s) {
+      galois::do_all(
+          galois::iterate(segmentRowBegin[s], segmentRowBegin[s + 1]),
+          [&](uint64_t i) {
+            T sum = sr.zero();
+            for (uint64_t j = i ? rowEnd[i - 1] : 0; j < rowEnd[i]; ++j) {
+              sum = sr.add(sum, sr.multiply(values[j], x[cols[j]]));
+            }
+            uint32_t r = rows[i];
+            y[r]       = sr.add(y[r], sum);
+          },
+          galois::steal(), galois::chunk_size<64>(), galois::no_stats(),
+          galois::loopname("SpMVSegment"));
+    }
+  }
+};
+
+/**
+ * Sparse vector over a dense index space: a dense array of values, zero
+ * outside the nonzeros, together with the list of nonzero indices. Values
+ * can be accumulated concurrently.
+ */
+template <typename T>
+class SparseVector {
+  LargeArray<std::atomic<T>> values;
+  DynamicBitSet present;
+  InsertBag<uint32_t> nonzeros;
+  T zeroValue;
+
+public:
+  SparseVector() : zeroValue() {}
+
+  //! Allocates n entries, all equal to zero
+  void allocate(size_t n, const T& zero = T()) {
+    zeroValue = zero;
+    values.allocateInterleaved(n);
+    present.resize(n);
+    galois::do_all(galois::iterate(size_t(0), n),
+                   [&](size_t i) { values.constructAt(i, zeroValue); },
+                   galois::no_stats(), galois::loopname("SparseVectorInit"));
+  }
+
+  size_t size() const { return values.size(); }
+  bool empty() const { return nonzeros.empty(); }
+
+  //! Indices of the nonzeros, each listed once, in no particular order
+  InsertBag<uint32_t>& indices() { return nonzeros; }
+
+  T operator[](size_t i) const { return values[i].load(std::memory_order_relaxed); }
+
+  //! Sets entry i, which must be zero
+  void set(uint32_t i, const T& v) {
+    values[i].store(v, std::memory_order_relaxed);
+    if (!present.set(i)) {
+      nonzeros.push(i);
+    }
+  }
+
+  //! Entry i = sr.add(entry i, v)
+  template <typename Semiring>
+  void accumulate(uint32_t i, const T& v, const Semiring& sr) {
+    std::atomic<T>& slot = values[i];
+    T old                = slot.load(std::memory_order_relaxed);
+    while (!slot.compare_exchange_weak(old, sr.add(old, v),
+                                       std::memory_order_relaxed)) {
+    }
+    if (!present.test(i) && !present.set(i)) {
+      nonzeros.push(i);
+    }
+  }
+
+  //! Resets the nonzeros to zero, in time proportional to their number
+  void clear() {
+    galois::do_all(galois::iterate(nonzeros),
+                   [&](uint32_t i) {
+                     values[i].store(zeroValue, std::memory_order_relaxed);
+                     present.reset(i);
+                   },
+                   galois::no_stats(), galois::loopname("SparseVectorClear"));
+    nonzeros.clear();
+  }
+};
+
+/**
+ * y = A x for a sparse x: every nonzero x[c] is multiplied along the edges of
+ * c and accumulated into y[r] for each neighbor r. With a push graph this is
+ * one frontier step; y is not cleared first.
+ *
+ * @param graph push graph
+ */
+template <typename Graph, typename T, typename Semiring>
+void spmspv(Graph& graph, SparseVector<T>& x, SparseVector<T>& y,
+            const Semiring& sr) {
+  galois::do_all(
+      galois::iterate(x.indices()),
+      [&](uint32_t c) {
+        T xc = x[c];
+        for (auto e : graph.edges(c, MethodFlag::UNPROTECTED)) {
+          y.accumulate(graph.getEdgeDst(e),
+                       sr.multiply(internal::edgeValue(graph, e), xc), sr);
+        }
+      },
+      galois::steal(), galois::chunk_size<16>(), galois::no_stats(),
+      galois::loopname("SpMSpV"));
+}
+
+} // namespace graphs
+} // namespace galois
+
+#endif
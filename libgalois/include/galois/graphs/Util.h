@@ -22,9 +22,12 @@
 
 #include "galois/Galois.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/GraphFileReader.h"
 #include "galois/graphs/Details.h"
 #include "galois/Timer.h"
 
+#include <utility>
+
 namespace galois {
 namespace graphs {
 
@@ -39,9 +42,82 @@ void readGraph(GraphTy& graph, Args&&... args) {
   readGraphDispatch(graph, tag, std::forward<Args>(args)...);
 }
 
+template <typename GraphTy>
+struct ReadGraphConstructNodesFromFile {
+  GraphTy& graph;
+  GraphFileReader& reader;
+  ReadGraphConstructNodesFromFile(GraphTy& g, GraphFileReader& r)
+      : graph(g), reader(r) {}
+  void operator()(unsigned tid, unsigned total) {
+    graph.constructNodesFrom(reader, tid, total);
+  }
+};
+
+template <typename GraphTy>
+struct ReadGraphConstructEdgesFromFile {
+  GraphTy& graph;
+  GraphFileReader& reader;
+  ReadGraphConstructEdgesFromFile(GraphTy& g, GraphFileReader& r)
+      : graph(g), reader(r) {}
+  void operator()(unsigned tid, unsigned total) {
+    graph.constructEdgesFrom(reader, tid, total);
+  }
+};
+
+namespace internal {
+
+/**
+ * Streams a graph file straight into the graph when the graph supports it:
+ * every thread preads the part of the file that it constructs, so the file is
+ * read once, in parallel, into memory placed by the graph's allocation
+ * policy, and reading overlaps with construction on other threads.
+ *
+ * @returns false if the graph cannot be read this way
+ */
+template <typename GraphTy>
+auto readGraphFromFile(GraphTy& graph, const std::string& filename, int)
+    -> decltype(graph.constructEdgesFrom(std::declval<GraphFileReader&>(), 0u,
+                                         0u),
+                bool()) {
+  GraphFileReader reader(filename);
+  if (!graph.canConstructFrom(reader))
+    return false;
+
+  galois::Timer timer;
+  timer.start();
+
+  graph.allocateFrom(reader.size(), reader.sizeEdges());
+
+  ReadGraphConstructNodesFromFile<GraphTy> nodeReader(graph, reader);
+  galois::on_each(nodeReader);
+
+  ReadGraphConstructEdgesFromFile<GraphTy> edgeReader(graph, reader);
+  galois::on_each(edgeReader);
+
+  timer.stop();
+
+  uint64_t bytes = reader.getBytesRead();
+  runtime::reportStat_Single("ReadGraph", "BytesRead", bytes);
+  runtime::reportStat_Single("ReadGraph", "Time", timer.get());
+  if (timer.get_usec())
+    runtime::reportStat_Single("ReadGraph", "MBPerSec",
+                               bytes / timer.get_usec());
+  return true;
+}
+
+template <typename GraphTy>
+bool readGraphFromFile(GraphTy&, const std::string&, long) {
+  return false;
+}
+
+} // namespace internal
+
 template <typename GraphTy>
 void readGraphDispatch(GraphTy& graph, read_default_graph_tag tag,
                        const std::string& filename) {
+  if (internal::readGraphFromFile(graph, filename, 0))
+    return;
+
   FileGraph f;
   f.fromFileInterleaved<typename GraphTy::file_edge_data_type>(filename);
   readGraphDispatch(graph, tag, f);
@@ -156,6 +156,8 @@ public:
       !exists_by_supertype<no_conflicts_tag, ArgsTy>::value;
   static constexpr bool needsPia =
       exists_by_supertype<per_iter_alloc_tag, ArgsTy>::value;
+  static constexpr bool needsArena =
+      exists_by_supertype<per_iter_arena_tag, ArgsTy>::value;
   static constexpr bool needsBreak =
       exists_by_supertype<parallel_break_tag, ArgsTy>::value;
   static constexpr bool MORE_STATS =
@@ -316,6 +318,8 @@ protected:
     ThreadLocalData tld(origFunction, loopname);
     if (needsBreak)
       tld.facing.setBreakFlag(&broke);
+    if (needsArena)
+      tld.facing.useArenaAlloc();
     if (couldAbort)
       setThreadContext(&tld.ctx);
     if (needsPush && !couldAbort)
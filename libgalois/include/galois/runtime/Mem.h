@@ -28,6 +28,7 @@
 #include "galois/gIO.h"
 #include "galois/runtime/PagePool.h"
 
+#include <atomic>
 #include <memory>
 #include <boost/utility.hpp>
 #include <cstdlib>
@@ -587,6 +588,209 @@ public:
   }
 };
 
+//! Per-thread counters of NumaPageArena
+struct ArenaStats {
+  //! Minor page faults taken while mapping new pages
+  size_t pageFaults = 0;
+  //! Pages newly mapped for the arena
+  size_t newPages = 0;
+  //! Pages reused from the pool of this thread's socket
+  size_t socketPages = 0;
+  //! Pages released by this thread that belong to another socket
+  size_t crossSocketFrees = 0;
+};
+
+/**
+ * Source of whole pages for short-lived allocations. Pages are mapped with
+ * allocTransparentHugePages, so they are backed by huge pages even when
+ * none are reserved, and are faulted in by the thread that first takes them,
+ * so each page belongs to that thread's socket. While ArenaBumpHeaps are
+ * alive, released pages go to a small per-thread cache and beyond that to a
+ * pool per socket, so threads recycle pages without mapping new ones and
+ * never start using memory of another socket. A thread's cache is unmapped
+ * when the last heap of that thread dies, and the socket pools when the last
+ * heap dies.
+ */
+class NumaPageArena : public StaticSingleInstance<NumaPageArena> {
+  friend class StaticSingleInstance<NumaPageArena>;
+
+public:
+  //! Header at the start of every arena page
+  struct Page {
+    Page* next;
+    unsigned socket;
+  };
+
+  enum { AllocSize = SystemHeap::AllocSize };
+
+private:
+  struct ThreadCache {
+    Page* head   = nullptr;
+    unsigned num = 0;
+    int heaps    = 0; //!< live ArenaBumpHeaps of this thread
+    ArenaStats stats;
+  };
+
+  struct SocketPool {
+    substrate::SimpleLock lock;
+    //! Written under lock; read without it only to skip an empty pool
+    std::atomic<Page*> head{nullptr};
+  };
+
+  //! Pages kept per thread before they are shared with the socket
+  static const unsigned maxCached = 4;
+
+  substrate::PerThreadStorage<ThreadCache> caches;
+  substrate::PerSocketStorage<SocketPool> pools;
+  std::atomic<unsigned> liveHeaps{0};
+
+  NumaPageArena() = default;
+
+  Page* allocateFromPool(ThreadCache& cache);
+
+  //! Unmaps the pages of a list linked through Page::next
+  static void unmap(Page* list);
+
+public:
+  //! Returns a page whose header is initialized; the rest is uninitialized
+  Page* allocate() {
+    ThreadCache& cache = *caches.getLocal();
+    Page* p            = cache.head;
+    if (p) {
+      cache.head = p->next;
+      cache.num -= 1;
+      p->next = nullptr;
+      return p;
+    }
+    return allocateFromPool(cache);
+  }
+
+  //! Releases a list of pages linked through Page::next
+  void release(Page* list);
+
+  //! Registers a live ArenaBumpHeap of the calling thread
+  void attach() {
+    caches.getLocal()->heaps += 1;
+    liveHeaps += 1;
+  }
+
+  //! Unregisters a heap; unmaps cached pages once no heap uses them
+  void detach();
+
+  //! @returns true if any page was ever mapped for the arena
+  static bool used();
+
+  const ArenaStats& stats(unsigned tid) const {
+    return caches.getRemote(tid)->stats;
+  }
+};
+
+/**
+ * Bump allocation over pages of NumaPageArena. Individual deallocations are
+ * no-ops; clear() releases everything at once, e.g., at the end of an
+ * iteration or round. Allocations that do not fit in a page fall back to
+ * malloc and are freed by clear().
+ */
+class ArenaBumpHeap : private boost::noncopyable {
+  struct Block {
+    union {
+      Block* next;
+      double dummy; // for alignment
+    };
+  };
+
+  enum {
+    headerSize = (sizeof(NumaPageArena::Page) + sizeof(double) - 1) &
+                 ~(sizeof(double) - 1)
+  };
+
+  NumaPageArena::Page* head;
+  Block* fallbackHead;
+  size_t offset;
+
+public:
+  enum { AllocSize = 0 };
+
+  ArenaBumpHeap()
+      : head(nullptr), fallbackHead(nullptr),
+        offset(NumaPageArena::AllocSize) {
+    NumaPageArena::getInstance()->attach();
+  }
+
+  ~ArenaBumpHeap() {
+    clear();
+    NumaPageArena::getInstance()->detach();
+  }
+
+  void clear() {
+    if (head)
+      NumaPageArena::getInstance()->release(head);
+    head   = nullptr;
+    offset = NumaPageArena::AllocSize;
+    while (fallbackHead) {
+      Block* B     = fallbackHead;
+      fallbackHead = B->next;
+      free(B);
+    }
+  }
+
+  inline void* allocate(size_t size) {
+    // Increase to alignment
+    size_t alignedSize = (size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+    if (headerSize + alignedSize > NumaPageArena::AllocSize) {
+      Block* B = static_cast<Block*>(malloc(alignedSize + sizeof(Block)));
+      if (!B)
+        throw std::bad_alloc();
+      B->next      = fallbackHead;
+      fallbackHead = B;
+      return reinterpret_cast<char*>(B) + sizeof(Block);
+    }
+    if (offset + alignedSize > NumaPageArena::AllocSize) {
+      NumaPageArena::Page* P = NumaPageArena::getInstance()->allocate();
+      P->next                = head;
+      head                   = P;
+      offset                 = headerSize;
+    }
+    char* retval = reinterpret_cast<char*>(head) + offset;
+    offset += alignedSize;
+    return retval;
+  }
+
+  inline void deallocate(void*) {}
+};
+
+/**
+ * Heap behind the per-iteration allocator. By default, a BumpWithMallocHeap
+ * over a FreeListHeap that keeps its pages until it is destroyed. Loops with
+ * the per_iter_arena trait switch it to an ArenaBumpHeap instead.
+ */
+class IterAllocHeap : private boost::noncopyable {
+  BumpWithMallocHeap<FreeListHeap<SystemHeap>> bump;
+  std::unique_ptr<ArenaBumpHeap> arena;
+
+public:
+  enum { AllocSize = 0 };
+
+  //! Allocates from NumaPageArena pages; call before any allocation
+  void useArena() {
+    if (!arena)
+      arena.reset(new ArenaBumpHeap());
+  }
+
+  void clear() {
+    if (arena)
+      arena->clear();
+    else
+      bump.clear();
+  }
+
+  inline void* allocate(size_t size) {
+    return arena ? arena->allocate(size) : bump.allocate(size);
+  }
+
+  inline void deallocate(void*) {}
+};
+
 #ifdef GALOIS_FORCE_STANDALONE
 class SizedHeapFactory : private boost::noncopyable {
 public:
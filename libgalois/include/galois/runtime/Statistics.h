@@ -745,7 +745,8 @@ void setStatFile(const std::string& f);
 void reportRUsage(const std::string& id);
 
 // TODO: switch to gstl::Str in here
-//! Reports Galois system memory stats for all threads
+//! Reports Galois system memory stats (page pool and NumaPageArena) for all
+//! threads
 void reportPageAlloc(const char* category);
 //! Reports NUMA memory stats for all NUMA nodes
 void reportNumaAlloc(const char* category);
@@ -34,6 +34,7 @@ public:
   typedef typename SuperTy::FastPushBack FastPushBack;
 
   void resetAlloc() { SuperTy::__resetAlloc(); }
+  void useArenaAlloc() { SuperTy::__useArenaAlloc(); }
   PushBufferTy& getPushBuffer() { return SuperTy::__getPushBuffer(); }
   void resetPushBuffer() { SuperTy::__resetPushBuffer(); }
   SuperTy& data() { return *static_cast<SuperTy*>(this); }
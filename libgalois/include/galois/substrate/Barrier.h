@@ -61,6 +61,33 @@ std::unique_ptr<Barrier> createTopoBarrier(unsigned);
 std::unique_ptr<Barrier> createCountingBarrier(unsigned);
 std::unique_ptr<Barrier> createDisseminationBarrier(unsigned);
 
+/**
+ * Barrier that also computes the logical or of a flag passed by each thread.
+ * Bulk-synchronous loops need both a barrier and a global "did anyone do
+ * work" test at the end of every round; combining them saves a second
+ * synchronization per round.
+ */
+class CombiningBarrier : public Barrier {
+public:
+  //! Waits like wait() and returns true if any thread passed true
+  virtual bool waitAny(bool flag) = 0;
+
+  virtual void wait() { waitAny(false); }
+};
+
+/**
+ * Creates a two level barrier that gathers the threads of each socket at the
+ * socket leader before going across sockets.
+ */
+std::unique_ptr<CombiningBarrier> createHierarchicalBarrier(unsigned);
+
+/**
+ * Creates the barrier returned by {@link getBarrier()}: a topological barrier,
+ * or a hierarchical barrier if GALOIS_HIERARCHICAL_BARRIER is set in the
+ * environment.
+ */
+std::unique_ptr<Barrier> createSystemBarrier(unsigned);
+
 /**
  * Creates a new simple barrier. This barrier is not designed to be fast but
  * does gaurantee that all threads have left the barrier before returning
@@ -79,7 +106,7 @@ struct BarrierInstance {
 
   BarrierInstance(void) {
     m_num_threads = getThreadPool().getMaxThreads();
-    m_barrier     = createTopoBarrier(m_num_threads);
+    m_barrier     = createSystemBarrier(m_num_threads);
   }
 
   Barrier& get(unsigned numT) {
@@ -31,6 +31,10 @@ size_t allocSize();
 // allocate contiguous pages, optionally faulting them in
 void* allocPages(unsigned num, bool preFault);
 
+// like allocPages, but falls back to transparent huge pages instead of small
+// pages when no huge pages are reserved
+void* allocTransparentHugePages(unsigned num, bool preFault);
+
 // free page range
 void freePages(void* ptr, unsigned num);
 
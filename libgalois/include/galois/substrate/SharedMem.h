@@ -33,7 +33,7 @@ class SharedMem {
   // Order is critical here
   ThreadPool m_tpool;
 
-  std::unique_ptr<internal::LocalTerminationDetection<>> m_termPtr;
+  std::unique_ptr<TerminationDetection> m_termPtr;
   std::unique_ptr<internal::BarrierInstance<>> m_biPtr;
 
 public:
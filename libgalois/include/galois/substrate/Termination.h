@@ -24,6 +24,8 @@
 #include "galois/substrate/CacheLineStorage.h"
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace galois {
 namespace substrate {
@@ -253,7 +255,127 @@ public:
   }
 };
 
+/**
+ * Dijkstra style 2-pass termination detection over the machine topology.
+ * Threads report to the leader of their socket and socket leaders report to
+ * thread 0, so a token wave crosses sockets once per socket instead of once
+ * per thread as in the ring, and threads only wait on state written within
+ * their socket. Each thread publishes its up token in its own storage, which
+ * its parent polls; parents never share a written cache line among children.
+ */
+template <typename _UNUSED = void>
+class HierarchicalTerminationDetection : public TerminationDetection {
+  struct TokenHolder {
+    // incoming from parent
+    std::atomic<bool> downToken;
+    // outgoing to parent: -1 not sent, otherwise whether this subtree was
+    // black
+    std::atomic<int> upToken;
+    // my state
+    bool processIsBlack;
+    bool hasToken;
+    bool lastWasWhite; // only used by the master
+    TokenHolder* parent;
+    std::vector<TokenHolder*> children;
+  };
+
+  PerThreadStorage<TokenHolder> data;
+
+  unsigned activeThreads = 0;
+
+  void propGlobalTerm() { globalTerm = true; }
+
+  bool isSysMaster() const { return ThreadPool::getTID() == 0; }
+
+  void processToken(TokenHolder& th) {
+    // have all up tokens?
+    bool haveAll = th.hasToken;
+    bool black   = th.processIsBlack;
+    for (TokenHolder* c : th.children) {
+      int t = c->upToken.load(std::memory_order_acquire);
+      if (t == -1) {
+        haveAll = false;
+        break;
+      }
+      black |= t;
+    }
+
+    // Have the tokens, propagate
+    if (haveAll) {
+      th.processIsBlack = false;
+      th.hasToken       = false;
+      if (isSysMaster()) {
+        if (th.lastWasWhite && !black) {
+          // This was the second success
+          propGlobalTerm();
+          return;
+        }
+        th.lastWasWhite = !black;
+        th.downToken.store(true, std::memory_order_release);
+      } else {
+        th.upToken.store(black, std::memory_order_release);
+      }
+    }
+
+    // received a down token, propagate
+    if (th.downToken.load(std::memory_order_acquire)) {
+      th.downToken.store(false, std::memory_order_relaxed);
+      th.upToken.store(-1, std::memory_order_relaxed);
+      th.hasToken = true;
+      for (TokenHolder* c : th.children) {
+        c->upToken.store(-1, std::memory_order_relaxed);
+        c->downToken.store(true, std::memory_order_release);
+      }
+    }
+  }
+
+protected:
+  virtual void init(unsigned aThreads) {
+    if (aThreads == activeThreads)
+      return;
+    activeThreads = aThreads;
+
+    ThreadPool& tp = getThreadPool();
+    for (unsigned i = 0; i < data.size(); ++i)
+      data.getRemote(i)->children.clear();
+    for (unsigned i = 0; i < aThreads; ++i) {
+      TokenHolder& th = *data.getRemote(i);
+      unsigned p      = tp.isLeader(i) ? 0 : tp.getLeader(i);
+      th.parent       = (i == 0) ? nullptr : data.getRemote(p);
+      if (th.parent)
+        th.parent->children.push_back(&th);
+    }
+  }
+
+public:
+  HierarchicalTerminationDetection() {}
+
+  virtual void initializeThread() {
+    TokenHolder& th   = *data.getLocal();
+    th.downToken      = isSysMaster();
+    th.upToken        = -1;
+    th.processIsBlack = true;
+    th.hasToken       = false;
+    th.lastWasWhite   = false;
+    globalTerm        = false;
+  }
+
+  virtual void localTermination(bool workHappened) {
+    assert(!(workHappened && globalTerm.get()));
+    TokenHolder& th = *data.getLocal();
+    th.processIsBlack |= workHappened;
+    processToken(th);
+  }
+};
+
 void setTermDetect(TerminationDetection* term);
+
+/**
+ * Creates the system termination detector: a ring detector, or a
+ * hierarchical one if GALOIS_HIERARCHICAL_TERMINATION is set in the
+ * environment.
+ */
+std::unique_ptr<TerminationDetection> createSystemTermination();
 } // end namespace internal
 
 } // namespace substrate
@@ -0,0 +1,269 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_ADAPTIVEOBIM_H
+#define GALOIS_WORKLIST_ADAPTIVEOBIM_H
+
+#include "galois/runtime/Statistics.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/worklists/Obim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Approximate priority scheduling whose bucket width adapts at runtime.
+ *
+ * Like {@link OrderedByIntegerMetric}, but the indexer returns the raw
+ * integral priority of an item and the worklist itself maps priorities to
+ * buckets of width 2^shift (i.e., the delta of delta-stepping). Bucket keys
+ * stay in priority units (priority with the low shift bits cleared), so
+ * buckets created under different widths remain correctly ordered and the
+ * width can be changed while the loop runs.
+ *
+ * Every 2^WindowPeriod pops, a thread looks at what it did in the last
+ * window:
+ *  - if most pushes landed back in the bucket being drained, that bucket is
+ *    processed in no particular order (chaotic relaxation), which is what
+ *    causes wasted re-relaxations, and the buckets are made narrower;
+ *  - if few pushes did but buckets drained after only a handful of items,
+ *    the worklist spends its time moving between buckets and the buckets
+ *    are made wider.
+ *
+ * Changes are published with a CAS on the shared shift so that concurrent
+ * decisions made from the same observation step the width only once.
+ *
+ * \code
+ * struct Indexer {
+ *   unsigned operator()(const Item& i) const { return i.dist; }
+ * };
+ *
+ * typedef galois::worklists::AdaptiveOrderedByIntegerMetric<Indexer> WL;
+ * galois::for_each(galois::iterate(items), Fn,
+ *                  galois::wl<WL>(Indexer(), initialShift));
+ * \endcode
+ *
+ * @tparam Indexer        Indexer class returning an integral priority
+ * @tparam Container      Scheduler for each bucket
+ * @tparam WindowPeriod   Re-evaluate the bucket width every 2^WindowPeriod
+ *                        pops per thread
+ * @tparam MinBucketRun   Widen buckets when fewer items than this are
+ *                        processed on average before moving to another bucket
+ */
+template <class Indexer      = DummyIndexer<int>,
+          typename Container = PerSocketChunkFIFO<>,
+          unsigned WindowPeriod = 10, unsigned MinBucketRun = 64,
+          typename T = int, typename Index = unsigned, bool Concurrent = true>
+struct AdaptiveOrderedByIntegerMetric : private boost::noncopyable {
+  static_assert(std::is_integral<Index>::value,
+                "only integral index types supported");
+
+  template <typename _T>
+  using retype = AdaptiveOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, WindowPeriod,
+      MinBucketRun, _T, typename std::result_of<Indexer(_T)>::type,
+      Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      AdaptiveOrderedByIntegerMetric<Indexer, Container, WindowPeriod,
+                                     MinBucketRun, T, Index, _b>;
+
+  template <typename _container>
+  struct with_container {
+    typedef AdaptiveOrderedByIntegerMetric<Indexer, _container, WindowPeriod,
+                                           MinBucketRun, T, Index, Concurrent>
+        type;
+  };
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef AdaptiveOrderedByIntegerMetric<_indexer, Container, WindowPeriod,
+                                           MinBucketRun, T, Index, Concurrent>
+        type;
+  };
+
+  template <unsigned _period>
+  struct with_window_period {
+    typedef AdaptiveOrderedByIntegerMetric<Indexer, Container, _period,
+                                           MinBucketRun, T, Index, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  //! Maps a priority to the key of the bucket that currently covers it
+  struct BucketIndexer {
+    Indexer indexer;
+    const std::atomic<unsigned>* shift;
+
+    Index operator()(const T& val) {
+      unsigned s = shift->load(std::memory_order_relaxed);
+      return (indexer(val) >> s) << s;
+    }
+  };
+
+  typedef OrderedByIntegerMetric<BucketIndexer, Container, 0, true, T, Index,
+                                 false, false, false, Concurrent>
+      Inner;
+
+  struct ThreadData {
+    Index lastKey;
+    unsigned shift;
+    size_t pops;
+    size_t bucketChanges;
+    size_t pushes;
+    size_t samePushes;
+
+    ThreadData()
+        : lastKey(std::numeric_limits<Index>::min()), shift(0), pops(0),
+          bucketChanges(0), pushes(0), samePushes(0) {}
+
+    void reset(unsigned s) {
+      shift         = s;
+      pops          = 0;
+      bucketChanges = 0;
+      pushes        = 0;
+      samePushes    = 0;
+    }
+  };
+
+  //! Fraction (in 1/16ths) of pushes into the current bucket above which
+  //! buckets are narrowed
+  static const size_t refineThreshold = 12;
+  //! Fraction (in 1/16ths) of pushes into the current bucket below which
+  //! buckets may be widened
+  static const size_t coarsenThreshold = 4;
+  static const unsigned maxShift       = sizeof(Index) * 8 - 2;
+
+  std::atomic<unsigned> shift;
+  std::atomic<size_t> numRefines;
+  std::atomic<size_t> numCoarsens;
+  Indexer indexer;
+  substrate::PerThreadStorage<ThreadData> data;
+  Inner inner;
+
+  void tryChangeShift(unsigned from, unsigned to) {
+    if (shift.compare_exchange_strong(from, to)) {
+      if (to < from)
+        numRefines += 1;
+      else
+        numCoarsens += 1;
+    }
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  void evaluate(ThreadData& p) {
+    unsigned cur = shift.load(std::memory_order_relaxed);
+
+    // Someone else changed the width during this window; observations are
+    // stale
+    if (cur != p.shift) {
+      p.reset(cur);
+      return;
+    }
+
+    size_t pushes    = std::max(p.pushes, size_t(1));
+    size_t bucketRun = p.pops / std::max(p.bucketChanges, size_t(1));
+    bool chaotic     = p.samePushes * 16 > pushes * refineThreshold;
+    bool ordered     = p.samePushes * 16 < pushes * coarsenThreshold;
+
+    if (chaotic && cur > 0)
+      tryChangeShift(cur, cur - 1);
+    else if (ordered && bucketRun < MinBucketRun && cur < maxShift)
+      tryChangeShift(cur, cur + 1);
+
+    p.reset(shift.load(std::memory_order_relaxed));
+  }
+
+public:
+  AdaptiveOrderedByIntegerMetric(const Indexer& x = Indexer(),
+                                 unsigned initialShift = 0)
+      : shift(initialShift < maxShift ? initialShift : maxShift), numRefines(0),
+        numCoarsens(0), indexer(x), inner(BucketIndexer{x, &shift}) {
+    for (unsigned i = 0; i < data.size(); ++i)
+      data.getRemote(i)->reset(shift.load(std::memory_order_relaxed));
+  }
+
+  ~AdaptiveOrderedByIntegerMetric() {
+    // Worklists may outlive the runtime (e.g., statics in tests)
+    if (!runtime::internal::sysStatManager())
+      return;
+    runtime::reportStat_Single("AdaptiveOBIM", "FinalShift", shift.load());
+    runtime::reportStat_Single("AdaptiveOBIM", "Refines", numRefines.load());
+    runtime::reportStat_Single("AdaptiveOBIM", "Coarsens", numCoarsens.load());
+  }
+
+  //! Current bucket width is 2^getShift()
+  unsigned getShift() const { return shift.load(std::memory_order_relaxed); }
+
+  void push(const value_type& val) {
+    ThreadData& p = *data.getLocal();
+    unsigned s    = shift.load(std::memory_order_relaxed);
+    p.pushes += 1;
+    if (((indexer(val) >> s) << s) == p.lastKey)
+      p.samePushes += 1;
+    inner.push(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    // Initial work is not generated by any popped item
+    auto rp = range.local_pair();
+    inner.push(rp.first, rp.second);
+  }
+
+  galois::optional<value_type> pop() {
+    galois::optional<value_type> item = inner.pop();
+    if (!item)
+      return item;
+
+    ThreadData& p = *data.getLocal();
+    unsigned s    = shift.load(std::memory_order_relaxed);
+    Index key     = (indexer(*item) >> s) << s;
+    if (key != p.lastKey) {
+      p.lastKey = key;
+      p.bucketChanges += 1;
+    }
+
+    if ((++p.pops & ((size_t(1) << WindowPeriod) - 1)) == 0)
+      evaluate(p);
+
+    return item;
+  }
+};
+GALOIS_WLCOMPILECHECK(AdaptiveOrderedByIntegerMetric)
+
+} // end namespace worklists
+} // end namespace galois
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+
+#ifndef GALOIS_WORKLIST_CHASELEV_H
+#define GALOIS_WORKLIST_CHASELEV_H
+
+#include "galois/optional.h"
+#include "galois/Threads.h"
+#include "galois/substrate/CompilerSpecific.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/ThreadPool.h"
+#include "WLCompileCheck.h"
+
+#include <boost/utility.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Lock-free work-stealing deque (Chase and Lev, SPAA'05, with the C11
+ * memory orderings of Le et al., PPoPP'13). The owning thread pushes and
+ * pops at the bottom; any other thread may steal from the top. The
+ * circular buffer grows on demand; retired buffers are kept until the deque
+ * is destroyed since a thief may still be reading them.
+ *
+ * T must be trivially copyable: a thief may copy an element that the owner
+ * concurrently overwrites, and then discards it when its CAS fails.
+ */
+template <typename T>
+class ChaseLevDeque : private boost::noncopyable {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "ChaseLevDeque requires trivially copyable elements");
+
+  struct Buffer {
+    int64_t mask;
+    T* data;
+
+    explicit Buffer(int64_t size) : mask(size - 1), data(new T[size]) {}
+    ~Buffer() { delete[] data; }
+
+    int64_t size() const { return mask + 1; }
+    T& at(int64_t i) { return data[i & mask]; }
+  };
+
+  static const int64_t initialSize = 256;
+
+  alignas(GALOIS_CACHE_LINE_SIZE) std::atomic<int64_t> top;
+  alignas(GALOIS_CACHE_LINE_SIZE) std::atomic<int64_t> bottom;
+  std::atomic<Buffer*> buffer;
+  //! All buffers ever allocated; only touched by the owner
+  std::vector<Buffer*> buffers;
+
+  Buffer* grow(Buffer* old, int64_t b, int64_t t) {
+    Buffer* n = new Buffer(old ? old->size() * 2 : initialSize);
+    for (int64_t i = t; i < b; ++i)
+      n->at(i) = old->at(i);
+    buffers.push_back(n);
+    buffer.store(n, std::memory_order_release);
+    return n;
+  }
+
+public:
+  ChaseLevDeque() : top(0), bottom(0), buffer(nullptr) {}
+
+  ~ChaseLevDeque() {
+    for (auto b : buffers)
+      delete b;
+  }
+
+  //! Racy emptiness check; fine as a hint for thieves
+  bool empty() const {
+    return bottom.load(std::memory_order_relaxed) <=
+           top.load(std::memory_order_relaxed);
+  }
+
+  //! Owner only
+  void push(const T& val) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    if (!a || b - t > a->mask)
+      a = grow(a, b, t);
+    a->at(b) = val;
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  //! Owner only; LIFO
+  galois::optional<T> pop() {
+    galois::optional<T> retval;
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t <= b) {
+      retval = a->at(b);
+      if (t == b) {
+        // last element: race against thieves
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+          retval = galois::optional<T>();
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return retval;
+  }
+
+  //! Any thread; FIFO. Fails (returns empty) on conflicts with other thieves.
+  galois::optional<T> steal() {
+    galois::optional<T> retval;
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t < b) {
+      Buffer* a = buffer.load(std::memory_order_acquire);
+      T val     = a->at(t);
+      if (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+        retval = val;
+    }
+    return retval;
+  }
+};
+
+/**
+ * Per-thread work-stealing worklist built on ChaseLevDeque. Each thread
+ * pushes and pops (LIFO) its own deque without locks or shared chunk lists;
+ * an idle thread steals the oldest item of a victim, trying the last
+ * successful victim first, then threads on its own socket, then threads on
+ * other sockets.
+ *
+ * Suited to fine-grained irregular loops where chunked worklists contend on
+ * their shared lists; items must be trivially copyable.
+ */
+template <typename T = int>
+class ChaseLevLIFO : private boost::noncopyable {
+public:
+  template <typename _T>
+  using retype = ChaseLevLIFO<_T>;
+
+  template <bool _concurrent>
+  using rethread = ChaseLevLIFO<T>;
+
+  typedef T value_type;
+
+private:
+  struct Local {
+    ChaseLevDeque<T> deque;
+    unsigned lastVictim = 0;
+  };
+
+  substrate::PerThreadStorage<Local> local;
+
+  galois::optional<T> trySteal(Local& me, unsigned victim) {
+    Local& v = *local.getRemote(victim);
+    if (v.deque.empty())
+      return galois::optional<T>();
+    galois::optional<T> retval = v.deque.steal();
+    if (retval)
+      me.lastVictim = victim;
+    return retval;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  galois::optional<T> doSteal(Local& me) {
+    auto& tp       = substrate::getThreadPool();
+    unsigned id    = substrate::ThreadPool::getTID();
+    unsigned pkg   = substrate::ThreadPool::getSocket();
+    unsigned num   = galois::getActiveThreads();
+    galois::optional<T> retval;
+
+    if (me.lastVictim != id && me.lastVictim < num &&
+        (retval = trySteal(me, me.lastVictim)))
+      return retval;
+
+    // same socket first, then everybody else
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned eid = (id + i) % num;
+      if (tp.getSocket(eid) == pkg && (retval = trySteal(me, eid)))
+        return retval;
+    }
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned eid = (id + i) % num;
+      if (tp.getSocket(eid) != pkg && (retval = trySteal(me, eid)))
+        return retval;
+    }
+    return retval;
+  }
+
+public:
+  void push(const value_type& val) { local.getLocal()->deque.push(val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    auto& d = local.getLocal()->deque;
+    while (b != e)
+      d.push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp = range.local_pair();
+    push(rp.first, rp.second);
+  }
+
+  galois::optional<value_type> pop() {
+    Local& me = *local.getLocal();
+    if (galois::optional<value_type> retval = me.deque.pop())
+      return retval;
+    return doSteal(me);
+  }
+};
+GALOIS_WLCOMPILECHECK(ChaseLevLIFO)
+
+} // namespace worklists
+} // namespace galois
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef GALOIS_WORKLIST_MULTIQUEUE_H
+#define GALOIS_WORKLIST_MULTIQUEUE_H
+
+#include "galois/runtime/Substrate.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/PaddedLock.h"
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/worklists/WorkListHelpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace galois {
+namespace worklists {
+
+/**
+ * Relaxed concurrent priority scheduling (MultiQueue). Items live in
+ * QueuesPerThread * activeThreads sequential binary heaps, each protected by
+ * its own lock. A pop samples two random heaps and takes the better of their
+ * minima; a push is buffered per thread and every BatchSize items the buffer
+ * is inserted into one random heap under a single lock acquisition. Until
+ * then buffered items can only be popped by the thread that pushed them.
+ *
+ * Like {@link OrderedByIntegerMetric}, the priority of an item is given by an
+ * Indexer (smaller values first), but there is no per-priority container, so
+ * the cost of an operation does not depend on how many distinct priorities
+ * are live. The pop order is only approximately sorted; the rank error
+ * grows with the number of heaps.
+ *
+ * The non-concurrent version uses a single heap and pops in exact priority
+ * order.
+ *
+ * \code
+ * typedef galois::worklists::MultiQueue<Indexer> WL;
+ * galois::for_each(galois::iterate(items), Fn, galois::wl<WL>());
+ * \endcode
+ *
+ * @tparam Indexer          Indexer class returning an integral priority
+ * @tparam QueuesPerThread  Number of heaps per active thread
+ * @tparam BatchSize        Number of pushes buffered by a thread before they
+ *                          are inserted into a heap
+ */
+template <class Indexer = DummyIndexer<int>, unsigned QueuesPerThread = 2,
+          unsigned BatchSize = 16, typename T = int, typename Index = unsigned,
+          bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+  static_assert(QueuesPerThread > 0, "need at least one queue per thread");
+  static_assert(BatchSize > 0, "batch size must be positive");
+
+public:
+  template <typename _T>
+  using retype =
+      MultiQueue<Indexer, QueuesPerThread, BatchSize, _T,
+                 typename std::result_of<Indexer(_T)>::type, Concurrent>;
+
+  template <bool _b>
+  using rethread =
+      MultiQueue<Indexer, QueuesPerThread, BatchSize, T, Index, _b>;
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef MultiQueue<_indexer, QueuesPerThread, BatchSize, T, Index,
+                       Concurrent>
+        type;
+  };
+
+  template <unsigned _queues>
+  struct with_queues_per_thread {
+    typedef MultiQueue<Indexer, _queues, BatchSize, T, Index, Concurrent> type;
+  };
+
+  template <unsigned _batch>
+  struct with_batch_size {
+    typedef MultiQueue<Indexer, QueuesPerThread, _batch, T, Index, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  typedef std::pair<Index, T> Entry;
+
+  struct EntryGreater {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return b.first < a.first;
+    }
+  };
+
+  //! Index stored in top of an empty heap; only a hint, see pop()
+  static constexpr Index emptyTop = std::numeric_limits<Index>::max();
+
+  struct alignas(GALOIS_CACHE_LINE_SIZE) Queue {
+    substrate::PaddedLock<Concurrent> lock;
+    //! Minimum of heap, readable without holding the lock
+    std::atomic<Index> top;
+    std::vector<Entry> heap;
+
+    Queue() : top(emptyTop) {}
+
+    void publishTop() {
+      top.store(heap.empty() ? emptyTop : heap.front().first,
+                std::memory_order_relaxed);
+    }
+
+    Entry popMin() {
+      std::pop_heap(heap.begin(), heap.end(), EntryGreater());
+      Entry e = std::move(heap.back());
+      heap.pop_back();
+      publishTop();
+      return e;
+    }
+  };
+
+  struct ThreadData {
+    uint64_t seed;
+    std::vector<Entry> buffer;
+
+    ThreadData() : seed(1) {}
+
+    //! xorshift64
+    size_t next(size_t n) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      return seed % n;
+    }
+  };
+
+  size_t numQueues;
+  std::unique_ptr<Queue[]> queues;
+  substrate::PerThreadStorage<ThreadData> data;
+  Indexer indexer;
+
+  void flush(ThreadData& p) {
+    Queue* q;
+    do {
+      q = &queues[p.next(numQueues)];
+    } while (!q->lock.try_lock());
+
+    for (auto& e : p.buffer) {
+      q->heap.push_back(std::move(e));
+      std::push_heap(q->heap.begin(), q->heap.end(), EntryGreater());
+    }
+    q->publishTop();
+    q->lock.unlock();
+    p.buffer.clear();
+  }
+
+  //! Takes the entry at i out of the push buffer of p
+  galois::optional<value_type>
+  popBuffered(ThreadData& p, typename std::vector<Entry>::iterator i) {
+    std::swap(*i, p.buffer.back());
+    galois::optional<value_type> item(std::move(p.buffer.back().second));
+    p.buffer.pop_back();
+    return item;
+  }
+
+  GALOIS_ATTRIBUTE_NOINLINE
+  galois::optional<value_type> slowPop(ThreadData& p) {
+    // Top values are only hints; check every heap under its lock before
+    // reporting that there is no work
+    size_t start = p.next(numQueues);
+    for (size_t i = 0; i < numQueues; ++i) {
+      Queue& q = queues[(start + i) % numQueues];
+      q.lock.lock();
+      if (!q.heap.empty()) {
+        galois::optional<value_type> item(q.popMin().second);
+        q.lock.unlock();
+        return item;
+      }
+      q.lock.unlock();
+    }
+    return galois::optional<value_type>();
+  }
+
+public:
+  MultiQueue(const Indexer& x = Indexer())
+      : numQueues(Concurrent ? QueuesPerThread * runtime::activeThreads : 1),
+        queues(new Queue[numQueues]), indexer(x) {
+    for (unsigned i = 0; i < data.size(); ++i) {
+      ThreadData& p = *data.getRemote(i);
+      // xorshift state must be nonzero
+      p.seed = (i + 1) * 0x9E3779B97F4A7C15ULL;
+      p.buffer.reserve(BatchSize);
+    }
+  }
+
+  void push(const value_type& val) {
+    ThreadData& p = *data.getLocal();
+    p.buffer.emplace_back(indexer(val), val);
+    if (p.buffer.size() >= BatchSize)
+      flush(p);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    auto rp = range.local_pair();
+    push(rp.first, rp.second);
+    ThreadData& p = *data.getLocal();
+    if (!p.buffer.empty())
+      flush(p);
+  }
+
+  galois::optional<value_type> pop() {
+    ThreadData& p = *data.getLocal();
+    // The best item in this thread's push buffer competes with the sampled
+    // heaps. A thread only reports an empty worklist once its buffer is
+    // empty, so buffered work is never lost.
+    auto best = std::min_element(
+        p.buffer.begin(), p.buffer.end(),
+        [](const Entry& x, const Entry& y) { return x.first < y.first; });
+    bool buffered = best != p.buffer.end();
+
+    for (size_t attempt = 0; attempt < numQueues; ++attempt) {
+      Queue* a = &queues[p.next(numQueues)];
+      Queue* b = &queues[p.next(numQueues)];
+      Index ta = a->top.load(std::memory_order_relaxed);
+      Index tb = b->top.load(std::memory_order_relaxed);
+      if (tb < ta) {
+        std::swap(a, b);
+        std::swap(ta, tb);
+      }
+      if (buffered && best->first <= ta)
+        return popBuffered(p, best);
+      if (ta == emptyTop)
+        continue;
+      if (!a->lock.try_lock())
+        continue;
+      if (a->heap.empty()) {
+        a->lock.unlock();
+        continue;
+      }
+      galois::optional<value_type> item(a->popMin().second);
+      a->lock.unlock();
+      return item;
+    }
+
+    if (buffered)
+      return popBuffered(p, best);
+    return slowPop(p);
+  }
+};
+GALOIS_WLCOMPILECHECK(MultiQueue)
+
+} // end namespace worklists
+} // end namespace galois
+
+#endif
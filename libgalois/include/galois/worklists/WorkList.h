@@ -23,11 +23,14 @@
 #include "galois/optional.h"
 
 #include "PerThreadChunk.h"
+#include "ChaseLev.h"
 #include "BulkSynchronous.h"
 #include "Chunk.h"
 #include "Simple.h"
 #include "LocalQueue.h"
+#include "MultiQueue.h"
 #include "Obim.h"
+#include "AdaptiveObim.h"
 #include "OrderedList.h"
 #include "OwnerComputes.h"
 #include "StableIterator.h"
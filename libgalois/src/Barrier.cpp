@@ -18,6 +18,7 @@
  */
 
 #include "galois/substrate/Barrier.h"
+#include "galois/substrate/EnvCheck.h"
 
 // anchor vtable
 galois::substrate::Barrier::~Barrier() {}
@@ -27,6 +28,13 @@ galois::substrate::Barrier::~Barrier() {}
 //  return benchmarking::getTopoBarrier(activeThreads);
 //}
 
+std::unique_ptr<galois::substrate::Barrier>
+galois::substrate::createSystemBarrier(unsigned activeThreads) {
+  if (EnvCheck("GALOIS_HIERARCHICAL_BARRIER"))
+    return createHierarchicalBarrier(activeThreads);
+  return createTopoBarrier(activeThreads);
+}
+
 static galois::substrate::internal::BarrierInstance<>* BI = nullptr;
 
 void galois::substrate::internal::setBarrierInstance(
@@ -0,0 +1,113 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/substrate/PerThreadStorage.h"
+#include "galois/substrate/Barrier.h"
+#include "galois/substrate/CompilerSpecific.h"
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+/**
+ * Two level sense reversing barrier following the machine topology. Every
+ * thread announces arrival by writing a flag in its own cache line; the
+ * leader of each socket gathers the threads of its socket and thread 0
+ * gathers the socket leaders. Release goes back down the same tree, so a
+ * thread only ever spins on a line written by its socket leader and no
+ * line is the target of concurrent read-modify-writes, unlike the counter
+ * based barriers. The or-reduced flag rides in the low bit of the arrival
+ * and release words.
+ */
+class HierarchicalBarrier : public galois::substrate::CombiningBarrier {
+  struct node {
+    // (round << 1) | flag of this subtree, written by this thread
+    std::atomic<unsigned> arrived;
+    // (round << 1) | global flag, written by this thread for its children
+    std::atomic<unsigned> release;
+    unsigned round;
+    node* parent;
+    std::vector<node*> children;
+  };
+
+  galois::substrate::PerThreadStorage<node> nodes;
+
+  void _reinit(unsigned P) {
+    auto& tp = galois::substrate::getThreadPool();
+    for (unsigned i = 0; i < nodes.size(); ++i) {
+      node& n   = *nodes.getRemote(i);
+      n.arrived = 0;
+      n.release = 0;
+      n.round   = 1;
+      n.parent  = nullptr;
+      n.children.clear();
+    }
+    for (unsigned i = 1; i < P; ++i) {
+      node& n  = *nodes.getRemote(i);
+      n.parent = nodes.getRemote(tp.isLeader(i) ? 0 : tp.getLeader(i));
+      n.parent->children.push_back(&n);
+    }
+  }
+
+  static unsigned roundOf(unsigned v) { return v >> 1; }
+
+public:
+  HierarchicalBarrier(unsigned v) { _reinit(v); }
+
+  // not safe if any thread is in wait
+  virtual void reinit(unsigned val) { _reinit(val); }
+
+  virtual bool waitAny(bool flag) {
+    node& n    = *nodes.getLocal();
+    unsigned r = n.round & (~0U >> 1);
+    unsigned v = flag;
+    // gather: socket members first, then (at thread 0) the other leaders
+    for (node* c : n.children) {
+      unsigned a;
+      while (roundOf(a = c->arrived.load(std::memory_order_acquire)) != r)
+        galois::substrate::asmPause();
+      v |= a & 1;
+    }
+
+    if (n.parent) {
+      n.arrived.store((r << 1) | v, std::memory_order_release);
+      unsigned a;
+      while (roundOf(a = n.parent->release.load(std::memory_order_acquire)) !=
+             r)
+        galois::substrate::asmPause();
+      v = a & 1;
+    }
+    // release: thread 0 wakes the leaders, leaders wake their socket
+    if (!n.children.empty())
+      n.release.store((r << 1) | v, std::memory_order_release);
+    n.round = r + 1;
+    return v;
+  }
+
+  virtual const char* name() const { return "HierarchicalBarrier"; }
+};
+
+} // namespace
+
+std::unique_ptr<galois::substrate::CombiningBarrier>
+galois::substrate::createHierarchicalBarrier(unsigned activeThreads) {
+  return std::unique_ptr<CombiningBarrier>(
+      new HierarchicalBarrier(activeThreads));
+}
@@ -0,0 +1,110 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/graphs/GraphFileReader.h"
+#include "galois/Endian.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace galois {
+namespace graphs {
+
+//! Largest single pread; keeps each request well below any OS limit
+static const size_t maxReadSize = size_t(1) << 30;
+
+GraphFileReader::GraphFileReader(const std::string& filename) : bytesRead(0) {
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+#ifdef POSIX_FADV_SEQUENTIAL
+  // each reader streams through its own contiguous range
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  uint64_t header[4];
+  readAt(header, sizeof(header), 0);
+  graphVersion = convert_le64toh(header[0]);
+  sizeofEdge   = convert_le64toh(header[1]);
+  numNodes     = convert_le64toh(header[2]);
+  numEdges     = convert_le64toh(header[3]);
+
+  if (graphVersion != 1 && graphVersion != 2)
+    GALOIS_DIE("unknown file version ", graphVersion);
+}
+
+GraphFileReader::~GraphFileReader() { close(fd); }
+
+void GraphFileReader::readAt(void* dst, size_t len, uint64_t offset) {
+  char* out = static_cast<char*>(dst);
+  while (len) {
+    ssize_t r = pread(fd, out, std::min(len, maxReadSize), offset);
+    if (r == -1)
+      GALOIS_SYS_DIE("failed reading graph file");
+    if (r == 0)
+      GALOIS_DIE("unexpected end of graph file");
+    out += r;
+    offset += r;
+    len -= r;
+    bytesRead += r;
+  }
+}
+
+void GraphFileReader::readOutIdx(uint64_t* dst, uint64_t begin, uint64_t end) {
+  readAt(dst, (end - begin) * sizeof(uint64_t),
+         outIdxOffset() + begin * sizeof(uint64_t));
+  for (uint64_t i = 0; i < end - begin; ++i)
+    dst[i] = convert_le64toh(dst[i]);
+}
+
+void GraphFileReader::readEdgeDst(uint32_t* dst, uint64_t begin,
+                                  uint64_t end) {
+  if (graphVersion == 1) {
+    readAt(dst, (end - begin) * sizeof(uint32_t),
+           outsOffset() + begin * sizeof(uint32_t));
+    for (uint64_t i = 0; i < end - begin; ++i)
+      dst[i] = convert_le32toh(dst[i]);
+    return;
+  }
+
+  // stage 64-bit ids through a bounded buffer
+  const uint64_t chunk = 1 << 16;
+  std::vector<uint64_t> buf(std::min(chunk, end - begin));
+  for (uint64_t b = begin; b < end; b += chunk) {
+    uint64_t e = std::min(b + chunk, end);
+    readAt(buf.data(), (e - b) * sizeof(uint64_t),
+           outsOffset() + b * sizeof(uint64_t));
+    for (uint64_t i = 0; i < e - b; ++i)
+      dst[b - begin + i] = convert_le64toh(buf[i]);
+  }
+}
+
+void GraphFileReader::readEdgeData(void* dst, uint64_t begin, uint64_t end) {
+  readAt(dst, (end - begin) * sizeofEdge,
+         edgeDataOffset() + begin * sizeofEdge);
+}
+
+} // namespace graphs
+} // namespace galois
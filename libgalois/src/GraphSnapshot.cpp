@@ -0,0 +1,154 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/graphs/GraphSnapshot.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace galois {
+namespace graphs {
+
+//! Sections start on page boundaries so they can be mapped independently
+static const uint64_t sectionAlign = 4096;
+//! Largest single pwrite
+static const size_t maxWriteSize = size_t(1) << 30;
+
+static uint64_t alignUp(uint64_t x) {
+  return (x + sectionAlign - 1) & ~(sectionAlign - 1);
+}
+
+static void writeAt(int fd, const void* src, size_t len, uint64_t offset) {
+  const char* in = static_cast<const char*>(src);
+  while (len) {
+    ssize_t r = pwrite(fd, in, std::min(len, maxWriteSize), offset);
+    if (r == -1)
+      GALOIS_SYS_DIE("failed writing graph snapshot");
+    in += r;
+    offset += r;
+    len -= r;
+  }
+}
+
+GraphSnapshot::GraphSnapshot(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+
+  struct stat buf;
+  if (fstat(fd, &buf) == -1)
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  length = buf.st_size;
+  if (length < sizeof(Header))
+    GALOIS_DIE("'", filename, "' is not a graph snapshot");
+
+  // No MAP_POPULATE: pages are faulted in when the graph first touches them
+  base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (base == MAP_FAILED)
+    GALOIS_SYS_DIE("failed mapping ", "'", filename, "'");
+  close(fd);
+
+  std::memcpy(&hdr, base, sizeof(Header));
+  if (hdr.magic != MAGIC)
+    GALOIS_DIE("'", filename, "' is not a graph snapshot");
+  if (hdr.version != VERSION)
+    GALOIS_DIE("unknown graph snapshot version ", hdr.version);
+
+  for (unsigned s = 0; s < NUM_SECTIONS; ++s) {
+    const SectionInfo& info = hdr.sections[s];
+    if (!info.bytes)
+      continue;
+    if (info.offset % sectionAlign || info.offset > length ||
+        info.bytes > length - info.offset)
+      GALOIS_DIE("graph snapshot '", filename, "' is truncated or corrupt");
+  }
+}
+
+GraphSnapshot::~GraphSnapshot() { munmap(base, length); }
+
+void* GraphSnapshot::section(Section s, uint64_t bytes) const {
+  const SectionInfo& info = hdr.sections[s];
+  if (info.bytes != bytes)
+    GALOIS_DIE("graph snapshot section ", s, " has ", info.bytes,
+               " bytes but graph expects ", bytes,
+               "; was it written for a different graph type?");
+  if (!bytes)
+    return nullptr;
+  return static_cast<char*>(base) + info.offset;
+}
+
+GraphSnapshotWriter::GraphSnapshotWriter(uint64_t numNodes, uint64_t numEdges,
+                                         uint64_t nodeDataSize,
+                                         uint64_t edgeDataSize, uint64_t flags)
+    : data(GraphSnapshot::NUM_SECTIONS, nullptr) {
+  std::memset(&hdr, 0, sizeof(hdr));
+  hdr.magic        = GraphSnapshot::MAGIC;
+  hdr.version      = GraphSnapshot::VERSION;
+  hdr.flags        = flags;
+  hdr.numNodes     = numNodes;
+  hdr.numEdges     = numEdges;
+  hdr.nodeDataSize = nodeDataSize;
+  hdr.edgeDataSize = edgeDataSize;
+}
+
+void GraphSnapshotWriter::addSection(GraphSnapshot::Section s, const void* ptr,
+                                     uint64_t bytes) {
+  data[s]               = ptr;
+  hdr.sections[s].bytes = bytes;
+}
+
+void GraphSnapshotWriter::write(const std::string& filename) {
+  uint64_t offset = alignUp(sizeof(hdr));
+  for (unsigned s = 0; s < GraphSnapshot::NUM_SECTIONS; ++s) {
+    if (!hdr.sections[s].bytes)
+      continue;
+    hdr.sections[s].offset = offset;
+    offset                 = alignUp(offset + hdr.sections[s].bytes);
+  }
+
+  std::string tmp = filename + ".tmp";
+  int fd          = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed creating ", "'", tmp, "'");
+
+  writeAt(fd, &hdr, sizeof(hdr), 0);
+  for (unsigned s = 0; s < GraphSnapshot::NUM_SECTIONS; ++s) {
+    if (hdr.sections[s].bytes)
+      writeAt(fd, data[s], hdr.sections[s].bytes, hdr.sections[s].offset);
+  }
+  // Padding after the last section is left as a hole
+  if (ftruncate(fd, offset) == -1)
+    GALOIS_SYS_DIE("failed writing ", "'", tmp, "'");
+  if (close(fd) == -1)
+    GALOIS_SYS_DIE("failed writing ", "'", tmp, "'");
+
+  if (rename(tmp.c_str(), filename.c_str()) == -1)
+    GALOIS_SYS_DIE("failed renaming ", "'", tmp, "' to '", filename, "'");
+}
+
+} // namespace graphs
+} // namespace galois
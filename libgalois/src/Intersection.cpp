@@ -0,0 +1,215 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Intersection.h"
+#include "galois/gIO.h"
+#include "IntersectionKernels.h"
+
+#include <algorithm>
+
+namespace galois {
+namespace intersection {
+
+using namespace internal;
+
+static Kernel detectKernel() {
+#if defined(GALOIS_INTERSECTION_AVX512)
+  if (__builtin_cpu_supports("avx512f"))
+    return AVX512;
+#endif
+#if defined(GALOIS_INTERSECTION_AVX2)
+  if (__builtin_cpu_supports("avx2"))
+    return AVX2;
+#endif
+  return SCALAR;
+}
+
+Kernel bestKernel() {
+  static const Kernel best = detectKernel();
+  return best;
+}
+
+bool isSupported(Kernel k) {
+  switch (k) {
+  case AVX512:
+#if defined(GALOIS_INTERSECTION_AVX512)
+    return __builtin_cpu_supports("avx512f");
+#else
+    return false;
+#endif
+  case AVX2:
+#if defined(GALOIS_INTERSECTION_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+  default:
+    return true;
+  }
+}
+
+const char* kernelName(Kernel k) {
+  switch (k) {
+  case AUTO:
+    return "auto";
+  case SCALAR:
+    return "scalar";
+  case GALLOP:
+    return "gallop";
+  case AVX2:
+    return "avx2";
+  case AVX512:
+    return "avx512";
+  }
+  return "unknown";
+}
+
+/**
+ * For each element of a, exponential then binary search in b starting from
+ * the previous match. Costs O(na log(nb / na)) instead of O(na + nb).
+ */
+template <typename T, typename E>
+static void gallop(const T* a, size_t na, const T* b, size_t nb, E& e) {
+  size_t j = 0;
+  for (size_t i = 0; i < na && j < nb; ++i) {
+    T x = a[i];
+    if (b[j] < x) {
+      size_t step = 1, lo = j;
+      while (j + step < nb && b[j + step] < x) {
+        lo = j + step;
+        step *= 2;
+      }
+      j = std::lower_bound(b + lo + 1, b + std::min(j + step, nb), x) - b;
+      if (j == nb)
+        break;
+    }
+    if (b[j] == x)
+      e.one(i, j++);
+  }
+}
+
+//! Gallops through the larger of the two sets
+template <typename T, typename E>
+static void gallopSmaller(const T* a, size_t na, const T* b, size_t nb,
+                          E& e) {
+  if (na <= nb) {
+    gallop(a, na, b, nb, e);
+  } else {
+    SwapEmit<E> s{e};
+    gallop(b, nb, a, na, s);
+  }
+}
+
+static Kernel resolve(Kernel k, size_t na, size_t nb) {
+  if (k == AUTO) {
+    size_t lo = std::min(na, nb), hi = std::max(na, nb);
+    return lo * gallopRatio <= hi ? GALLOP : bestKernel();
+  }
+  if (!isSupported(k))
+    GALOIS_DIE("intersection kernel ", kernelName(k),
+               " is not supported on this machine");
+  return k;
+}
+
+size_t count(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+             Kernel k) {
+  switch (resolve(k, na, nb)) {
+#if defined(GALOIS_INTERSECTION_AVX512)
+  case AVX512:
+    return countAVX512(a, na, b, nb);
+#endif
+#if defined(GALOIS_INTERSECTION_AVX2)
+  case AVX2:
+    return countAVX2(a, na, b, nb);
+#endif
+  case GALLOP: {
+    CountEmit<uint32_t> e;
+    gallopSmaller(a, na, b, nb, e);
+    return e.n;
+  }
+  default: {
+    CountEmit<uint32_t> e;
+    scalarMerge(a, na, b, nb, 0, 0, e);
+    return e.n;
+  }
+  }
+}
+
+template <typename T>
+static size_t intersectImpl(const T* a, size_t na, const T* b, size_t nb,
+                            T* out, Kernel k) {
+  switch (resolve(k, na, nb)) {
+#if defined(GALOIS_INTERSECTION_AVX512)
+  case AVX512:
+    return intersectAVX512(a, na, b, nb, out);
+#endif
+#if defined(GALOIS_INTERSECTION_AVX2)
+  case AVX2:
+    return intersectAVX2(a, na, b, nb, out);
+#endif
+  case GALLOP: {
+    ValueEmit<T> e(a, out);
+    gallopSmaller(a, na, b, nb, e);
+    return e.n;
+  }
+  default: {
+    ValueEmit<T> e(a, out);
+    scalarMerge(a, na, b, nb, 0, 0, e);
+    return e.n;
+  }
+  }
+}
+
+size_t intersect(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                 uint32_t* out, Kernel k) {
+  return intersectImpl(a, na, b, nb, out, k);
+}
+
+size_t intersect(const uint64_t* a, size_t na, const uint64_t* b, size_t nb,
+                 uint64_t* out, Kernel k) {
+  return intersectImpl(a, na, b, nb, out, k);
+}
+
+size_t intersectPositions(const uint32_t* a, size_t na, const uint32_t* b,
+                          size_t nb, uint32_t* posA, uint32_t* posB,
+                          Kernel k) {
+  switch (resolve(k, na, nb)) {
+#if defined(GALOIS_INTERSECTION_AVX512)
+  case AVX512:
+    return positionsAVX512(a, na, b, nb, posA, posB);
+#endif
+#if defined(GALOIS_INTERSECTION_AVX2)
+  case AVX2:
+    return positionsAVX2(a, na, b, nb, posA, posB);
+#endif
+  case GALLOP: {
+    PositionEmit<uint32_t> e(posA, posB);
+    gallopSmaller(a, na, b, nb, e);
+    return e.n;
+  }
+  default: {
+    PositionEmit<uint32_t> e(posA, posB);
+    scalarMerge(a, na, b, nb, 0, 0, e);
+    return e.n;
+  }
+  }
+}
+
+} // namespace intersection
+} // namespace galois
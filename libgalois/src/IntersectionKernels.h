@@ -0,0 +1,202 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file IntersectionKernels.h
+ *
+ * Building blocks of the kernels in galois/Intersection.h, shared by the
+ * translation units compiled for each instruction set. Everything here has
+ * internal linkage: the same template instantiated in an AVX-512 unit and in
+ * a baseline unit must not be merged by the linker.
+ */
+
+#ifndef GALOIS_SRC_INTERSECTIONKERNELS_H
+#define GALOIS_SRC_INTERSECTIONKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace galois {
+namespace intersection {
+namespace internal {
+
+// Kernels entry points for each instruction set; defined only if the
+// corresponding unit is built (GALOIS_INTERSECTION_AVX2/AVX512)
+size_t countAVX2(const uint32_t*, size_t, const uint32_t*, size_t);
+size_t intersectAVX2(const uint32_t*, size_t, const uint32_t*, size_t,
+                     uint32_t*);
+size_t intersectAVX2(const uint64_t*, size_t, const uint64_t*, size_t,
+                     uint64_t*);
+size_t positionsAVX2(const uint32_t*, size_t, const uint32_t*, size_t,
+                     uint32_t*, uint32_t*);
+
+size_t countAVX512(const uint32_t*, size_t, const uint32_t*, size_t);
+size_t intersectAVX512(const uint32_t*, size_t, const uint32_t*, size_t,
+                       uint32_t*);
+size_t intersectAVX512(const uint64_t*, size_t, const uint64_t*, size_t,
+                       uint64_t*);
+size_t positionsAVX512(const uint32_t*, size_t, const uint32_t*, size_t,
+                       uint32_t*, uint32_t*);
+
+namespace {
+
+/*
+ * Emitters receive the matches found by a kernel, either one at a time as a
+ * pair of indices into a and b, or a block at a time as bitmasks over a
+ * block of a starting at i and a block of b starting at j. Bit k of ma (mb)
+ * is set if a[i + k] (b[j + k]) is common; matches pair up in order.
+ */
+
+template <typename T>
+struct CountEmit {
+  static const bool needB = false;
+  size_t n                = 0;
+
+  void one(size_t, size_t) { ++n; }
+  void block(size_t, uint64_t ma, size_t, uint64_t) {
+    n += __builtin_popcountll(ma);
+  }
+};
+
+template <typename T>
+struct ValueEmit {
+  static const bool needB = false;
+  const T* a;
+  T* out;
+  size_t n = 0;
+
+  ValueEmit(const T* a, T* out) : a(a), out(out) {}
+
+  void one(size_t i, size_t) { out[n++] = a[i]; }
+  void block(size_t i, uint64_t ma, size_t, uint64_t) {
+    for (; ma; ma &= ma - 1)
+      out[n++] = a[i + __builtin_ctzll(ma)];
+  }
+};
+
+template <typename T>
+struct PositionEmit {
+  static const bool needB = true;
+  uint32_t* posA;
+  uint32_t* posB;
+  size_t n = 0;
+
+  PositionEmit(uint32_t* pa, uint32_t* pb) : posA(pa), posB(pb) {}
+
+  void one(size_t i, size_t j) {
+    posA[n]   = i;
+    posB[n++] = j;
+  }
+  void block(size_t i, uint64_t ma, size_t j, uint64_t mb) {
+    for (; ma; ma &= ma - 1, mb &= mb - 1) {
+      posA[n]   = i + __builtin_ctzll(ma);
+      posB[n++] = j + __builtin_ctzll(mb);
+    }
+  }
+};
+
+//! Presents matches of (b, a) to an emitter expecting (a, b)
+template <typename E>
+struct SwapEmit {
+  static const bool needB = E::needB;
+  E& e;
+
+  void one(size_t j, size_t i) { e.one(i, j); }
+  void block(size_t j, uint64_t mb, size_t i, uint64_t ma) {
+    e.block(i, ma, j, mb);
+  }
+};
+
+//! Merges a[i, na) with b[j, nb)
+template <typename T, typename E>
+void scalarMerge(const T* a, size_t na, const T* b, size_t nb, size_t i,
+                 size_t j, E& e) {
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      e.one(i, j);
+      ++i;
+      ++j;
+    }
+  }
+}
+
+//! Rotates the low w bits of m left by r
+inline uint64_t rotateMask(uint64_t m, unsigned r, unsigned w) {
+  uint64_t full = w == 64 ? ~uint64_t(0) : (uint64_t(1) << w) - 1;
+  return r ? ((m << r) | (m >> (w - r))) & full : m;
+}
+
+/**
+ * Block merge: compares a block of V::W elements of a against all V::W
+ * rotations of a block of b, then advances the block(s) with the smaller
+ * last element. Since both sets are duplicate free, every common element is
+ * seen in exactly one pair of blocks. The tails are merged by scalarMerge.
+ *
+ * V provides the vector type and load, rotate-by-one-lane and
+ * equality-to-bitmask operations for one instruction set.
+ */
+template <typename V, typename E>
+inline void blockMerge(const typename V::T* a, size_t na,
+                       const typename V::T* b, size_t nb, E& e) {
+  const unsigned W = V::W;
+  size_t i = 0, j = 0;
+  while (i + W <= na && j + W <= nb) {
+    auto amax = a[i + W - 1], bmax = b[j + W - 1];
+    // disjoint blocks need no comparison
+    if (amax < b[j]) {
+      i += W;
+      continue;
+    }
+    if (bmax < a[i]) {
+      j += W;
+      continue;
+    }
+
+    typename V::Vec va = V::load(a + i);
+    typename V::Vec vb = V::load(b + j);
+    uint64_t ma = 0, mb = 0;
+    for (unsigned r = 0; r < W; ++r) {
+      // lane k of vb now holds b[j + (k + r) % W]
+      uint64_t m = V::eq(va, vb);
+      ma |= m;
+      if (E::needB)
+        mb |= rotateMask(m, r, W);
+      vb = V::rotate(vb);
+    }
+    if (ma)
+      e.block(i, ma, j, mb);
+
+    if (amax <= bmax)
+      i += W;
+    if (bmax <= amax)
+      j += W;
+  }
+  scalarMerge(a, na, b, nb, i, j, e);
+}
+
+} // namespace
+} // namespace internal
+} // namespace intersection
+} // namespace galois
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/*
+ * AVX-512 block merge kernels. This unit is compiled with -mavx512f and only
+ * called after checking that the CPU supports AVX-512F.
+ */
+
+#include "IntersectionKernels.h"
+
+#include <immintrin.h>
+
+namespace galois {
+namespace intersection {
+namespace internal {
+
+namespace {
+
+struct AVX512x32 {
+  typedef uint32_t T;
+  typedef __m512i Vec;
+  static const unsigned W = 16;
+
+  static Vec load(const T* p) { return _mm512_loadu_si512(p); }
+  // the masked form avoids GCC warning about the unmasked form's undefined
+  // pass-through operand
+  static Vec rotate(Vec v) {
+    return _mm512_mask_alignr_epi32(v, ~0, v, v, 1);
+  }
+  static uint64_t eq(Vec a, Vec b) { return _mm512_cmpeq_epi32_mask(a, b); }
+};
+
+struct AVX512x64 {
+  typedef uint64_t T;
+  typedef __m512i Vec;
+  static const unsigned W = 8;
+
+  static Vec load(const T* p) { return _mm512_loadu_si512(p); }
+  static Vec rotate(Vec v) {
+    return _mm512_mask_alignr_epi64(v, ~0, v, v, 1);
+  }
+  static uint64_t eq(Vec a, Vec b) { return _mm512_cmpeq_epi64_mask(a, b); }
+};
+
+} // namespace
+
+size_t countAVX512(const uint32_t* a, size_t na, const uint32_t* b,
+                   size_t nb) {
+  CountEmit<uint32_t> e;
+  blockMerge<AVX512x32>(a, na, b, nb, e);
+  return e.n;
+}
+
+size_t intersectAVX512(const uint32_t* a, size_t na, const uint32_t* b,
+                       size_t nb, uint32_t* out) {
+  ValueEmit<uint32_t> e(a, out);
+  blockMerge<AVX512x32>(a, na, b, nb, e);
+  return e.n;
+}
+
+size_t intersectAVX512(const uint64_t* a, size_t na, const uint64_t* b,
+                       size_t nb, uint64_t* out) {
+  ValueEmit<uint64_t> e(a, out);
+  blockMerge<AVX512x64>(a, na, b, nb, e);
+  return e.n;
+}
+
+size_t positionsAVX512(const uint32_t* a, size_t na, const uint32_t* b,
+                       size_t nb, uint32_t* posA, uint32_t* posB) {
+  PositionEmit<uint32_t> e(posA, posB);
+  blockMerge<AVX512x32>(a, na, b, nb, e);
+  return e.n;
+}
+
+} // namespace internal
+} // namespace intersection
+} // namespace galois
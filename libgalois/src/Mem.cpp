@@ -18,10 +18,14 @@
  */
 
 #include "galois/runtime/Mem.h"
+#include "galois/substrate/PageAlloc.h"
 
 #include <map>
 #include <mutex>
 
+#include <sys/resource.h>
+#include <sys/time.h>
+
 using namespace galois::runtime;
 
 // Anchor the class
@@ -29,6 +33,96 @@ SystemHeap::SystemHeap() { assert(AllocSize == runtime::pagePoolSize()); }
 
 SystemHeap::~SystemHeap() {}
 
+//! Minor page faults taken by the calling thread so far
+static size_t threadMinorFaults() {
+#ifdef RUSAGE_THREAD
+  struct rusage usage;
+  if (getrusage(RUSAGE_THREAD, &usage) == 0)
+    return usage.ru_minflt;
+#endif
+  return 0;
+}
+
+//! Set once NumaPageArena maps its first page
+static std::atomic<bool> arenaUsed(false);
+
+bool NumaPageArena::used() { return arenaUsed; }
+
+NumaPageArena::Page* NumaPageArena::allocateFromPool(ThreadCache& cache) {
+  SocketPool& pool = *pools.getLocal();
+  if (pool.head.load(std::memory_order_relaxed)) {
+    std::lock_guard<substrate::SimpleLock> lg(pool.lock);
+    Page* p = pool.head.load(std::memory_order_relaxed);
+    if (p) {
+      pool.head.store(p->next, std::memory_order_relaxed);
+      p->next = nullptr;
+      cache.stats.socketPages += 1;
+      return p;
+    }
+  }
+
+  arenaUsed     = true;
+  size_t faults = threadMinorFaults();
+  Page* p = static_cast<Page*>(substrate::allocTransparentHugePages(1, true));
+  cache.stats.pageFaults += threadMinorFaults() - faults;
+  cache.stats.newPages += 1;
+  p->next   = nullptr;
+  p->socket = substrate::ThreadPool::getSocket();
+  return p;
+}
+
+void NumaPageArena::release(Page* list) {
+  ThreadCache& cache = *caches.getLocal();
+  unsigned socket    = substrate::ThreadPool::getSocket();
+
+  while (list) {
+    Page* p = list;
+    list    = p->next;
+
+    if (p->socket == socket && cache.num < maxCached) {
+      p->next    = cache.head;
+      cache.head = p;
+      cache.num += 1;
+      continue;
+    }
+
+    if (p->socket != socket)
+      cache.stats.crossSocketFrees += 1;
+    SocketPool& pool = *pools.getRemoteByPkg(p->socket);
+    std::lock_guard<substrate::SimpleLock> lg(pool.lock);
+    p->next = pool.head.load(std::memory_order_relaxed);
+    pool.head.store(p, std::memory_order_relaxed);
+  }
+}
+
+void NumaPageArena::unmap(Page* list) {
+  while (list) {
+    Page* p = list;
+    list    = p->next;
+    substrate::freePages(p, 1);
+  }
+}
+
+void NumaPageArena::detach() {
+  ThreadCache& cache = *caches.getLocal();
+  cache.heaps -= 1;
+  if (cache.heaps <= 0) {
+    unmap(cache.head);
+    cache.head = nullptr;
+    cache.num  = 0;
+  }
+
+  if (--liveHeaps == 0) {
+    unsigned numSockets = substrate::getThreadPool().getMaxSockets();
+    for (unsigned i = 0; i < numSockets; ++i) {
+      SocketPool& pool = *pools.getRemoteByPkg(i);
+      std::lock_guard<substrate::SimpleLock> lg(pool.lock);
+      unmap(pool.head.load(std::memory_order_relaxed));
+      pool.head.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+}
+
 #ifndef GALOIS_FORCE_STANDALONE
 thread_local SizedHeapFactory::HeapMap* SizedHeapFactory::localHeaps = 0;
 
@@ -21,6 +21,7 @@
 #include "galois/substrate/SimpleLock.h"
 #include "galois/gIO.h"
 
+#include <cstdint>
 #include <mutex>
 
 #ifdef __linux__
@@ -66,6 +67,38 @@ static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE     = _MAP;
 #endif
 
+/**
+ * Maps size bytes aligned to a huge page and asks for transparent huge
+ * pages, so that pages are still backed by huge pages when none are
+ * reserved for MAP_HUGETLB. Pages are not faulted in, since faulting before
+ * madvise would back them with small pages.
+ */
+static void* trymmapTransparentHuge(size_t size) {
+#ifdef MADV_HUGEPAGE
+  char* raw = static_cast<char*>(trymmap(size + hugePageSize, _MAP));
+  if (!raw)
+    return nullptr;
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+  char* ptr =
+      reinterpret_cast<char*>((base + hugePageSize - 1) & ~(hugePageSize - 1));
+  size_t head = ptr - raw;
+  {
+    std::lock_guard<galois::substrate::SimpleLock> lg(allocLock);
+    if (head)
+      munmap(raw, head);
+    if (hugePageSize - head)
+      munmap(ptr + size, hugePageSize - head);
+  }
+
+  if (madvise(ptr, size, MADV_HUGEPAGE) != 0)
+    galois::gDebug("madvise(MADV_HUGEPAGE) failed");
+  return ptr;
+#else
+  return trymmap(size, _MAP);
+#endif
+}
+
 size_t galois::substrate::allocSize() { return hugePageSize; }
 
 void* galois::substrate::allocPages(unsigned num, bool preFault) {
@@ -90,6 +123,32 @@ void* galois::substrate::allocPages(unsigned num, bool preFault) {
   }
 }
 
+void* galois::substrate::allocTransparentHugePages(unsigned num,
+                                                   bool preFault) {
+  if (num > 0) {
+    void* ptr =
+        trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    bool handMap = preFault && doHandMap;
+    if (!ptr) {
+      gDebug("Huge page alloc failed, falling back to transparent huge pages");
+      ptr     = trymmapTransparentHuge(num * hugePageSize);
+      handMap = preFault;
+    }
+
+    if (!ptr)
+      GALOIS_SYS_DIE("Out of Memory");
+
+    // with transparent huge pages this takes one fault per huge page
+    if (handMap)
+      for (size_t x = 0; x < num * hugePageSize; x += 4096)
+        static_cast<char*>(ptr)[x] = 0;
+
+    return ptr;
+  } else {
+    return nullptr;
+  }
+}
+
 void galois::substrate::freePages(void* ptr, unsigned num) {
   std::lock_guard<SimpleLock> lg(allocLock);
   if (munmap(ptr, num * hugePageSize) != 0)
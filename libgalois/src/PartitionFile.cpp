@@ -0,0 +1,111 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/graphs/PartitionFile.h"
+#include "galois/Galois.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace galois {
+namespace graphs {
+
+//! Largest single pwrite or pread
+static const size_t maxIOSize = size_t(1) << 30;
+
+void writePartitionFile(const std::string& filename, const uint32_t* parts,
+                        uint64_t numNodes) {
+  std::string tmp = filename + ".tmp";
+  int fd          = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed creating ", "'", tmp, "'");
+  if (ftruncate(fd, numNodes * sizeof(uint32_t)) == -1)
+    GALOIS_SYS_DIE("failed writing ", "'", tmp, "'");
+
+  galois::on_each([&](unsigned tid, unsigned total) {
+    auto r = galois::block_range(uint64_t(0), numNodes, tid, total);
+    const char* in = reinterpret_cast<const char*>(parts + r.first);
+    size_t len     = (r.second - r.first) * sizeof(uint32_t);
+    off_t offset   = r.first * sizeof(uint32_t);
+    while (len) {
+      ssize_t w = pwrite(fd, in, std::min(len, maxIOSize), offset);
+      if (w == -1)
+        GALOIS_SYS_DIE("failed writing ", "'", tmp, "'");
+      in += w;
+      offset += w;
+      len -= w;
+    }
+  });
+
+  if (fsync(fd) == -1)
+    GALOIS_SYS_DIE("failed writing ", "'", tmp, "'");
+  if (close(fd) == -1)
+    GALOIS_SYS_DIE("failed writing ", "'", tmp, "'");
+  if (rename(tmp.c_str(), filename.c_str()) == -1)
+    GALOIS_SYS_DIE("failed renaming ", "'", tmp, "' to '", filename, "'");
+}
+
+std::vector<uint32_t> readPartitionFile(const std::string& filename,
+                                        uint64_t numNodes, uint32_t numParts,
+                                        uint64_t begin, uint64_t end) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+  struct stat st;
+  if (fstat(fd, &st) == -1)
+    GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+  if (uint64_t(st.st_size) != numNodes * sizeof(uint32_t))
+    GALOIS_DIE("partition file '", filename, "' has ", st.st_size,
+               " bytes; expected one uint32_t for each of ", numNodes,
+               " nodes");
+  if (begin > end || end > numNodes)
+    GALOIS_DIE("invalid node range [", begin, ", ", end, ")");
+
+  std::vector<uint32_t> parts(end - begin);
+  char* out    = reinterpret_cast<char*>(parts.data());
+  size_t len   = parts.size() * sizeof(uint32_t);
+  off_t offset = begin * sizeof(uint32_t);
+  while (len) {
+    ssize_t r = pread(fd, out, std::min(len, maxIOSize), offset);
+    if (r == -1)
+      GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+    if (r == 0)
+      GALOIS_DIE("partition file '", filename, "' is truncated");
+    out += r;
+    offset += r;
+    len -= r;
+  }
+  close(fd);
+
+  for (size_t i = 0; i < parts.size(); ++i) {
+    if (parts[i] >= numParts)
+      GALOIS_DIE("node ", begin + i, " is in part ", parts[i],
+                 " of a partition into ", numParts, " parts");
+  }
+  return parts;
+}
+
+} // namespace graphs
+} // namespace galois
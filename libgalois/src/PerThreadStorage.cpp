@@ -21,6 +21,10 @@
 
 //#include "galois/runtime/Mem.h"
 #include "galois/gIO.h"
+#include "galois/substrate/CompilerSpecific.h"
+
+#include <algorithm>
+#include <cstdlib>
 #include <mutex>
 
 thread_local char* galois::substrate::ptsBase;
@@ -41,7 +45,8 @@ galois::substrate::PerBackend& galois::substrate::getPPSBackend() {
 #ifdef MORE_MEM_HACK
 const size_t allocSize =
     16 * (2 << 20); // galois::runtime::MM::hugePageSize * 16;
-inline void* alloc() { return malloc(allocSize); }
+// page aligned so that offsets aligned in allocOffset stay aligned
+inline void* alloc() { return aligned_alloc(4096, allocSize); }
 
 #else
 const size_t allocSize = galois::runtime::MM::hugePageSize;
@@ -65,10 +70,24 @@ unsigned galois::substrate::PerBackend::allocOffset(const unsigned sz) {
   unsigned ll     = nextLog2(sz);
   unsigned size   = (1 << ll);
 
-  if ((nextLoc + size) <= allocSize) {
+  // align to the (power of 2) size up to a cache line, so over-aligned types
+  // (e.g., CacheLineStorage) are not touched with misaligned vector stores
+  unsigned align = std::min(size, unsigned(GALOIS_CACHE_LINE_SIZE));
+  unsigned cur   = nextLoc;
+  while (true) {
+    unsigned start = (cur + align - 1) & ~(align - 1);
+    if (start + size > allocSize)
+      break;
     // simple path, where we allocate bump ptr style
-    retval = __sync_fetch_and_add(&nextLoc, size);
-  } else if (!invalid) {
+    unsigned prev = __sync_val_compare_and_swap(&nextLoc, cur, start + size);
+    if (prev == cur) {
+      retval = start;
+      break;
+    }
+    cur = prev;
+  }
+
+  if (retval == allocSize && !invalid) {
     // find a free offset
     std::lock_guard<Lock> llock(freeOffsetsLock);
 
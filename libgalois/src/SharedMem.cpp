@@ -30,7 +30,7 @@ galois::substrate::SharedMem::SharedMem() {
   // delayed initialization because both call getThreadPool in constructor
   // which is valid only after setThreadPool() above
   m_biPtr   = std::make_unique<internal::BarrierInstance<>>();
-  m_termPtr = std::make_unique<internal::LocalTerminationDetection<>>();
+  m_termPtr = internal::createSystemTermination();
 
   internal::setBarrierInstance(m_biPtr.get());
   internal::setTermDetect(m_termPtr.get());
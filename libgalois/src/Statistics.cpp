@@ -19,6 +19,7 @@
 
 #include "galois/runtime/Statistics.h"
 #include "galois/runtime/Executor_OnEach.h"
+#include "galois/runtime/Mem.h"
 
 #include <iostream>
 #include <fstream>
@@ -128,9 +129,21 @@ void galois::runtime::internal::setSysStatManager(
 StatManager* galois::runtime::internal::sysStatManager(void) { return SM; }
 
 void galois::runtime::reportPageAlloc(const char* category) {
+  // only loops with the per_iter_arena trait (or direct ArenaBumpHeap
+  // users) take pages through the arena
+  const bool arenaUsed = NumaPageArena::used();
   galois::runtime::on_each_gen(
-      [category](const unsigned tid, const unsigned numT) {
+      [category, arenaUsed](const unsigned tid, const unsigned numT) {
         reportStat_Tsum("PageAlloc", category, numPagePoolAllocForThread(tid));
+        if (!arenaUsed)
+          return;
+
+        const ArenaStats& arena = NumaPageArena::getInstance()->stats(tid);
+        reportStat_Tsum("ArenaNewPages", category, arena.newPages);
+        reportStat_Tsum("ArenaPageFaults", category, arena.pageFaults);
+        reportStat_Tsum("ArenaSocketPages", category, arena.socketPages);
+        reportStat_Tsum("ArenaCrossSocketFrees", category,
+                        arena.crossSocketFrees);
       },
       std::make_tuple());
 }
@@ -19,6 +19,7 @@
 
 #include "galois/gIO.h"
 #include "galois/substrate/Termination.h"
+#include "galois/substrate/EnvCheck.h"
 
 // vtable anchoring
 galois::substrate::TerminationDetection::~TerminationDetection(void) {}
@@ -36,3 +37,10 @@ galois::substrate::getSystemTermination(unsigned activeThreads) {
   TERM->init(activeThreads);
   return *TERM;
 }
+
+std::unique_ptr<galois::substrate::TerminationDetection>
+galois::substrate::internal::createSystemTermination() {
+  if (EnvCheck("GALOIS_HIERARCHICAL_TERMINATION"))
+    return std::make_unique<HierarchicalTerminationDetection<>>();
+  return std::make_unique<LocalTerminationDetection<>>();
+}
@@ -33,6 +33,7 @@
 #include "galois/runtime/DistStats.h"
 #include "galois/runtime/SyncStructures.h"
 #include "galois/runtime/DataCommMode.h"
+#include "galois/runtime/SyncCompression.h"
 #include "galois/DynamicBitset.h"
 
 #ifdef __GALOIS_HET_CUDA__
@@ -48,6 +49,10 @@ namespace cll = llvm::cl;
 extern cll::opt<bool> partitionAgnostic;
 //! Specifies what format to send metadata in
 extern cll::opt<DataCommMode> enforce_metadata;
+//! Specifies if sync messages are packed when that makes them smaller
+extern cll::opt<bool> compressSync;
+//! Number of ranges the compute of a pipelined round is split into
+extern cll::opt<unsigned> pipelineRanges;
 #ifdef __GALOIS_BARE_MPI_COMMUNICATION__
 //! bare_mpi type to use
 extern cll::opt<BareMPI> bare_mpi;
@@ -115,6 +120,12 @@ private:
   //! @todo pass the flag as function paramater instead
   BITVECTOR_STATUS* currentBVFlag;
 
+  //! Set by pipelinedCompute: the next reduce completes a pipelined round
+  bool pipelineActive;
+  //! Number of hosts whose last reduce message of the pipelined round has
+  //! not arrived yet
+  unsigned pipelinePending;
+
   // memoization optimization
   //! Master nodes on different hosts. For broadcast;
   std::vector<std::vector<size_t>> masterNodes;
@@ -130,6 +141,9 @@ private:
   // Used for efficient comms
   galois::DynamicBitSet syncBitset;
   galois::PODResizeableArray<unsigned int> syncOffsets;
+  //! Packed offsets and values of the message being sent or received
+  galois::PODResizeableArray<uint8_t> syncPackedOffsets;
+  galois::PODResizeableArray<uint8_t> syncPackedValues;
 
   /**
    * Reset a provided bitset given the type of synchronization performed
@@ -414,8 +428,8 @@ public:
       : galois::runtime::GlobalObject(this), userGraph(_userGraph), id(host),
         transposed(_transposed), isVertexCut(userGraph.is_vertex_cut()),
         cartesianGrid(_cartesianGrid), numHosts(numHosts), num_run(0),
-        num_round(0), currentBVFlag(nullptr),
-        mirrorNodes(userGraph.getMirrorNodes()) {
+        num_round(0), currentBVFlag(nullptr), pipelineActive(false),
+        pipelinePending(0), mirrorNodes(userGraph.getMirrorNodes()) {
     if (cartesianGrid.first != 0 && cartesianGrid.second != 0) {
       GALOIS_ASSERT(cartesianGrid.first * cartesianGrid.second == numHosts,
                     "Cartesian split doesn't equal number of hosts");
@@ -571,7 +585,7 @@ private:
                            galois::PODResizeableArray<unsigned int>& offsets,
                            size_t& bit_set_count,
                            DataCommMode& data_mode) const {
-    if (enforce_data_mode != onlyData) {
+    if (enforce_data_mode != onlyData && enforce_data_mode != packedData) {
       bitset_comm.reset();
       std::string syncTypeStr =
           (syncType == syncReduce) ? "Reduce" : "Broadcast";
@@ -715,6 +729,86 @@ private:
     galois::runtime::reportStat_Tsum(RNAME, statSendBytes_str, b.size());
   }
 
+  /**
+   * If -compressSync is set or a packed mode is enforced, packs the offsets
+   * and values of a message into syncPackedOffsets and syncPackedValues and
+   * switches data_mode to the matching packed mode if that makes the
+   * message smaller (or if it is enforced). Values of types that cannot be
+   * packed are sent as they are.
+   *
+   * @tparam syncType either reduce or broadcast; only used to name stats
+   * @tparam VecType type of val_vec
+   *
+   * @param loopName loop name used for stats
+   * @param data_mode INPUT/OUTPUT: the way that the data should be
+   * communicated
+   * @param bit_set_count the number of items we are sending in this message
+   * @param num the number of nodes shared with the receiver
+   * @param offsets contains indices into "indices" of the items we send
+   * @param val_vec contains the data that we are sending
+   *
+   * @returns true if the values are to be sent packed
+   */
+  template <SyncType syncType, typename VecType>
+  bool packMessage(const std::string& loopName, DataCommMode& data_mode,
+                   size_t bit_set_count, size_t num,
+                   const galois::PODResizeableArray<unsigned int>& offsets,
+                   VecType& val_vec) {
+    typedef galois::runtime::ValuePacker<typename VecType::value_type> Packer;
+
+    if (!compressSync && !isPackedMode(enforce_data_mode)) {
+      return false;
+    }
+    bool allValues = (data_mode == onlyData || data_mode == packedData);
+    if (!allValues && data_mode != offsetsData && data_mode != bitsetData &&
+        data_mode != varintOffsetsData) {
+      return false; // noData or gidsData
+    }
+
+    std::string syncTypeStr = (syncType == syncReduce) ? "Reduce" : "Broadcast";
+    std::string pack_timer_str(syncTypeStr + "PackMessage_" +
+                               get_run_identifier(loopName));
+    galois::CondStatTimer<MORE_COMM_STATS> Tpack(pack_timer_str.c_str(),
+                                                 RNAME);
+    Tpack.start();
+
+    size_t count      = allValues ? num : bit_set_count;
+    size_t valueBytes = count * sizeof(typename VecType::value_type);
+    size_t packedValueBytes = valueBytes;
+    bool packValues         = false;
+    if (Packer::packable) {
+      Packer::pack(val_vec.data(), count, syncPackedValues);
+      if (syncPackedValues.size() < valueBytes) {
+        packValues       = true;
+        packedValueBytes = syncPackedValues.size();
+      }
+    }
+
+    size_t rawBytes    = valueBytes;
+    size_t packedBytes = packedValueBytes;
+    if (allValues) {
+      data_mode = packValues ? packedData : onlyData;
+    } else {
+      galois::runtime::packOffsets(offsets.data(), bit_set_count,
+                                   syncPackedOffsets);
+      rawBytes += (data_mode == bitsetData)
+                      ? ((num + 63) / 64) * sizeof(uint64_t) + sizeof(size_t)
+                      : bit_set_count * sizeof(unsigned int);
+      packedBytes += syncPackedOffsets.size() + sizeof(bool);
+      if (packedBytes < rawBytes || enforce_data_mode == varintOffsetsData) {
+        data_mode = varintOffsetsData;
+      }
+    }
+
+    if (isPackedMode(data_mode) && packedBytes < rawBytes) {
+      galois::runtime::reportStat_Tsum(
+          RNAME, syncTypeStr + "PackedBytesSaved_" + get_run_identifier(loopName),
+          rawBytes - packedBytes);
+    }
+    Tpack.stop();
+    return packValues;
+  }
+
   /**
    * Given data to serialize in val_vec, serialize it into the send buffer
    * depending on the mode of data communication selected for the data.
@@ -723,7 +817,8 @@ private:
    * @tparam VecType type of val_vec, which stores the data to send
    *
    * @param loopName loop name used for timers
-   * @param data_mode the way that the data should be communicated
+   * @param data_mode INPUT/OUTPUT: the way that the data should be
+   * communicated; may be changed to a packed mode by packMessage
    * @param bit_set_count the number of items we are sending in this message
    * @param indices list of all nodes that we are potentially interested in
    * sending things to
@@ -733,7 +828,7 @@ private:
    * to
    */
   template <bool async, SyncType syncType, typename VecType>
-  void serializeMessage(std::string loopName, DataCommMode data_mode,
+  void serializeMessage(std::string loopName, DataCommMode& data_mode,
                         size_t bit_set_count, std::vector<size_t>& indices,
                         galois::PODResizeableArray<unsigned int>& offsets,
                         galois::DynamicBitSet& bit_set_comm, VecType& val_vec,
@@ -743,6 +838,8 @@ private:
                                   get_run_identifier(loopName));
     galois::CondStatTimer<MORE_COMM_STATS> Tserialize(serialize_timer_str.c_str(),
                                                     RNAME);
+    bool packedValues = packMessage<syncType>(
+        loopName, data_mode, bit_set_count, indices.size(), offsets, val_vec);
     if (data_mode == noData) {
       if (!async) {
         Tserialize.start();
@@ -767,6 +864,20 @@ private:
       Tserialize.start();
       gSerialize(b, data_mode, bit_set_count, bit_set_comm, val_vec);
       Tserialize.stop();
+    } else if (data_mode == varintOffsetsData) {
+      Tserialize.start();
+      gSerialize(b, data_mode, bit_set_count, syncPackedOffsets, packedValues);
+      if (packedValues) {
+        gSerialize(b, syncPackedValues);
+      } else {
+        val_vec.resize(bit_set_count);
+        gSerialize(b, val_vec);
+      }
+      Tserialize.stop();
+    } else if (data_mode == packedData) {
+      Tserialize.start();
+      gSerialize(b, data_mode, syncPackedValues);
+      Tserialize.stop();
     } else { // onlyData
       Tserialize.start();
       gSerialize(b, data_mode, val_vec);
@@ -782,7 +893,9 @@ private:
    *
    * @param loopName used to name timers for statistics
    * @param data_mode data mode with which the original message was sent;
-   * determines how to deserialize the rest of the message
+   * determines how to deserialize the rest of the message. Packed modes are
+   * unpacked and replaced with the mode they stand for (offsetsData or
+   * onlyData).
    * @param buf buffer which contains the received message to deserialize
    *
    * The rest of the arguments are output arguments (they are passed by
@@ -799,7 +912,7 @@ private:
    * @param val_vec The data proper will be deserialized into this vector
    */
   template <SyncType syncType, typename VecType>
-  void deserializeMessage(std::string loopName, DataCommMode data_mode,
+  void deserializeMessage(std::string loopName, DataCommMode& data_mode,
                        uint32_t num, galois::runtime::RecvBuffer& buf,
                        size_t& bit_set_count,
                        galois::PODResizeableArray<unsigned int>& offsets,
@@ -812,6 +925,32 @@ private:
                                                     RNAME);
     Tdeserialize.start();
 
+    typedef galois::runtime::ValuePacker<typename VecType::value_type> Packer;
+    if (data_mode == varintOffsetsData) {
+      bool packedValues;
+      galois::runtime::gDeserialize(buf, bit_set_count, syncPackedOffsets,
+                                    packedValues);
+      galois::runtime::unpackOffsets(syncPackedOffsets.data(), bit_set_count,
+                                     offsets);
+      if (packedValues) {
+        galois::runtime::gDeserialize(buf, syncPackedValues);
+        val_vec.resize(bit_set_count);
+        Packer::unpack(syncPackedValues.data(), bit_set_count, val_vec.data());
+      } else {
+        galois::runtime::gDeserialize(buf, val_vec);
+      }
+      data_mode = offsetsData;
+      Tdeserialize.stop();
+      return;
+    } else if (data_mode == packedData) {
+      galois::runtime::gDeserialize(buf, syncPackedValues);
+      val_vec.resize(num);
+      Packer::unpack(syncPackedValues.data(), num, val_vec.data());
+      data_mode = onlyData;
+      Tdeserialize.stop();
+      return;
+    }
+
     // get other metadata associated with message if mode isn't OnlyData
     if (data_mode != onlyData) {
       galois::runtime::gDeserialize(buf, bit_set_count);
@@ -1811,6 +1950,12 @@ private:
           from_id, b, bit_set_count, data_mode);
       Textractbatch.stop();
 
+      // GPUs pick their own metadata and cannot pack it
+      if (batch_succeeded && isPackedMode(enforce_data_mode)) {
+        GALOIS_DIE("-metadata=varint and -metadata=packed are only supported "
+                   "on CPUs");
+      }
+
       // GPUs have a batch function they can use; CPUs do not; therefore,
       // CPUS always enter this if block
       if (!batch_succeeded) {
@@ -1829,7 +1974,7 @@ private:
             loopName, indices, bit_set_compute, bit_set_comm, offsets,
             bit_set_count, data_mode);
 
-        if (data_mode == onlyData) {
+        if (data_mode == onlyData || data_mode == packedData) {
           bit_set_count = indices.size();
           extractSubset<SyncFnTy, syncType, VecTy, true, true>(
               loopName, indices, bit_set_count, offsets, val_vec);
@@ -1964,7 +2109,7 @@ private:
         // note the extra template argument which specifies that this is a
         // vector extract, i.e. get element i of the vector (i passed in as
         // argument as well)
-        if (data_mode == onlyData) {
+        if (data_mode == onlyData || data_mode == packedData) {
           // galois::gInfo(id, " node ", i, " has data to send");
           bit_set_count = indices.size();
           extractSubset<SyncFnTy, syncType, VecTy, true, true, true>(
@@ -2158,6 +2303,67 @@ private:
     TSendTime.stop();
   }
 
+  /**
+   * Sends reduce messages of a pipelined round. Partial messages carry the
+   * mirrors updated since the last flush and are only sent if there are any;
+   * the last message of the round is always sent. Each message ends with a
+   * flag that marks the last one.
+   *
+   * @tparam writeLocation Location data is written (src or dst)
+   * @tparam readLocation Location data is read (src or dst)
+   * @tparam SyncFnTy synchronization structure with info needed to synchronize
+   * @tparam BitsetFnTy struct that has info on how to access the bitset
+   *
+   * @param loopName used to name timers for statistics
+   * @param last true if these are the last messages of the round
+   */
+  template <WriteLocation writeLocation, ReadLocation readLocation,
+            typename SyncFnTy, typename BitsetFnTy, typename VecTy>
+  void syncPipelinedSend(std::string loopName, bool last) {
+    static galois::runtime::SendBuffer b;
+
+    auto& net = galois::runtime::getSystemNetworkInterface();
+    size_t numMessages = 0;
+    size_t numBytes    = 0;
+    for (unsigned h = 1; h < numHosts; ++h) {
+      unsigned x = (id + h) % numHosts;
+
+      if (nothingToSend(x, syncReduce, writeLocation, readLocation))
+        continue;
+
+      if (last) {
+        getSendBuffer<syncReduce, SyncFnTy, BitsetFnTy, VecTy, false>(
+            loopName, x, b);
+      } else {
+        getSendBuffer<syncReduce, SyncFnTy, BitsetFnTy, VecTy, true>(
+            loopName, x, b);
+        if (b.size() == 0)
+          continue;
+      }
+      gSerialize(b, last);
+      numBytes += b.size();
+      net.sendTagged(x, galois::runtime::evilPhase, b);
+      ++numMessages;
+    }
+    // partial messages should go out while the next range computes
+    net.flush();
+
+    reset_bitset(syncReduce, &BitsetFnTy::reset_range);
+
+    if (last) {
+      galois::runtime::reportStat_Tsum(
+          RNAME, "ReduceNumMessages_" + get_run_identifier(loopName),
+          numMessages);
+    } else {
+      galois::runtime::reportStat_Tsum(
+          RNAME, "ReducePartialMessages_" + get_run_identifier(loopName),
+          numMessages);
+      galois::runtime::reportStat_Tsum(
+          RNAME, "ReducePartialBytes_" + get_run_identifier(loopName),
+          numBytes);
+    }
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 // Receives
 ////////////////////////////////////////////////////////////////////////////////
@@ -2209,9 +2415,11 @@ private:
 
       if (data_mode != noData) {
         // GPU update call
+        // packed messages are unpacked on the CPU
         Tsetbatch.start();
-        bool batch_succeeded = setBatchWrapper<SyncFnTy, syncType, async>(
-            from_id, buf, data_mode);
+        bool batch_succeeded =
+            !isPackedMode(data_mode) &&
+            setBatchWrapper<SyncFnTy, syncType, async>(from_id, buf, data_mode);
         Tsetbatch.stop();
 
         // cpu always enters this block
@@ -2501,6 +2709,43 @@ private:
     }
   }
 
+  /**
+   * Applies the reduce messages of a pipelined round that have arrived. If
+   * wait is set, keeps receiving until the last message from every host that
+   * sends to this one has arrived.
+   *
+   * @tparam SyncFnTy synchronization structure with info needed to synchronize
+   * @tparam BitsetFnTy struct that has info on how to access the bitset
+   *
+   * @param loopName used to name timers for statistics
+   * @param wait true to wait for the last messages of the round
+   */
+  template <typename SyncFnTy, typename BitsetFnTy, typename VecTy>
+  void syncPipelinedRecv(std::string loopName, bool wait) {
+    auto& net = galois::runtime::getSystemNetworkInterface();
+
+    while (pipelinePending > 0) {
+      auto p = net.recieveTagged(galois::runtime::evilPhase, nullptr);
+      if (!p) {
+        if (!wait)
+          break;
+        continue;
+      }
+
+      galois::runtime::RecvBuffer& buf = p->second;
+      bool last;
+      galois::runtime::gDeserializeRaw(
+          buf.r_linearData() + buf.r_size() - sizeof(bool), last);
+      buf.pop_back(sizeof(bool));
+      if (last) {
+        --pipelinePending;
+      }
+
+      syncRecvApply<syncReduce, SyncFnTy, BitsetFnTy, VecTy, false>(
+          p->first, buf, loopName);
+    }
+  }
+
   /**
    * Receives messages from all other hosts and "applies" the message (reduce
    * or set) based on the sync structure provided.
@@ -2714,10 +2959,23 @@ private:
     switch (bare_mpi) {
     case noBareMPI:
 #endif
-      syncSend<writeLocation, readLocation, syncReduce, ReduceFnTy,
-                BitsetFnTy, VecTy, async>(loopName);
-      syncRecv<writeLocation, readLocation, syncReduce, ReduceFnTy,
-                BitsetFnTy, VecTy, async>(loopName);
+      if (pipelineActive) {
+        // completes the round started by pipelinedCompute
+        syncPipelinedSend<writeLocation, readLocation, ReduceFnTy, BitsetFnTy,
+                          VecTy>(loopName, true);
+        galois::StatTimer Twait(
+            ("PipelinedWait_" + get_run_identifier(loopName)).c_str(), RNAME);
+        Twait.start();
+        syncPipelinedRecv<ReduceFnTy, BitsetFnTy, VecTy>(loopName, true);
+        Twait.stop();
+        incrementEvilPhase();
+        pipelineActive = false;
+      } else {
+        syncSend<writeLocation, readLocation, syncReduce, ReduceFnTy,
+                  BitsetFnTy, VecTy, async>(loopName);
+        syncRecv<writeLocation, readLocation, syncReduce, ReduceFnTy,
+                  BitsetFnTy, VecTy, async>(loopName);
+      }
 #ifdef __GALOIS_BARE_MPI_COMMUNICATION__
       break;
     case nonBlockingBareMPI:
@@ -2998,6 +3256,21 @@ private:
     broadcast<writeAny, readAny, SyncFnTy, BitsetFnTy, async>(loopName);
   }
 
+  /**
+   * Returns true if sync with the given locations does a reduce; must match
+   * the sync_* functions above.
+   */
+  bool syncReduces(WriteLocation writeLocation,
+                   ReadLocation readLocation) const {
+    if (partitionAgnostic || writeLocation == writeAny) {
+      return true;
+    } else if (writeLocation == writeSource) {
+      return transposed || isVertexCut;
+    } else {
+      return !transposed || isVertexCut;
+    }
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 // Public iterface: sync
 ////////////////////////////////////////////////////////////////////////////////
@@ -3057,6 +3330,93 @@ public:
     Tsync.stop();
   }
 
+  /**
+   * Pipelined compute of a bulk-synchronous round: calls compute on
+   * pipelineRanges consecutive ranges of [begin, end), and after each range
+   * sends the mirrors updated so far to their masters and applies the
+   * updates that other hosts have sent so far. This overlaps the reduce
+   * with the rest of the compute. The sync call with the same template
+   * arguments that must follow completes the round.
+   *
+   * Masters may be updated by other hosts between ranges, so the operator
+   * must tolerate seeing updates of the same round (e.g. min reductions of
+   * bfs, cc and sssp). Falls back to a single range when the sync does not
+   * reduce or the bitset cannot be flushed in parts.
+   *
+   * @tparam writeLocation Location data is written (src or dst)
+   * @tparam readLocation Location data is read (src or dst)
+   * @tparam SyncFnTy sync structure for the field
+   * @tparam BitsetFnTy struct that has info on how to access the bitset
+   *
+   * @param loopName used to name timers for statistics; same as for sync
+   * @param begin first node to compute
+   * @param end one past the last node to compute
+   * @param compute called with the begin and end of each range
+   */
+  template <WriteLocation writeLocation, ReadLocation readLocation,
+            typename SyncFnTy, typename BitsetFnTy, typename IterTy,
+            typename ComputeFnTy>
+  void pipelinedCompute(std::string loopName, IterTy begin, IterTy end,
+                        ComputeFnTy compute) {
+    typedef typename SyncFnTy::ValTy T;
+    typedef typename std::conditional<
+        galois::runtime::is_memory_copyable<T>::value,
+        galois::PODResizeableArray<T>,
+        galois::gstl::Vector<T>>::type
+        VecTy;
+
+    galois::StatTimer Tcompute(
+        ("PipelinedCompute_" + get_run_identifier(loopName)).c_str(), RNAME);
+    galois::StatTimer Tflush(
+        ("PipelinedFlush_" + get_run_identifier(loopName)).c_str(), RNAME);
+
+    unsigned numRanges = pipelineRanges;
+    if (!BitsetFnTy::is_valid() || BitsetFnTy::is_vector_bitset() ||
+        partitionAgnostic || !syncReduces(writeLocation, readLocation)) {
+      numRanges = 1;
+    }
+#ifdef __GALOIS_BARE_MPI_COMMUNICATION__
+    if (bare_mpi != noBareMPI) {
+      numRanges = 1;
+    }
+#endif
+    if (numRanges <= 1) {
+      Tcompute.start();
+      compute(begin, end);
+      Tcompute.stop();
+      return;
+    }
+
+    pipelinePending = 0;
+    for (unsigned x = 0; x < numHosts; ++x) {
+      if (x != id &&
+          !nothingToRecv(x, syncReduce, writeLocation, readLocation)) {
+        ++pipelinePending;
+      }
+    }
+    pipelineActive = true;
+
+    size_t size = std::distance(begin, end);
+    for (unsigned r = 0; r < numRanges; ++r) {
+      IterTy rangeBegin = begin;
+      IterTy rangeEnd   = begin;
+      std::advance(rangeBegin, size * r / numRanges);
+      std::advance(rangeEnd, size * (r + 1) / numRanges);
+
+      Tcompute.start();
+      compute(rangeBegin, rangeEnd);
+      Tcompute.stop();
+
+      if (r + 1 < numRanges) {
+        Tflush.start();
+        syncPipelinedSend<writeLocation, readLocation, SyncFnTy, BitsetFnTy,
+                          VecTy>(loopName, false);
+        syncPipelinedRecv<SyncFnTy, BitsetFnTy, VecTy>(loopName, false);
+        Tflush.stop();
+      }
+    }
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 // Sync on demand code (unmaintained, may not work)
 ////////////////////////////////////////////////////////////////////////////////
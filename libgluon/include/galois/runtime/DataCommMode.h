@@ -37,12 +37,22 @@ enum DataCommMode {
   gidsData,
   onlyData,
   dataSplitFirst, // NOT USED
-  dataSplit // NOT USED
+  dataSplit, // NOT USED
+  //! offsets as varint gaps (see SyncCompression.h); values packed if that
+  //! makes them smaller. CPU only.
+  varintOffsetsData,
+  //! all values, packed (see SyncCompression.h). CPU only.
+  packedData
 };
 
 //! If this is set, then always used the data mode it is set to
 extern DataCommMode enforce_data_mode;
 
+//! True for the modes that pack their offsets or values
+inline bool isPackedMode(DataCommMode data_mode) {
+  return data_mode == varintOffsetsData || data_mode == packedData;
+}
+
 /**
  * Given a size of a subset of elements to send and the total number of
  * elements, determine an appropriate data mode to use for sending out the data
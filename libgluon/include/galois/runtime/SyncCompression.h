@@ -0,0 +1,149 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+
+/**
+ * @file SyncCompression.h
+ *
+ * Encodings used by the packed data communication modes (see DataCommMode.h):
+ * increasing offsets are sent as varint gaps, and values are sent as
+ * varints relative to the minimum value (integers) or XORed with the bits
+ * of the previous value (floating point).
+ */
+#pragma once
+
+#include "galois/PODResizeableArray.h"
+#include "galois/Varint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace galois {
+namespace runtime {
+
+/**
+ * Encodes offsets[0, count), which must be increasing, as varint gaps.
+ *
+ * @param out OUTPUT: the encoded bytes
+ */
+inline void packOffsets(const unsigned int* offsets, size_t count,
+                        galois::PODResizeableArray<uint8_t>& out) {
+  out.resize(count * 5);
+  uint8_t* p        = out.data();
+  unsigned int prev = 0;
+  for (size_t i = 0; i < count; ++i) {
+    p    = encodeVarint(p, offsets[i] - prev);
+    prev = offsets[i];
+  }
+  out.resize(p - out.data());
+}
+
+//! Inverse of packOffsets
+inline void unpackOffsets(const uint8_t* in, size_t count,
+                          galois::PODResizeableArray<unsigned int>& offsets) {
+  offsets.resize(count);
+  unsigned int prev = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t gap;
+    in         = decodeVarint(in, gap);
+    prev       = prev + static_cast<unsigned int>(gap);
+    offsets[i] = prev;
+  }
+}
+
+/**
+ * Packs and unpacks values of type T. Types that are neither integers nor
+ * float/double are not packable.
+ */
+template <typename T, typename Enable = void>
+struct ValuePacker {
+  static const bool packable = false;
+  static void pack(const T*, size_t, galois::PODResizeableArray<uint8_t>&) {}
+  static void unpack(const uint8_t*, size_t, T*) {}
+};
+
+//! Frame of reference: the minimum, then each value minus the minimum
+template <typename T>
+struct ValuePacker<T, typename std::enable_if<std::is_integral<T>::value &&
+                                              !std::is_same<T, bool>::value>::type> {
+  typedef typename std::make_unsigned<T>::type U;
+  static const bool packable = true;
+
+  static void pack(const T* values, size_t count,
+                   galois::PODResizeableArray<uint8_t>& out) {
+    U min = count ? static_cast<U>(*std::min_element(values, values + count))
+                  : U(0);
+    out.resize((count + 1) * 10);
+    uint8_t* p = encodeVarint(out.data(), min);
+    for (size_t i = 0; i < count; ++i)
+      p = encodeVarint(p, static_cast<U>(static_cast<U>(values[i]) - min));
+    out.resize(p - out.data());
+  }
+
+  static void unpack(const uint8_t* in, size_t count, T* values) {
+    uint64_t v;
+    in    = decodeVarint(in, v);
+    U min = static_cast<U>(v);
+    for (size_t i = 0; i < count; ++i) {
+      in        = decodeVarint(in, v);
+      values[i] = static_cast<T>(static_cast<U>(min + static_cast<U>(v)));
+    }
+  }
+};
+
+/**
+ * XOR with the previous value: values that are equal or close to the one
+ * before them share their high bits, which leaves a small varint
+ */
+template <typename T>
+struct ValuePacker<T, typename std::enable_if<std::is_floating_point<T>::value &&
+                                              (sizeof(T) == 4 ||
+                                               sizeof(T) == 8)>::type> {
+  typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type
+      Bits;
+  static const bool packable = true;
+
+  static void pack(const T* values, size_t count,
+                   galois::PODResizeableArray<uint8_t>& out) {
+    out.resize(count * 10);
+    uint8_t* p = out.data();
+    Bits prev  = 0;
+    for (size_t i = 0; i < count; ++i) {
+      Bits bits;
+      std::memcpy(&bits, &values[i], sizeof(bits));
+      p    = encodeVarint(p, bits ^ prev);
+      prev = bits;
+    }
+    out.resize(p - out.data());
+  }
+
+  static void unpack(const uint8_t* in, size_t count, T* values) {
+    Bits prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t v;
+      in   = decodeVarint(in, v);
+      prev = prev ^ static_cast<Bits>(v);
+      std::memcpy(&values[i], &prev, sizeof(prev));
+    }
+  }
+};
+
+} // namespace runtime
+} // namespace galois
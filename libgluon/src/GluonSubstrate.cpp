@@ -46,6 +46,12 @@ cll::opt<DataCommMode> enforce_metadata(
                 clEnumValN(onlyData, "none",
                            "Do not use any metadata (sends "
                            "non-updated values)"),
+                clEnumValN(varintOffsetsData, "varint",
+                           "Use offsets metadata encoded as varint gaps "
+                           "always (CPU only)"),
+                clEnumValN(packedData, "packed",
+                           "Do not use any metadata and pack the values "
+                           "(CPU only)"),
                 //clEnumValN(neverOnlyData, "neverOnlyData",
                 //           "Never send onlyData"),
                 clEnumValEnd),
@@ -54,6 +60,20 @@ cll::opt<DataCommMode> enforce_metadata(
 //! the GPU.
 DataCommMode enforce_data_mode;
 
+//! Command line definition for compressSync
+cll::opt<bool>
+    compressSync("compressSync",
+                 cll::desc("Pack offsets and values of sync messages when "
+                           "that makes them smaller (CPU only)"),
+                 cll::init(false), cll::Hidden);
+
+//! Command line definition for pipelineRanges
+cll::opt<unsigned>
+    pipelineRanges("pipelineRanges",
+                   cll::desc("Number of ranges the compute of a pipelined "
+                             "round is split into (default 8)"),
+                   cll::init(8), cll::Hidden);
+
 #ifdef __GALOIS_BARE_MPI_COMMUNICATION__
 //! Command line definition for bare_mpi
 cll::opt<BareMPI> bare_mpi(
@@ -28,6 +28,7 @@ constexpr static const char* const REGION_NAME = "BC";
 #include "galois/graphs/LCGraph.h"
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/BoilerPlate.h"
+#include "MultiSourceBC.h"
 
 // type of the num shortest paths variable
 using ShortPathType = double;
@@ -58,6 +59,12 @@ static cll::opt<unsigned int>
                     cll::desc("Number of sources to use for "
                               "betweeness-centraility (default all)"),
                     cll::init(0));
+static cll::opt<unsigned int>
+    sourcesPerBatch("sourcesPerBatch",
+                    cll::desc("Number of sources whose BFS and backward "
+                              "propagation run together (1 to 64, default "
+                              "1); each source needs 16 bytes per node"),
+                    cll::init(1));
 static cll::opt<bool> verify("verify",
                              cll::desc("Flag to verify (default: false)"),
                              cll::init(false));
@@ -250,6 +257,35 @@ void BackwardBrandes(Graph& graph,
   }
 }
 
+/**
+ * Runs SSSP and backward Brandes for sources sourcesPerBatch at a time, with
+ * the BFS of each batch sharing its edge scans (see MultiSourceBC.h).
+ *
+ * @param graph Graph to compute BC on
+ * @param numSources Number of sources to use
+ * @param sSources Take sources from sourceVector instead of 0 to numSources-1
+ * @param runtimeTimer Timer to run while computing
+ */
+void BatchedBrandes(Graph& graph, uint64_t numSources, bool sSources,
+                    galois::StatTimer& runtimeTimer) {
+  MultiSourceBC<Graph, true> batchBC(graph, sourcesPerBatch);
+  std::vector<GNode> batch;
+
+  for (uint64_t i = 0; i < numSources; i += batch.size()) {
+    batch.clear();
+    for (uint64_t j = i; j < numSources && batch.size() < sourcesPerBatch;
+         ++j) {
+      batch.push_back(sSources ? sourceVector[j] : j);
+    }
+
+    runtimeTimer.start();
+    batchBC.run(batch.data(), batch.size(), [&] (GNode n, double dep) {
+      graph.getData(n).bc += dep;
+    });
+    runtimeTimer.stop();
+  }
+}
+
 /******************************************************************************/
 /* Sanity check */
 /******************************************************************************/
@@ -353,33 +389,43 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (!sourcesPerBatch ||
+      sourcesPerBatch > MultiSourceBC<Graph, true>::MAX_BATCH) {
+    GALOIS_DIE("sourcesPerBatch must be between 1 and ",
+               MultiSourceBC<Graph, true>::MAX_BATCH);
+  }
+
   // graph initialization, then main loop
   InitializeGraph(graph);
 
   galois::gInfo("Beginning main computation");
   galois::StatTimer runtimeTimer;
 
-  // loop over all specified sources for SSSP/Brandes calculation
-  for (uint64_t i = 0; i < loop_end; i++) {
-    if (singleSourceBC) {
-      // only 1 source; specified start source in command line
-      assert(loop_end == 1);
-      galois::gDebug("This is single source node BC");
-      currentSrcNode = startSource;
-    } else if (sSources) {
-      currentSrcNode = sourceVector[i];
-    } else {
-      // all sources
-      currentSrcNode = i;
-    }
+  if (sourcesPerBatch > 1 && !singleSourceBC) {
+    BatchedBrandes(graph, loop_end, sSources, runtimeTimer);
+  } else {
+    // loop over all specified sources for SSSP/Brandes calculation
+    for (uint64_t i = 0; i < loop_end; i++) {
+      if (singleSourceBC) {
+        // only 1 source; specified start source in command line
+        assert(loop_end == 1);
+        galois::gDebug("This is single source node BC");
+        currentSrcNode = startSource;
+      } else if (sSources) {
+        currentSrcNode = sourceVector[i];
+      } else {
+        // all sources
+        currentSrcNode = i;
+      }
 
-    // here begins main computation
-    runtimeTimer.start();
-    InitializeIteration(graph);
-    // worklist; last one will be empty
-    galois::gstl::Vector<WorklistType> worklists = SSSP(graph);
-    BackwardBrandes(graph, worklists);
-    runtimeTimer.stop();
+      // here begins main computation
+      runtimeTimer.start();
+      InitializeIteration(graph);
+      // worklist; last one will be empty
+      galois::gstl::Vector<WorklistType> worklists = SSSP(graph);
+      BackwardBrandes(graph, worklists);
+      runtimeTimer.stop();
+    }
   }
   totalTimer.stop();
   galois::reportPageAlloc("MemAllocPost");
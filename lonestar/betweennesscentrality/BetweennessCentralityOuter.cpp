@@ -22,11 +22,13 @@
 
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/BoilerPlate.h"
+#include "MultiSourceBC.h"
 
 #include <boost/iterator/filter_iterator.hpp>
 
 #include <iomanip>
 #include <fstream>
+#include <memory>
 
 static const char* name = "Betweenness Centrality";
 static const char* desc = "Computes the betweenness centrality of all nodes in "
@@ -48,6 +50,13 @@ static llvm::cl::opt<bool> forceVerify("forceVerify",
                                        llvm::cl::desc("Abort if not verified; "
                                                       "only makes sense for "
                                                       "torus graphs"));
+static llvm::cl::opt<unsigned int>
+    sourcesPerBatch("sourcesPerBatch",
+                    llvm::cl::desc("Number of sources each thread processes "
+                                   "together with a multi-source BFS (1 to "
+                                   "64, default 1); each source needs 16 "
+                                   "bytes per node per thread"),
+                    llvm::cl::init(1));
 static llvm::cl::opt<bool> printAll("printAll",
                                     llvm::cl::desc("Print betweenness values "
                                                    "for all nodes"));
@@ -156,6 +165,40 @@ public:
         galois::steal(), galois::loopname("Main"));
   }
 
+  /**
+   * Runs betweeness-centrality with each thread taking batchSize sources at
+   * a time and processing them together (see MultiSourceBC.h).
+   *
+   * @tparam Cont type of the data structure that holds the nodes to treat
+   * as a source during betweeness-centrality.
+   *
+   * @param v Data structure that holds nodes to treat as a source during
+   * betweeness-centrality
+   * @param batchSize number of sources per batch
+   */
+  template <typename Cont>
+  void runBatched(const Cont& v, unsigned batchSize) {
+    using BatchBC = MultiSourceBC<Graph, false>;
+    // created by the first batch of each thread, from inside the loop
+    galois::substrate::PerThreadStorage<std::unique_ptr<BatchBC>> perThreadBC;
+    size_t numBatches = (v.size() + batchSize - 1) / batchSize;
+
+    galois::do_all(
+        galois::iterate(size_t(0), numBatches),
+        [&](size_t batch) {
+          std::unique_ptr<BatchBC>& batchBC = *perThreadBC.getLocal();
+          if (!batchBC)
+            batchBC.reset(new BatchBC(*G, batchSize));
+
+          size_t first = batch * batchSize;
+          size_t num   = std::min<size_t>(batchSize, v.size() - first);
+          double* Vec  = *CB.getLocal();
+          batchBC->run(&v[first], num,
+                       [&](GNode n, double dep) { Vec[n] += dep; });
+        },
+        galois::steal(), galois::loopname("Main"));
+  }
+
   /**
    * Verification for reference torus graph inputs.
    * All nodes should have the same betweenness value up to
@@ -287,6 +330,12 @@ int main(int argc, char** argv) {
   galois::SharedMemSys Gal;
   LonestarStart(argc, argv, name, desc, url);
 
+  if (!sourcesPerBatch ||
+      sourcesPerBatch > MultiSourceBC<Graph, false>::MAX_BATCH) {
+    GALOIS_DIE("sourcesPerBatch must be between 1 and ",
+               MultiSourceBC<Graph, false>::MAX_BATCH);
+  }
+
   Graph g;
   galois::graphs::readGraph(g, filename);
 
@@ -323,7 +372,10 @@ int main(int argc, char** argv) {
   // execute algorithm
   galois::StatTimer T;
   T.start();
-  bcOuter.run(v);
+  if (sourcesPerBatch > 1)
+    bcOuter.runBatched(v, sourcesPerBatch);
+  else
+    bcOuter.run(v);
   T.stop();
 
   bcOuter.printBCValues(0, std::min(10ul, NumNodes), std::cout, 6);
@@ -0,0 +1,169 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef _BC_MULTI_SOURCE_H_
+#define _BC_MULTI_SOURCE_H_
+
+#include "galois/AtomicHelpers.h"
+#include "galois/LargeArray.h"
+#include "Lonestar/MultiSourceBFS.h"
+
+#include <atomic>
+
+/**
+ * Brandes betweenness centrality for a batch of sources at once. The forward
+ * phase is a multi-source BFS that counts shortest paths per (node, source)
+ * along the DAG edges it reports; the backward phase walks its levels from
+ * the deepest up, so the dependencies of all sources at a level are
+ * propagated in one scan of the edges of the level's nodes.
+ *
+ * Path counts and dependencies take 16 bytes per node per source in the
+ * batch.
+ *
+ * @tparam CONCURRENT run each phase in parallel (true) or serially, for
+ * when each thread processes its own batches
+ */
+template <typename Graph, bool CONCURRENT>
+class MultiSourceBC {
+  using GNode = typename Graph::GraphNode;
+  using BFS   = MultiSourceBFS<Graph, CONCURRENT>;
+  using Lanes = typename BFS::Lanes;
+  using Visit = typename BFS::Visit;
+  using Loop  = typename std::conditional<CONCURRENT, galois::DoAll,
+                                         galois::StdForEach>::type;
+  constexpr static const unsigned CHUNK_SIZE = 64u;
+
+  Graph& graph;
+  BFS bfs;
+  unsigned batch;
+  //! number of shortest paths, [node * batch + lane]
+  galois::LargeArray<std::atomic<double>> sigma;
+  //! dependency, [node * batch + lane]
+  galois::LargeArray<double> delta;
+  //! lanes for which each node is at the level below the one being processed
+  galois::LargeArray<Lanes> below;
+
+  std::atomic<double>& sigmaAt(GNode n, unsigned lane) {
+    return sigma[size_t(n) * batch + lane];
+  }
+  double& deltaAt(GNode n, unsigned lane) {
+    return delta[size_t(n) * batch + lane];
+  }
+
+  void markBelow(size_t d, bool set) {
+    Loop loop;
+    loop(galois::iterate(bfs.level(d)),
+         [&](const Visit& v) {
+           below[v.node] = set ? v.lanes : Lanes::none();
+         },
+         galois::no_stats(), galois::loopname("MultiSourceBC-Mark"));
+  }
+
+public:
+  static constexpr unsigned MAX_BATCH = BFS::LANES;
+
+  //! @param batchSize sources per batch, at most MAX_BATCH
+  MultiSourceBC(Graph& g, unsigned batchSize)
+      : graph(g), bfs(g), batch(batchSize) {
+    BFS::allocate(sigma, graph.size() * batch);
+    BFS::allocate(delta, graph.size() * batch);
+    BFS::allocate(below, graph.size());
+    Loop loop;
+    loop(galois::iterate(size_t(0), graph.size() * batch),
+         [&](size_t i) {
+           sigma.constructAt(i, 0.0);
+           delta[i] = 0;
+         },
+         galois::no_stats(), galois::loopname("MultiSourceBC-Init"));
+    loop(galois::iterate(size_t(0), graph.size()),
+         [&](size_t n) { below[n] = Lanes::none(); },
+         galois::no_stats(), galois::loopname("MultiSourceBC-Init"));
+  }
+
+  unsigned batchSize() const { return batch; }
+
+  /**
+   * Computes the dependencies of every node on sources[0, num), num at most
+   * batchSize(), and calls addBC(node, value) with the sum of the
+   * dependencies of each node that has any; a node is reported at most once
+   * per distance from the sources, so calls for the same node do not race.
+   */
+  template <typename F>
+  void run(const GNode* sources, size_t num, F addBC) {
+    constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+    Loop loop;
+
+    for (size_t i = 0; i < num; ++i)
+      sigmaAt(sources[i], i) = 1;
+
+    bfs.run(sources, num, [&](GNode src, GNode dst, const Lanes& lanes) {
+      lanes.forEach([&](unsigned lane) {
+        double paths = sigmaAt(src, lane).load(std::memory_order_relaxed);
+        if (CONCURRENT) {
+          galois::atomicAdd(sigmaAt(dst, lane), paths);
+        } else {
+          std::atomic<double>& s = sigmaAt(dst, lane);
+          s.store(s.load(std::memory_order_relaxed) + paths,
+                  std::memory_order_relaxed);
+        }
+      });
+    });
+
+    // the deepest level has no successors and the sources no dependency
+    for (size_t d = bfs.numLevels(); d-- > 2;) {
+      markBelow(d, true);
+      loop(galois::iterate(bfs.level(d - 1)),
+           [&](const Visit& v) {
+             for (auto e : graph.edges(v.node, flag)) {
+               GNode dst = graph.getEdgeDst(e);
+               (v.lanes & below[dst]).forEach([&](unsigned lane) {
+                 deltaAt(v.node, lane) +=
+                     (1.0 + deltaAt(dst, lane)) /
+                     sigmaAt(dst, lane).load(std::memory_order_relaxed);
+               });
+             }
+             double sum = 0;
+             v.lanes.forEach([&](unsigned lane) {
+               double& dep = deltaAt(v.node, lane);
+               dep *= sigmaAt(v.node, lane).load(std::memory_order_relaxed);
+               sum += dep;
+             });
+             if (sum != 0)
+               addBC(v.node, sum);
+           },
+           galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+           galois::no_stats(), galois::loopname("MultiSourceBC-Backward"));
+      markBelow(d, false);
+    }
+
+    // clear the entries of the nodes that were reached
+    for (size_t d = 0; d < bfs.numLevels(); ++d) {
+      loop(galois::iterate(bfs.level(d)),
+           [&](const Visit& v) {
+             v.lanes.forEach([&](unsigned lane) {
+               sigmaAt(v.node, lane) = 0;
+               deltaAt(v.node, lane) = 0;
+             });
+           },
+           galois::no_stats(), galois::loopname("MultiSourceBC-Reset"));
+    }
+  }
+};
+
+#endif
@@ -22,6 +22,7 @@
 #include "galois/Reduction.h"
 #include "galois/Timer.h"
 #include "galois/Timer.h"
+#include "galois/DynamicBitset.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/graphs/TypeTraits.h"
 #include "llvm/Support/CommandLine.h"
@@ -29,10 +30,12 @@
 #include "Lonestar/BoilerPlate.h"
 
 #include "Lonestar/BFS_SSSP.h"
+#include "Lonestar/MultiSourceBFS.h"
 
 #include <iostream>
 #include <deque>
 #include <type_traits>
+#include <vector>
 
 namespace cll = llvm::cl;
 
@@ -55,16 +58,49 @@ static cll::opt<unsigned int>
     reportNode("reportNode",
                cll::desc("Node to report distance to (default value 1)"),
                cll::init(1));
+static cll::opt<std::string> transposeGraphName(
+    "graphTranspose",
+    cll::desc("Transpose of the input graph, used by DirOpt (computed in "
+              "memory if not given)"));
+static cll::opt<bool> symmetricGraph(
+    "symmetricGraph",
+    cll::desc("Input graph is symmetric; DirOpt uses it as its own transpose"));
+static cll::opt<unsigned int>
+    alpha("alpha",
+          cll::desc("DirOpt: go bottom-up when frontier edges exceed "
+                    "unexplored edges / alpha (default value 15)"),
+          cll::init(15));
+static cll::opt<unsigned int>
+    beta("beta",
+         cll::desc("DirOpt: go back top-down when the frontier shrinks below "
+                   "nodes / beta (default value 18)"),
+         cll::init(18));
+static cll::opt<unsigned int>
+    numSources("numSources",
+               cll::desc("MultiSource: number of sources, startNode and the "
+                         "nodes after it, searched 64 at a time (default "
+                         "value 64)"),
+               cll::init(64));
 // static cll::opt<unsigned int> stepShiftw("delta",
 // cll::desc("Shift value for the deltastep"),
 // cll::init(10));
 
 enum Exec { SERIAL, PARALLEL };
 
-enum Algo { AsyncTile = 0, Async, SyncTile, Sync, Sync2pTile, Sync2p };
+enum Algo {
+  AsyncTile = 0,
+  Async,
+  SyncTile,
+  Sync,
+  Sync2pTile,
+  Sync2p,
+  DirOpt,
+  MultiSource
+};
 
 const char* const ALGO_NAMES[] = {"AsyncTile", "Async",      "SyncTile",
-                                  "Sync",      "Sync2pTile", "Sync2p"};
+                                  "Sync",      "Sync2pTile", "Sync2p",
+                                  "DirOpt",    "MultiSource"};
 
 static cll::opt<Exec> execution(
     "exec",
@@ -78,7 +114,8 @@ static cll::opt<Algo> algo(
     cll::values(clEnumVal(AsyncTile, "AsyncTile"), clEnumVal(Async, "Async"),
                 clEnumVal(SyncTile, "SyncTile"), clEnumVal(Sync, "Sync"),
                 clEnumVal(Sync2pTile, "Sync2pTile"),
-                clEnumVal(Sync2p, "Sync2p"), clEnumValEnd),
+                clEnumVal(Sync2p, "Sync2p"), clEnumVal(DirOpt, "DirOpt"),
+                clEnumVal(MultiSource, "MultiSource"), clEnumValEnd),
     cll::init(SyncTile));
 
 using Graph =
@@ -355,8 +392,201 @@ void sync2phaseAlgo(Graph& graph, GNode source, const P& pushWrap,
   }
 }
 
+/**
+ * Direction-optimizing BFS (Beamer et al., SC'12). Levels are expanded
+ * top-down from a sparse frontier until the edges leaving the frontier
+ * outnumber the unexplored edges / alpha; then unvisited nodes search their
+ * in-edges (inGraph) for a parent in a dense bitset frontier until the
+ * frontier shrinks below nodes / beta.
+ */
+template <bool CONCURRENT>
+void dirOptAlgo(Graph& graph, Graph& inGraph, GNode source) {
+
+  using Cont = typename std::conditional<CONCURRENT, galois::InsertBag<GNode>,
+                                         galois::SerStack<GNode>>::type;
+  using Loop = typename std::conditional<CONCURRENT, galois::DoAll,
+                                         galois::StdForEach>::type;
+
+  constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+  Loop loop;
+
+  Cont* curr = new Cont();
+  Cont* next = new Cont();
+
+  galois::DynamicBitSet* currBits = new galois::DynamicBitSet();
+  galois::DynamicBitSet* nextBits = new galois::DynamicBitSet();
+  currBits->resize(graph.size());
+  nextBits->resize(graph.size());
+
+  galois::GAccumulator<uint64_t> frontierNodes;
+  galois::GAccumulator<uint64_t> frontierEdges;
+
+  auto degree = [&](GNode n) -> uint64_t {
+    return std::distance(graph.edge_begin(n, flag), graph.edge_end(n, flag));
+  };
+
+  Dist nextLevel              = 0u;
+  graph.getData(source, flag) = 0u;
+  next->push(source);
+
+  uint64_t frontierSize = 1;
+  uint64_t scoutCount   = degree(source);
+  uint64_t edgesToCheck = graph.sizeEdges();
+
+  size_t topDownSteps  = 0;
+  size_t bottomUpSteps = 0;
+
+  while (frontierSize) {
+
+    if (scoutCount > edgesToCheck / alpha) {
+      // sparse frontier -> dense frontier
+      currBits->reset();
+      loop(galois::iterate(*next), [&](GNode n) { currBits->set(n); },
+           galois::loopname("DirOpt-ToBitset"));
+
+      uint64_t oldFrontierSize;
+      do {
+        oldFrontierSize = frontierSize;
+        ++nextLevel;
+        ++bottomUpSteps;
+        frontierNodes.reset();
+        nextBits->reset();
+
+        loop(galois::iterate(graph),
+             [&](GNode n) {
+               auto& ndata = graph.getData(n, flag);
+               if (ndata != BFS::DIST_INFINITY) {
+                 return;
+               }
+               for (auto e : inGraph.edges(n, flag)) {
+                 if (currBits->test(inGraph.getEdgeDst(e))) {
+                   ndata = nextLevel;
+                   nextBits->set(n);
+                   frontierNodes += 1;
+                   break;
+                 }
+               }
+             },
+             galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+             galois::loopname("DirOpt-BottomUp"));
+
+        std::swap(currBits, nextBits);
+        frontierSize = frontierNodes.reduce();
+      } while (frontierSize && (frontierSize >= oldFrontierSize ||
+                                frontierSize > graph.size() / beta));
+
+      // dense frontier -> sparse frontier
+      next->clear();
+      loop(galois::iterate(graph),
+           [&](GNode n) {
+             if (currBits->test(n)) {
+               next->push(n);
+             }
+           },
+           galois::loopname("DirOpt-ToQueue"));
+
+      scoutCount = 1;
+    } else {
+      edgesToCheck -= std::min(scoutCount, edgesToCheck);
+
+      std::swap(curr, next);
+      next->clear();
+      ++nextLevel;
+      ++topDownSteps;
+      frontierNodes.reset();
+      frontierEdges.reset();
+
+      loop(galois::iterate(*curr),
+           [&](GNode src) {
+             for (auto e : graph.edges(src, flag)) {
+               auto dst      = graph.getEdgeDst(e);
+               auto& dstData = graph.getData(dst, flag);
+
+               if (dstData == BFS::DIST_INFINITY &&
+                   (!CONCURRENT ||
+                    __sync_bool_compare_and_swap(&dstData, BFS::DIST_INFINITY,
+                                                 nextLevel))) {
+                 if (!CONCURRENT) {
+                   dstData = nextLevel;
+                 }
+                 next->push(dst);
+                 frontierNodes += 1;
+                 frontierEdges += degree(dst);
+               }
+             }
+           },
+           galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+           galois::loopname("DirOpt-TopDown"));
+
+      frontierSize = frontierNodes.reduce();
+      scoutCount   = frontierEdges.reduce();
+    }
+  }
+
+  galois::runtime::reportStat_Single("BFS", "TopDownSteps", topDownSteps);
+  galois::runtime::reportStat_Single("BFS", "BottomUpSteps", bottomUpSteps);
+
+  delete curr;
+  delete next;
+  delete currBits;
+  delete nextBits;
+}
+
+/**
+ * BFS from numSources sources, 64 at a time with a bit-lane multi-source BFS
+ * that scans each edge once per level for all sources of a batch. The
+ * distances from the first source (startNode) are stored in the graph; for
+ * all sources, the number of reached (source, node) pairs and the sum of
+ * their distances are reported.
+ */
 template <bool CONCURRENT>
-void runAlgo(Graph& graph, const GNode& source) {
+void msBfsAlgo(Graph& graph, GNode source) {
+  using MSBFS = MultiSourceBFS<Graph, CONCURRENT>;
+  using Visit = typename MSBFS::Visit;
+  using Loop  = typename std::conditional<CONCURRENT, galois::DoAll,
+                                         galois::StdForEach>::type;
+
+  Loop loop;
+  MSBFS msBfs(graph);
+  size_t total = std::min<size_t>(numSources, graph.size());
+  galois::GAccumulator<uint64_t> visits;
+  galois::GAccumulator<uint64_t> distanceSum;
+  std::vector<GNode> sources;
+
+  for (size_t first = 0; first < total; first += MSBFS::LANES) {
+    sources.clear();
+    for (size_t i = first; i < std::min<size_t>(total, first + MSBFS::LANES);
+         ++i) {
+      sources.push_back((source + i) % graph.size());
+    }
+
+    msBfs.run(sources.data(), sources.size(),
+              [](GNode, GNode, const typename MSBFS::Lanes&) {});
+
+    for (size_t d = 0; d < msBfs.numLevels(); ++d) {
+      loop(galois::iterate(msBfs.level(d)),
+           [&](const Visit& v) {
+             unsigned count = v.lanes.count();
+             visits += count;
+             distanceSum += d * count;
+             // lane 0 of the first batch is the source given to the app
+             if (!first && v.lanes.test(0))
+               graph.getData(v.node) = d;
+           },
+           galois::no_stats(), galois::loopname("MultiSource-Distances"));
+    }
+  }
+
+  galois::runtime::reportStat_Single("BFS", "MultiSourceSources", total);
+  galois::runtime::reportStat_Single("BFS", "MultiSourceVisits",
+                                     visits.reduce());
+  galois::runtime::reportStat_Single("BFS", "MultiSourceDistanceSum",
+                                     distanceSum.reduce());
+}
+
+template <bool CONCURRENT>
+void runAlgo(Graph& graph, Graph& inGraph, const GNode& source) {
 
   switch (algo) {
   case AsyncTile:
@@ -383,6 +613,12 @@ void runAlgo(Graph& graph, const GNode& source) {
     sync2phaseAlgo<CONCURRENT>(graph, source, OneTilePushWrap{graph},
                                TileRangeFn());
     break;
+  case DirOpt:
+    dirOptAlgo<CONCURRENT>(graph, inGraph, source);
+    break;
+  case MultiSource:
+    msBfsAlgo<CONCURRENT>(graph, source);
+    break;
   default:
     std::cerr << "ERROR: unkown algo type" << std::endl;
   }
@@ -400,6 +636,21 @@ int main(int argc, char** argv) {
   std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
             << " edges" << std::endl;
 
+  // DirOpt's bottom-up steps walk in-edges
+  Graph transposeGraph;
+  Graph* inGraph = &graph;
+  if (algo == DirOpt && !symmetricGraph) {
+    if (transposeGraphName.empty()) {
+      galois::graphs::readGraph(transposeGraph, filename);
+      transposeGraph.transpose("BFS");
+    } else {
+      std::cout << "Reading transpose from file: " << transposeGraphName
+                << std::endl;
+      galois::graphs::readGraph(transposeGraph, transposeGraphName);
+    }
+    inGraph = &transposeGraph;
+  }
+
   if (startNode >= graph.size() || reportNode >= graph.size()) {
     std::cerr << "failed to set report: " << reportNode
               << " or failed to set source: " << startNode << "\n";
@@ -407,6 +658,10 @@ int main(int argc, char** argv) {
     abort();
   }
 
+  if (algo == MultiSource && !numSources) {
+    GALOIS_DIE("numSources must be positive");
+  }
+
   auto it = graph.begin();
   std::advance(it, startNode);
   source = *it;
@@ -434,9 +689,9 @@ int main(int argc, char** argv) {
   Tmain.start();
 
   if (execution == SERIAL) {
-    runAlgo<false>(graph, source);
+    runAlgo<false>(graph, *inGraph, source);
   } else if (execution == PARALLEL) {
-    runAlgo<true>(graph, source);
+    runAlgo<true>(graph, *inGraph, source);
   } else {
     std::cerr << "ERROR: unknown type of execution passed to -exec"
               << std::endl;
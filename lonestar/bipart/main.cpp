@@ -37,6 +37,7 @@
 //#include "GraphReader.h"
 #include "Lonestar/BoilerPlate.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/PartitionFile.h"
 #include "galois/LargeArray.h"
 
 namespace cll = llvm::cl;
@@ -64,6 +65,10 @@ static cll::opt<bool>
             cll::init(false));
 static cll::opt<std::string> outfile("output",
                                      cll::desc("output partition file name"));
+static cll::opt<std::string> partitionFile(
+    "partitionFile",
+    cll::desc("output binary partition file name (one uint32 per node, "
+              "readable by the CuSP file partitioning policy)"));
 static cll::opt<std::string>
     orderedfile("ordered", cll::desc("output ordered graph file name"));
 static cll::opt<std::string>
@@ -278,6 +283,18 @@ int main(int argc, char** argv) {
   std::cout<<"Total Edge Cut: "<<computingCut(graph)<<"\n";
   galois::runtime::reportStat_Single("HyPar", "Edge Cut", computingCut(graph));
   galois::runtime::reportStat_Single("HyParzo", "zero-one", computingBalance(graph));
+
+  if (partitionFile != "") {
+    // node i of the input is the cell hnets[i]
+    std::vector<uint32_t> parts(nodes);
+    galois::do_all(galois::iterate(0, nodes),
+                   [&](int i) {
+                     parts[i] = graph.getData(hnets.at(i)).getPart();
+                   },
+                   galois::loopname("collectParts"));
+    galois::graphs::writePartitionFile(partitionFile, parts.data(),
+                                       parts.size());
+  }
   // galois::reportPageAlloc("MeminfoPost");
 
   return 0;
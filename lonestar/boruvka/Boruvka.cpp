@@ -45,6 +45,7 @@ static const char* desc = "Computes the minimum spanning forest of a graph";
 static const char* url  = "mst";
 
 enum Algo { parallel, exp_parallel };
+enum Scheduler { doall, obim, multiQueue };
 
 static cll::opt<std::string>
     inputFilename(cll::Positional, cll::desc("<input file>"), cll::Required);
@@ -60,6 +61,16 @@ static cll::opt<Algo>
 #endif
                      clEnumValEnd),
          cll::init(parallel));
+static cll::opt<Scheduler> scheduler(
+    "scheduler",
+    cll::desc("Scheduler for the Merge and Find loops of the parallel algorithm "
+              "(default value doall):"),
+    cll::values(clEnumVal(doall, "Unordered do_all"),
+                clEnumVal(obim, "for_each ordered by edge weight with OBIM"),
+                clEnumVal(multiQueue,
+                          "for_each ordered by edge weight with a MultiQueue"),
+                clEnumValEnd),
+    cll::init(doall));
 
 typedef int EdgeData;
 
@@ -101,6 +112,12 @@ struct ParallelAlgo {
 
   typedef galois::InsertBag<WorkItem> WL;
 
+  struct WeightIndexer {
+    EdgeData operator()(const WorkItem& item) const {
+      return *item.edge.weight;
+    }
+  };
+
   Graph graph;
 
   WL wls[3];
@@ -239,10 +256,44 @@ struct ParallelAlgo {
     limit          = delta;
   }
 
-  void process() {
+  static constexpr unsigned CHUNK_SIZE = 16;
 
-    constexpr unsigned CHUNK_SIZE = 16;
+  /**
+   * Apply fn to every item of current. Merge and Find are correct in any
+   * order; the priority schedulers only change which merges win in a round.
+   */
+  template <typename Fn>
+  void processCurrent(const Fn& fn, const char* loopname) {
+    namespace gwl = galois::worklists;
+    using OBIM =
+        gwl::OrderedByIntegerMetric<WeightIndexer,
+                                    gwl::PerSocketChunkFIFO<CHUNK_SIZE>>;
+    using MQ = gwl::MultiQueue<WeightIndexer>;
+
+    auto op = [&fn](const WorkItem& item, auto&) { fn(item); };
+
+    switch (scheduler) {
+    case doall:
+      galois::do_all(galois::iterate(*current), fn, galois::steal(),
+                     galois::chunk_size<CHUNK_SIZE>(),
+                     galois::loopname(loopname));
+      break;
+    case obim:
+      galois::for_each(galois::iterate(*current), op, galois::wl<OBIM>(),
+                       galois::no_conflicts(), galois::no_pushes(),
+                       galois::loopname(loopname));
+      break;
+    case multiQueue:
+      galois::for_each(galois::iterate(*current), op, galois::wl<MQ>(),
+                       galois::no_conflicts(), galois::no_pushes(),
+                       galois::loopname(loopname));
+      break;
+    default:
+      GALOIS_DIE("unknown scheduler");
+    }
+  }
 
+  void process() {
     size_t rounds = 0;
 
     init();
@@ -256,12 +307,8 @@ struct ParallelAlgo {
         rounds += 1;
 
         std::swap(current, next);
-        galois::do_all(galois::iterate(*current), Merge(this), galois::steal(),
-                       galois::chunk_size<CHUNK_SIZE>(),
-                       galois::loopname("Merge"));
-        galois::do_all(galois::iterate(*current), Find(this), galois::steal(),
-                       galois::chunk_size<CHUNK_SIZE>(),
-                       galois::loopname("Find"));
+        processCurrent(Merge(this), "Merge");
+        processCurrent(Find(this), "Find");
         current->clear();
 
         if (next->empty())
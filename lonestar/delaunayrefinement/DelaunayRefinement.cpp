@@ -53,6 +53,12 @@ static cll::opt<DetAlgo> detAlgo(
                 clEnumVal(detDisjoint, "Disjoint execution"), clEnumValEnd),
     cll::init(nondet));
 
+static cll::opt<bool>
+    useChaseLev("useChaseLev",
+                cll::desc("Use the work-stealing ChaseLevLIFO worklist instead "
+                          "of PerThreadChunkLIFO (nondet only)"),
+                cll::init(false));
+
 template <typename WL, int Version = detBase>
 void refine(galois::InsertBag<GNode>& initialBad, Graph& graph) {
 
@@ -96,7 +102,7 @@ void refine(galois::InsertBag<GNode>& initialBad, Graph& graph) {
           cav.update(item, ctx);
         }
       },
-      galois::loopname("refine"), galois::wl<WL>(), galois::per_iter_alloc(),
+      galois::loopname("refine"), galois::wl<WL>(), galois::per_iter_arena(),
       galois::local_state<LocalState>());
 
   //! [for_each example]
@@ -172,10 +178,14 @@ int main(int argc, char** argv) {
 
   typedef Deterministic<> DWL;
   typedef PerThreadChunkLIFO<32> Chunk;
+  typedef ChaseLevLIFO<> ChaseLev;
 
   switch (detAlgo) {
   case nondet:
-    refine<Chunk>(initialBad, graph);
+    if (useChaseLev)
+      refine<ChaseLev>(initialBad, graph);
+    else
+      refine<Chunk>(initialBad, graph);
     break;
   case detBase:
     refine<DWL>(initialBad, graph);
@@ -20,6 +20,7 @@
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
 #include "galois/Bag.h"
+#include "galois/Intersection.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/ParallelSTL.h"
@@ -115,7 +116,7 @@ void getNeighbors(DAGNode &n, std::vector<DAGNode> &neighbors, DAG &dag) {
 }
 
 /**
- * Gives the intersection two neighbor vector. It requires the vectors be sorted according to the node ids.
+ * Gives the intersection two neighbor vector. It requires the vectors be sorted (by address, as std::sort orders DAGNodes).
  *
  * \param jointNeighbors is the output neighbor vector
  * \param srcNeighbors is the first input neighbor vector
@@ -123,23 +124,12 @@ void getNeighbors(DAGNode &n, std::vector<DAGNode> &neighbors, DAG &dag) {
  */
 
 size_t intersect(std::vector<DAGNode> &jointNeighbors, std::vector<DAGNode> &srcNeighbors, std::vector<DAGNode> &dstNeighbors) {
-  std::vector<DAGNode>::iterator srcItr= srcNeighbors.begin();
-  std::vector<DAGNode>::iterator dstItr= dstNeighbors.begin();
-  size_t size=0;
-
-  while (srcItr != srcNeighbors.end() && dstItr != dstNeighbors.end()) {
-    if (*srcItr < *dstItr) {
-    	++srcItr;
-    } else if (*dstItr < *srcItr) {
-    	++dstItr;
-    } else {
-    	jointNeighbors[size] = (*srcItr);
-    	size++;
-		++srcItr;
-    	++dstItr;
-    }
-  }
-  return size;
+  // neighbors are sorted by address, so intersect them as integers
+  static_assert(sizeof(DAGNode) == sizeof(uint64_t), "DAGNode is not a pointer");
+  return galois::intersection::intersect(
+      reinterpret_cast<const uint64_t*>(srcNeighbors.data()), srcNeighbors.size(),
+      reinterpret_cast<const uint64_t*>(dstNeighbors.data()), dstNeighbors.size(),
+      reinterpret_cast<uint64_t*>(jointNeighbors.data()));
 }
 
 /**
@@ -384,6 +374,7 @@ void compute_kcliques(unsigned int k, DAG& dag) {
 						TIntersect.start();
 						size_t tmp_neighborsize=intersect(tmpNeighbors, srcNeighbors, w.neighbors);
 						TIntersect.stop();
+						tmpNeighbors.resize(tmp_neighborsize);
 
 						nextItem.neighbors.resize(tmp_neighborsize);
 
@@ -34,6 +34,7 @@
 //#include "GraphReader.h"
 #include "Lonestar/BoilerPlate.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/PartitionFile.h"
 #include "galois/LargeArray.h"
 
 namespace cll = llvm::cl;
@@ -67,6 +68,10 @@ static cll::opt<bool>
             cll::init(false));
 static cll::opt<std::string> outfile("output",
                                      cll::desc("output partition file name"));
+static cll::opt<std::string> partitionFile(
+    "partitionFile",
+    cll::desc("output binary partition file name (one uint32 per node, "
+              "readable by the CuSP file partitioning policy)"));
 static cll::opt<std::string>
     orderedfile("ordered", cll::desc("output ordered graph file name"));
 static cll::opt<std::string>
@@ -222,6 +227,16 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (partitionFile != "") {
+    // nodes iterate in the order of the input file
+    std::vector<uint32_t> parts;
+    parts.reserve(std::distance(graph.begin(), graph.end()));
+    for (auto n : graph)
+      parts.push_back(graph.getData(n).getPart());
+    galois::graphs::writePartitionFile(partitionFile, parts.data(),
+                                       parts.size());
+  }
+
   if (orderedfile != "" || permutationfile != "") {
     galois::graphs::FileGraph g;
     g.fromFile(filename);
@@ -0,0 +1,275 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef LONESTAR_MULTI_SOURCE_BFS_H
+#define LONESTAR_MULTI_SOURCE_BFS_H
+
+#include "galois/Bag.h"
+#include "galois/DynamicBitset.h"
+#include "galois/Galois.h"
+#include "galois/LargeArray.h"
+#include "galois/gstl.h"
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Set of BFS lanes (sources of a multi-source BFS) as a fixed size bitmask.
+ */
+template <unsigned WORDS>
+struct LaneSet {
+  static constexpr unsigned LANES = 64 * WORDS;
+
+  uint64_t words[WORDS];
+
+  static LaneSet none() {
+    LaneSet s;
+    for (unsigned i = 0; i < WORDS; ++i)
+      s.words[i] = 0;
+    return s;
+  }
+
+  bool any() const {
+    for (unsigned i = 0; i < WORDS; ++i)
+      if (words[i])
+        return true;
+    return false;
+  }
+
+  unsigned count() const {
+    unsigned c = 0;
+    for (unsigned i = 0; i < WORDS; ++i)
+      c += __builtin_popcountll(words[i]);
+    return c;
+  }
+
+  bool test(unsigned lane) const { return (words[lane / 64] >> (lane % 64)) & 1; }
+  void set(unsigned lane) { words[lane / 64] |= uint64_t(1) << (lane % 64); }
+
+  //! this & ~other
+  LaneSet minus(const LaneSet& other) const {
+    LaneSet s;
+    for (unsigned i = 0; i < WORDS; ++i)
+      s.words[i] = words[i] & ~other.words[i];
+    return s;
+  }
+
+  LaneSet operator&(const LaneSet& other) const {
+    LaneSet s;
+    for (unsigned i = 0; i < WORDS; ++i)
+      s.words[i] = words[i] & other.words[i];
+    return s;
+  }
+
+  LaneSet& operator|=(const LaneSet& other) {
+    for (unsigned i = 0; i < WORDS; ++i)
+      words[i] |= other.words[i];
+    return *this;
+  }
+
+  //! Calls f(lane) for every lane in the set, in increasing order
+  template <typename F>
+  void forEach(F f) const {
+    for (unsigned i = 0; i < WORDS; ++i) {
+      for (uint64_t w = words[i]; w; w &= w - 1) {
+        f(i * 64 + __builtin_ctzll(w));
+      }
+    }
+  }
+};
+
+/**
+ * Multi-source BFS (Then et al., VLDB'14). Up to LANES breadth-first
+ * searches run together, one per bit of a per-node lane mask: a frontier
+ * entry carries the set of sources that reach the node at the current level,
+ * so each edge is scanned once per level for all of them instead of once per
+ * source. The nodes at each distance are kept per level with their lane
+ * masks, which is what Brandes-style backward passes walk.
+ *
+ * @tparam CONCURRENT run levels with do_all (true) or serially, e.g., when
+ * each thread runs its own searches
+ * @tparam WORDS lanes are 64 * WORDS
+ */
+template <typename Graph, bool CONCURRENT = true, unsigned WORDS = 1>
+class MultiSourceBFS {
+public:
+  using GNode = typename Graph::GraphNode;
+  using Lanes = LaneSet<WORDS>;
+  static constexpr unsigned LANES = Lanes::LANES;
+
+  //! A node and the lanes for which it is at a given distance
+  struct Visit {
+    GNode node;
+    Lanes lanes;
+  };
+  using Level = galois::InsertBag<Visit>;
+
+private:
+  using Loop = typename std::conditional<CONCURRENT, galois::DoAll,
+                                         galois::StdForEach>::type;
+  constexpr static const unsigned CHUNK_SIZE = 64u;
+
+  Graph& graph;
+  //! lanes that have reached each node so far
+  galois::LargeArray<Lanes> seen;
+  //! lanes that reach each node at the next level
+  galois::LargeArray<Lanes> next;
+  //! nodes in touched; only used when CONCURRENT, as a serial search can
+  //! tell from next whether a node is already listed
+  galois::DynamicBitSet queued;
+  //! nodes with a nonzero next, each listed once
+  galois::InsertBag<GNode> touched;
+  //! a deque, as relocating a bag destroys the moved from one on all threads
+  galois::gstl::Deque<Level> levels;
+  size_t depth;
+
+  //! next[n] |= lanes, listing n in touched if it is not yet
+  void addNext(GNode n, const Lanes& lanes) {
+    if (!CONCURRENT) {
+      if (!next[n].any())
+        touched.push(n);
+      next[n] |= lanes;
+      return;
+    }
+    for (unsigned i = 0; i < WORDS; ++i) {
+      if (lanes.words[i])
+        __sync_fetch_and_or(&next[n].words[i], lanes.words[i]);
+    }
+    if (!queued.test(n) && !queued.set(n))
+      touched.push(n);
+  }
+
+  //! InsertBag::clear runs on all threads, so not from inside a parallel loop
+  template <typename Bag>
+  static void clearBag(Bag& bag) {
+    if (CONCURRENT)
+      bag.clear();
+    else
+      bag.clear_serial();
+  }
+
+  Level& levelAt(size_t d) {
+    if (levels.size() <= d)
+      levels.emplace_back();
+    return levels[d];
+  }
+
+  //! Moves the nodes in touched into level d
+  void collect(size_t d) {
+    Level& level = levelAt(d);
+    Loop loop;
+    loop(galois::iterate(touched),
+         [&](GNode n) {
+           Lanes lanes = next[n];
+           next[n]     = Lanes::none();
+           if (CONCURRENT)
+             queued.reset(n);
+           seen[n] |= lanes;
+           level.push(Visit{n, lanes});
+         },
+         galois::no_stats(), galois::loopname("MultiSourceBFS-Collect"));
+    clearBag(touched);
+  }
+
+public:
+  //! Interleaves the pages of a when CONCURRENT; otherwise the calling
+  //! thread, which may be inside a parallel loop, faults them all in
+  template <typename T>
+  static void allocate(galois::LargeArray<T>& a, size_t n) {
+    if (CONCURRENT)
+      a.allocateInterleaved(n);
+    else
+      a.allocateLocal(n);
+  }
+
+  explicit MultiSourceBFS(Graph& g) : graph(g), depth(0) {
+    allocate(seen, graph.size());
+    allocate(next, graph.size());
+    // resizing clears the bits in parallel
+    if (CONCURRENT)
+      queued.resize(graph.size());
+    Loop loop;
+    loop(galois::iterate(size_t(0), graph.size()),
+         [&](size_t n) {
+           seen[n] = Lanes::none();
+           next[n] = Lanes::none();
+         },
+         galois::no_stats(), galois::loopname("MultiSourceBFS-Init"));
+  }
+
+  /**
+   * Runs a BFS from sources[i] in lane i for i < num. Calls
+   * onEdge(src, dst, lanes) for every edge that reaches dst for the first
+   * time, with lanes the sources for which it does; these are the edges of
+   * the shortest path DAGs of the sources, and src is final for those lanes
+   * when the call is made. Calls may be concurrent.
+   */
+  template <typename F>
+  void run(const GNode* sources, size_t num, F onEdge) {
+    assert(num <= LANES);
+    constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+
+    for (size_t d = 0; d < depth; ++d)
+      clearBag(levels[d]);
+
+    for (size_t i = 0; i < num; ++i) {
+      Lanes lane = Lanes::none();
+      lane.set(i);
+      addNext(sources[i], lane);
+    }
+    collect(0);
+    depth = 1;
+
+    Loop loop;
+    while (!levels[depth - 1].empty()) {
+      loop(galois::iterate(levels[depth - 1]),
+           [&](const Visit& v) {
+             for (auto e : graph.edges(v.node, flag)) {
+               GNode dst   = graph.getEdgeDst(e);
+               Lanes fresh = v.lanes.minus(seen[dst]);
+               if (!fresh.any())
+                 continue;
+               onEdge(v.node, dst, fresh);
+               addNext(dst, fresh);
+             }
+           },
+           galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+           galois::no_stats(), galois::loopname("MultiSourceBFS"));
+      collect(depth++);
+    }
+    // the last level is empty
+    --depth;
+
+    // leave seen all clear for the next run
+    for (size_t d = 0; d < depth; ++d) {
+      loop(galois::iterate(levels[d]),
+           [&](const Visit& v) { seen[v.node] = Lanes::none(); },
+           galois::no_stats(), galois::loopname("MultiSourceBFS-Reset"));
+    }
+  }
+
+  //! Number of nonempty levels of the last run; level 0 holds the sources
+  size_t numLevels() const { return depth; }
+
+  //! Nodes at distance d from some source of the last run
+  Level& level(size_t d) { return levels[d]; }
+};
+
+#endif
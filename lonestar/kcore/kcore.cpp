@@ -21,10 +21,15 @@
 #include "galois/gstl.h"
 #include "galois/Reduction.h"
 #include "galois/AtomicHelpers.h"
+#include "galois/LargeArray.h"
 #include "galois/graphs/LCGraph.h"
 #include "Lonestar/BoilerPlate.h"
 #include "llvm/Support/CommandLine.h"
 
+#include <fstream>
+#include <limits>
+#include <vector>
+
 constexpr static const char* const REGION_NAME = "k-core";
 
 /******************************************************************************/
@@ -32,23 +37,31 @@ constexpr static const char* const REGION_NAME = "k-core";
 /******************************************************************************/
 namespace cll = llvm::cl;
 
-enum Algo { Async = 0, Sync };
+enum Algo { Async = 0, Sync, Decomposition };
 
 //! Input file: should be symmetric graph
 static cll::opt<std::string> inputFilename(cll::Positional,
                                           cll::desc("<input file (symmetric)>"),
                                           cll::Required);
 
-//! Choose algorithm: worklist vs. sync
+//! Choose algorithm: worklist vs. sync vs. full decomposition
 static cll::opt<Algo> algo("algo",
     cll::desc("Choose an algorithm (default Sync):"),
     cll::values(clEnumVal(Async, "Asynchronous"), clEnumVal(Sync, "Synchronous"),
+                clEnumVal(Decomposition, "Bucketed peeling computing the "
+                                         "coreness of every node"),
                 clEnumValEnd),
     cll::init(Sync));
 
-//! Required k specification for k-core
-static cll::opt<unsigned int> k_core_num("kcore", cll::desc("k-core value"),
-                                         cll::Required);
+//! k specification for k-core; required unless computing the decomposition
+static cll::opt<unsigned int> k_core_num("kcore",
+    cll::desc("k-core value (optional with -algo=Decomposition)"),
+    cll::init(0));
+
+//! Output file for the coreness of every node (Decomposition only)
+static cll::opt<std::string> outName("o",
+    cll::desc("output file for the coreness of every node "
+              "(-algo=Decomposition)"));
 
 //! Flag that forces user to be aware that they should be passing in a
 //! symmetric graph
@@ -61,7 +74,7 @@ static cll::opt<bool> symmetricGraph("symmetricGraph",
 /* Graph structure declarations + other inits */
 /******************************************************************************/
 // Node deadness can be derived from current degree and k value, so no field
-// necessary
+// necessary. The decomposition leaves the coreness of a node in its degree.
 struct NodeData {
   std::atomic<uint32_t> currentDegree;
 };
@@ -75,6 +88,13 @@ using GNode = Graph::GraphNode;
 //! Chunksize for for_each worklist: best chunksize will depend on input
 constexpr static const unsigned CHUNK_SIZE = 64u;
 
+//! Number of degree buckets the decomposition keeps open at once; nodes of
+//! higher degree wait in a single overflow bucket until the window reaches
+//! them
+constexpr static const uint32_t BUCKET_WINDOW = 128u;
+//! Stamp of a node whose coreness is final
+constexpr static const uint32_t PEELED = std::numeric_limits<uint32_t>::max();
+
 /******************************************************************************/
 /* Functions for running the algorithm */
 /******************************************************************************/
@@ -195,6 +215,232 @@ void asyncCascadeKCore(Graph& graph, galois::InsertBag<GNode>& initialWorklist)
   );
 }
 
+/**
+ * Buckets of nodes keyed by current degree for the decomposition. Only the
+ * degrees [base, base + BUCKET_WINDOW) have their own bucket. Entries are
+ * not removed when a node's degree changes; a node is instead inserted again
+ * into its new bucket and the old entry becomes stale, so an entry is only
+ * valid if the node is unpeeled and its degree still matches the bucket.
+ *
+ * Invariant: every unpeeled node with degree below limit() has a valid
+ * entry in its bucket, and every other unpeeled node is in the overflow
+ * bucket.
+ *
+ * The buckets also keep a stamp per node: the last sub-round the node was
+ * moved in, or PEELED.
+ */
+class DegreeBuckets {
+  Graph& graph;
+  galois::LargeArray<std::atomic<uint32_t>> stamps;
+  std::vector<galois::InsertBag<GNode>> open;
+  galois::InsertBag<GNode>* overflow;
+  galois::InsertBag<GNode>* nextOverflow;
+  uint32_t base;
+
+public:
+  explicit DegreeBuckets(Graph& g)
+      : graph(g), open(BUCKET_WINDOW), overflow(new galois::InsertBag<GNode>),
+        nextOverflow(new galois::InsertBag<GNode>), base(0) {
+    stamps.allocateInterleaved(graph.size());
+    galois::do_all(
+      galois::iterate(graph.begin(), graph.end()),
+      [&] (GNode curNode) {
+        stamps.constructAt(curNode, 0u);
+        insert(curNode, graph.getData(curNode).currentDegree);
+      },
+      galois::loopname("DecompositionBucketing"),
+      galois::no_stats()
+    );
+  }
+
+  ~DegreeBuckets() {
+    delete overflow;
+    delete nextOverflow;
+  }
+
+  uint32_t limit() const { return base + BUCKET_WINDOW; }
+
+  std::atomic<uint32_t>& stamp(GNode node) { return stamps[node]; }
+
+  //! Adds node to bucket degree, which must lie in the window
+  void insert(GNode node, uint32_t degree) {
+    if (degree < limit()) {
+      open[degree - base].emplace(node);
+    } else {
+      overflow->emplace(node);
+    }
+  }
+
+  /**
+   * Moves the valid entries of bucket k, k in the window, into frontier and
+   * marks those nodes as peeled. The bucket is left empty.
+   */
+  void extract(uint32_t k, galois::InsertBag<GNode>& frontier) {
+    galois::InsertBag<GNode>& bucket = open[k - base];
+    if (bucket.empty()) {
+      return;
+    }
+    galois::do_all(
+      galois::iterate(bucket),
+      [&] (GNode node) {
+        // the exchange drops duplicate entries of the same node
+        if (graph.getData(node).currentDegree == k &&
+            stamp(node).exchange(PEELED) != PEELED) {
+          frontier.emplace(node);
+        }
+      },
+      galois::loopname("DecompositionExtract"),
+      galois::no_stats()
+    );
+    bucket.clear();
+  }
+
+  /**
+   * Slides the window to start at the lowest degree of an unpeeled node in
+   * the overflow bucket and distributes the overflow bucket over it. Returns
+   * false if no unpeeled node is left.
+   */
+  bool refill() {
+    galois::GReduceMin<uint32_t> minDegree;
+    galois::do_all(
+      galois::iterate(*overflow),
+      [&] (GNode node) {
+        if (stamp(node) != PEELED) {
+          minDegree.update(graph.getData(node).currentDegree);
+        }
+      },
+      galois::loopname("DecompositionRefillMin"),
+      galois::no_stats()
+    );
+    if (minDegree.reduce() == std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+
+    base = minDegree.reduce();
+    nextOverflow->clear();
+    galois::do_all(
+      galois::iterate(*overflow),
+      [&] (GNode node) {
+        if (stamp(node) == PEELED) {
+          return;
+        }
+        uint32_t degree = graph.getData(node).currentDegree;
+        if (degree < limit()) {
+          open[degree - base].emplace(node);
+        } else {
+          nextOverflow->emplace(node);
+        }
+      },
+      galois::loopname("DecompositionRefill"),
+      galois::no_stats()
+    );
+    std::swap(overflow, nextOverflow);
+    return true;
+  }
+};
+
+/**
+ * Decrements the degree of a node unless it is already at most k; degrees of
+ * nodes that are not peeled yet never fall below the level being peeled.
+ *
+ * @returns true if the degree was decremented
+ */
+bool decrementAbove(std::atomic<uint32_t>& degree, uint32_t k) {
+  uint32_t old = degree.load(std::memory_order_relaxed);
+  while (old > k) {
+    if (degree.compare_exchange_weak(old, old - 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Full core decomposition by bucketed peeling. Levels k are visited in
+ * increasing order; at each level the nodes whose degree is k are peeled
+ * together, which decrements the degrees of their unpeeled neighbors (never
+ * below k). The decrements of a sub-round are batched: a node whose degree
+ * changed is rebucketed once at the end of the sub-round, using its final
+ * degree, no matter how many of its neighbors were peeled. Nodes that reach
+ * k form the next frontier of the same level. When done, the degree of every
+ * node is its coreness.
+ *
+ * @param graph Graph to operate on; degrees must be initialized
+ */
+void bucketedDecomposition(Graph& graph) {
+  DegreeBuckets buckets(graph);
+  galois::InsertBag<GNode>* frontier = new galois::InsertBag<GNode>;
+  galois::InsertBag<GNode>* next = new galois::InsertBag<GNode>;
+  galois::InsertBag<GNode> moved;
+
+  uint32_t subRound = 0;
+  uint32_t levels = 0;
+  uint32_t k = 0;
+
+  while (true) {
+    if (k == buckets.limit() && !buckets.refill()) {
+      break;
+    }
+    // skip levels with no nodes left; refill moves k past empty degrees too
+    k = std::max(k, buckets.limit() - BUCKET_WINDOW);
+    buckets.extract(k, *frontier);
+
+    if (!frontier->empty()) {
+      ++levels;
+    }
+
+    while (!frontier->empty()) {
+      ++subRound;
+      moved.clear();
+
+      galois::do_all(
+        galois::iterate(*frontier),
+        [&] (GNode peeledNode) {
+          for (auto e : graph.edges(peeledNode)) {
+            GNode dest = graph.getEdgeDst(e);
+            NodeData& destData = graph.getData(dest);
+            // nodes still in the overflow bucket need no rebucketing
+            if (decrementAbove(destData.currentDegree, k) &&
+                destData.currentDegree < buckets.limit() &&
+                buckets.stamp(dest).exchange(subRound) != subRound) {
+              moved.emplace(dest);
+            }
+          }
+        },
+        galois::steal(),
+        galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("DecompositionPeel")
+      );
+
+      next->clear();
+      galois::do_all(
+        galois::iterate(moved),
+        [&] (GNode node) {
+          uint32_t degree = graph.getData(node).currentDegree;
+          if (degree == k) {
+            buckets.stamp(node) = PEELED;
+            next->emplace(node);
+          } else {
+            buckets.insert(node, degree);
+          }
+        },
+        galois::loopname("DecompositionRebucket"),
+        galois::no_stats()
+      );
+      std::swap(frontier, next);
+    }
+
+    ++k;
+  }
+
+  galois::runtime::reportStat_Single(REGION_NAME, "PeelingLevels", levels);
+  galois::runtime::reportStat_Single(REGION_NAME, "PeelingSubRounds",
+                                     subRound);
+
+  delete frontier;
+  delete next;
+}
+
 /******************************************************************************/
 /* Sanity check operators */
 /******************************************************************************/
@@ -223,6 +469,63 @@ void kCoreSanity(Graph& graph) {
                  aliveNodes.reduce(), "\n");
 }
 
+/**
+ * Check that the degrees left by the decomposition are a core decomposition:
+ * a node of coreness c has at least c neighbors of coreness at least c (so
+ * the nodes of coreness at least c form a c-core), but fewer than c + 1
+ * neighbors of coreness greater than c (otherwise it would belong to the
+ * (c + 1)-core). Prints the largest coreness.
+ *
+ * @param graph Graph to check
+ * @returns true if every node satisfies both conditions
+ */
+bool decompositionSanity(Graph& graph) {
+  galois::GAccumulator<uint32_t> badNodes;
+  galois::GReduceMax<uint32_t> maxCoreness;
+
+  galois::do_all(
+    galois::iterate(graph.begin(), graph.end()),
+    [&] (GNode curNode) {
+      uint32_t coreness = graph.getData(curNode).currentDegree;
+      uint32_t atLeast = 0;
+      uint32_t above = 0;
+      for (auto e : graph.edges(curNode)) {
+        uint32_t other = graph.getData(graph.getEdgeDst(e)).currentDegree;
+        atLeast += other >= coreness;
+        above += other > coreness;
+      }
+      if (atLeast < coreness || above > coreness) {
+        badNodes += 1;
+      }
+      maxCoreness.update(coreness);
+    },
+    galois::loopname("DecompositionSanityCheck"),
+    galois::no_stats()
+  );
+
+  galois::gPrint("Maximum coreness is ", maxCoreness.reduce(), "\n");
+  if (badNodes.reduce()) {
+    galois::gPrint(badNodes.reduce(), " nodes have an inconsistent coreness\n");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Write "node coreness" lines for every node.
+ *
+ * @param graph Graph holding the decomposition
+ */
+void printCoreness(Graph& graph) {
+  std::ofstream of(outName);
+  if (!of.is_open()) {
+    GALOIS_DIE("cannot open ", outName, " for output");
+  }
+  for (GNode n : graph) {
+    of << n << " " << graph.getData(n).currentDegree << "\n";
+  }
+}
+
 /******************************************************************************/
 /* Main method for running */
 /******************************************************************************/
@@ -242,6 +545,10 @@ int main(int argc, char** argv) {
                "aware this program needs to be passed a symmetric graph.");
   }
 
+  if (algo != Decomposition && !k_core_num) {
+    GALOIS_DIE("-kcore is required unless computing the decomposition");
+  }
+
   // some initial stat reporting
   galois::gInfo("Worklist chunk size of ", CHUNK_SIZE, ": best size may depend"
                 " on input.");
@@ -290,6 +597,9 @@ int main(int argc, char** argv) {
                   k_core_num);
     // synchronous k-core
     syncCascadeKCore(graph);
+  } else if (algo == Decomposition) {
+    galois::gInfo("Running bucketed k-core decomposition");
+    bucketedDecomposition(graph);
   } else {
     GALOIS_DIE("Invalid specification of k-core algorithm");
   }
@@ -301,7 +611,16 @@ int main(int argc, char** argv) {
 
   // sanity check
   if (!skipVerify) {
-    kCoreSanity(graph);
+    if (algo == Decomposition && !decompositionSanity(graph)) {
+      GALOIS_DIE("Verification failed");
+    }
+    if (k_core_num) {
+      kCoreSanity(graph);
+    }
+  }
+
+  if (algo == Decomposition && !outName.empty()) {
+    printCoreness(graph);
   }
 
   return 0;
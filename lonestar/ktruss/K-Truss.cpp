@@ -20,6 +20,8 @@
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
 #include "galois/Bag.h"
+#include "galois/Intersection.h"
+#include "galois/substrate/PerThreadStorage.h"
 #include "galois/Timer.h"
 #include "galois/Timer.h"
 #include "galois/graphs/Graph.h"
@@ -28,10 +30,10 @@
 #include "Lonestar/BoilerPlate.h"
 
 #include <iostream>
-#include <deque>
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <vector>
 
 enum Algo {
   bspJacobi,
@@ -153,43 +155,71 @@ void reportKTruss(Graph& g) {
   }
 }
 
-template <typename G>
-bool isSupportNoLessThanJ(G& g, typename G::GraphNode src,
-                          typename G::GraphNode dst, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI            = g.edge_begin(src, galois::MethodFlag::UNPROTECTED),
-       srcE            = g.edge_end(src, galois::MethodFlag::UNPROTECTED),
-       dstI            = g.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
-       dstE            = g.edge_end(dst, galois::MethodFlag::UNPROTECTED);
-
-  while (true) {
-    // find the first valid edge
-    while (srcI != srcE && (g.getEdgeData(srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.getEdgeData(dstI) & removed)) {
-      ++dstI;
-    }
+//! Positions of common neighbors found by one thread, reused across edges
+struct CommonNeighborScratch {
+  std::vector<uint32_t> srcPos, dstPos;
+};
+typedef galois::substrate::PerThreadStorage<CommonNeighborScratch> Scratch;
 
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
+//! Source neighbors intersected at a time, so that a scan can stop early
+static const size_t commonNeighborChunk = 256;
 
-    // check for intersection
-    auto sN = g.getEdgeDst(srcI), dN = g.getEdgeDst(dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
+/**
+ * Calls f(w) for every common neighbor w of the nodes whose edges are
+ * [srcI, srcE) and [dstI, dstE) such that neither edge to w is removed,
+ * until f returns false. Edges must be sorted by destination.
+ */
+template <typename G, typename F>
+void forValidCommonNeighbors(G& g, CommonNeighborScratch& scratch,
+                             typename G::edge_iterator srcI,
+                             typename G::edge_iterator srcE,
+                             typename G::edge_iterator dstI,
+                             typename G::edge_iterator dstE, F f) {
+  size_t numSrc = srcE - srcI, numDst = dstE - dstI;
+  size_t maxCommon = std::min({numSrc, numDst, commonNeighborChunk});
+  if (scratch.srcPos.size() < maxCommon) {
+    scratch.srcPos.resize(maxCommon);
+    scratch.dstPos.resize(maxCommon);
+  }
+
+  auto* srcDst  = g.getEdgeDstPtr(srcI);
+  auto* dstDst  = g.getEdgeDstPtr(dstI);
+  auto* srcData = g.getEdgeDataPtr(srcI);
+  auto* dstData = g.getEdgeDataPtr(dstI);
+  // a chunk of src neighbors can only match dst neighbors up to its last one
+  for (size_t s = 0, d = 0; s < numSrc && d < numDst;) {
+    size_t sEnd = std::min(numSrc, s + commonNeighborChunk);
+    size_t dEnd =
+        std::upper_bound(dstDst + d, dstDst + numDst, srcDst[sEnd - 1]) -
+        dstDst;
+    size_t num = galois::intersection::intersectPositions(
+        srcDst + s, sEnd - s, dstDst + d, dEnd - d, scratch.srcPos.data(),
+        scratch.dstPos.data());
+    for (size_t i = 0; i < num; ++i) {
+      size_t sp = s + scratch.srcPos[i], dp = d + scratch.dstPos[i];
+      if ((srcData[sp] & removed) || (dstData[dp] & removed))
+        continue;
+      if (!f(srcDst[sp]))
+        return;
     }
+    s = sEnd;
+    d = dEnd;
   }
+}
+
+template <typename G>
+bool isSupportNoLessThanJ(G& g, Scratch& scratch, typename G::GraphNode src,
+                          typename G::GraphNode dst, unsigned int j) {
+  size_t numValidEqual = 0;
+  if (j == 0)
+    return true;
+  forValidCommonNeighbors(
+      g, *scratch.getLocal(),
+      g.edge_begin(src, galois::MethodFlag::UNPROTECTED),
+      g.edge_end(src, galois::MethodFlag::UNPROTECTED),
+      g.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
+      g.edge_end(dst, galois::MethodFlag::UNPROTECTED),
+      [&](typename G::GraphNode) { return ++numValidEqual < j; });
   return numValidEqual >= j;
 }
 
@@ -210,17 +240,22 @@ struct BSPTrussJacobiAlgo {
 
   std::string name() { return "bsp"; }
 
+  Scratch scratch;
+
   struct PickUnsupportedEdges {
     Graph& g;
+    Scratch& scratch;
     unsigned int j;
     EdgeVec& r;
     EdgeVec& s;
 
-    PickUnsupportedEdges(Graph& g, unsigned int j, EdgeVec& r, EdgeVec& s)
-        : g(g), j(j), r(r), s(s) {}
+    PickUnsupportedEdges(Graph& g, Scratch& scratch, unsigned int j,
+                         EdgeVec& r, EdgeVec& s)
+        : g(g), scratch(scratch), j(j), r(r), s(s) {}
 
     void operator()(Edge e) {
-      EdgeVec& w = isSupportNoLessThanJ(g, e.first, e.second, j) ? s : r;
+      EdgeVec& w =
+          isSupportNoLessThanJ(g, scratch, e.first, e.second, j) ? s : r;
       w.push_back(e);
     }
   };
@@ -248,7 +283,7 @@ struct BSPTrussJacobiAlgo {
                    galois::steal());
 
     while (true) {
-      galois::do_all(galois::iterate(*cur), PickUnsupportedEdges{g, k - 2, unsupported, *next},
+      galois::do_all(galois::iterate(*cur), PickUnsupportedEdges{g, scratch, k - 2, unsupported, *next},
                      galois::steal());
 
       if (0 == std::distance(unsupported.begin(), unsupported.end())) {
@@ -288,16 +323,19 @@ struct BSPTrussAlgo {
 
   std::string name() { return "bsp"; }
 
+  Scratch scratch;
+
   struct KeepSupportedEdges {
     Graph& g;
+    Scratch& scratch;
     unsigned int j;
     EdgeVec& s;
 
-    KeepSupportedEdges(Graph& g, unsigned int j, EdgeVec& s)
-        : g(g), j(j), s(s) {}
+    KeepSupportedEdges(Graph& g, Scratch& scratch, unsigned int j, EdgeVec& s)
+        : g(g), scratch(scratch), j(j), s(s) {}
 
     void operator()(Edge e) {
-      if (isSupportNoLessThanJ(g, e.first, e.second, j)) {
+      if (isSupportNoLessThanJ(g, scratch, e.first, e.second, j)) {
         s.push_back(e);
       } else {
         g.getEdgeData(g.findEdgeSortedByDst(e.first, e.second)) = removed;
@@ -332,7 +370,7 @@ struct BSPTrussAlgo {
 
     // remove unsupported edges until no more edges can be removed
     while (true) {
-      galois::do_all(galois::iterate(*cur), KeepSupportedEdges{g, k - 2, *next},
+      galois::do_all(galois::iterate(*cur), KeepSupportedEdges{g, scratch, k - 2, *next},
                      galois::steal());
       nextSize = std::distance(next->begin(), next->end());
 
@@ -451,48 +489,6 @@ struct BSPCoreThenTrussAlgo {
   } // end operator()
 };  // end struct BSPCoreThenTrussAlgo
 
-template <typename T>
-using PerIterAlloc = typename galois::PerIterAllocTy::rebind<T>::other;
-
-template <typename G>
-std::deque<typename G::GraphNode, PerIterAlloc<typename G::GraphNode>>
-getValidCommonNeighbors(G& g, typename G::GraphNode src,
-                        typename G::GraphNode dst, galois::PerIterAllocTy& a,
-                        galois::MethodFlag flag = galois::MethodFlag::WRITE) {
-  using GNode = typename G::GraphNode;
-
-  auto srcI = g.edge_begin(src, flag), srcE = g.edge_end(src, flag),
-       dstI = g.edge_begin(dst, flag), dstE = g.edge_end(dst, flag);
-  std::deque<GNode, PerIterAlloc<GNode>> commonNeighbors(a);
-
-  while (true) {
-    // find the first valid edge
-    while (srcI != srcE && (g.getEdgeData(srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.getEdgeData(dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      break;
-    }
-
-    // check for intersection
-    auto sN = g.getEdgeDst(srcI), dN = g.getEdgeDst(dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      commonNeighbors.push_back(sN);
-      ++srcI;
-      ++dstI;
-    }
-  }
-  return commonNeighbors;
-}
-
 template <typename Algo>
 void run() {
   Algo algo;
@@ -33,8 +33,8 @@
 #include <type_traits>
 
 #include "Lonestar/BoilerPlate.h"
-#include "louvainClustering.h"
 #include "galois/DynamicBitset.h"
+#include "louvainClustering.h"
 
 namespace cll = llvm::cl;
 
@@ -69,6 +69,11 @@ static cll::opt<bool> enable_VF("enable_VF",
   cll::desc("Flag to enable vertex following optimization."),
   cll::init(false));
 
+static cll::opt<bool> enable_pruning("enable_pruning",
+  cll::desc("Flag to revisit only nodes whose neighborhood changed community "
+            "in the previous iteration of the local-move phase."),
+  cll::init(false));
+
 static cll::opt<double> c_threshold("c_threshold",
   cll::desc("Threshold for modularity gain"),
   cll::init(0.01));
@@ -130,6 +135,9 @@ double algoLouvainWithLocking(Graph &graph, double lower, double threshold, uint
 
   /* Compute the total weight (2m) and 1/2m terms */
   constant_for_second_term = calConstantForSecondTerm(graph);
+
+  ActiveNodes active_nodes;
+  active_nodes.init(graph, enable_pruning);
   galois::gPrint("constant_for_second_term : ", constant_for_second_term, "\n");
 
   galois::gPrint("========================================================================================================\n");
@@ -140,6 +148,7 @@ double algoLouvainWithLocking(Graph &graph, double lower, double threshold, uint
   TimerClusteringWhile.start();
   while(true) {
     num_iter++;
+    active_nodes.startIteration(graph);
 
   galois::do_all(galois::iterate(graph),
                 [&](GNode n) {
@@ -149,6 +158,8 @@ double algoLouvainWithLocking(Graph &graph, double lower, double threshold, uint
 
   galois::for_each(galois::iterate(graph),
                 [&](GNode n, auto& ctx) {
+                    if(!active_nodes.isActive(n))
+                      return;
 
                     auto& n_data = graph.getData(n, flag_write_lock);
                     uint64_t degree = std::distance(graph.edge_begin(n, flag_write_lock),
@@ -274,6 +285,7 @@ double algoLouvainWithLocking(Graph &graph, double lower, double threshold, uint
     }
 
     prev_mod = curr_mod;
+    active_nodes.finishIteration(graph);
 
   }// End while
   TimerClusteringWhile.stop();
@@ -329,6 +341,9 @@ double algoLouvainWithoutLockingDoAll(Graph &graph, double lower, double thresho
 
   /* Compute the total weight (2m) and 1/2m terms */
   constant_for_second_term = calConstantForSecondTerm(graph);
+
+  ActiveNodes active_nodes;
+  active_nodes.init(graph, enable_pruning);
   galois::gPrint("constant_for_second_term : ", constant_for_second_term, "\n");
 
   galois::gPrint("========================================================================================================\n");
@@ -339,6 +354,7 @@ double algoLouvainWithoutLockingDoAll(Graph &graph, double lower, double thresho
   TimerClusteringWhile.start();
   while(true) {
     num_iter++;
+    active_nodes.startIteration(graph);
 
   galois::do_all(galois::iterate(graph),
                 [&](GNode n) {
@@ -349,6 +365,8 @@ double algoLouvainWithoutLockingDoAll(Graph &graph, double lower, double thresho
 
   galois::do_all(galois::iterate(graph),
                 [&](GNode n) {
+                    if(!active_nodes.isActive(n))
+                      return;
                     auto& n_data = graph.getData(n, flag_write_lock);
                     uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                                      graph.edge_end(n,  flag_no_lock));
@@ -444,6 +462,7 @@ double algoLouvainWithoutLockingDoAll(Graph &graph, double lower, double thresho
     }
 
     prev_mod = curr_mod;
+    active_nodes.finishIteration(graph);
 
   }// End while
   TimerClusteringWhile.stop();
@@ -500,6 +519,9 @@ double algoLouvainWithLockingDelayUpdate(Graph &graph, double lower, double thre
 
   /* Compute the total weight (2m) and 1/2m terms */
   constant_for_second_term = calConstantForSecondTerm(graph);
+
+  ActiveNodes active_nodes;
+  active_nodes.init(graph, enable_pruning);
   galois::gPrint("constant_for_second_term : ", constant_for_second_term, "\n");
 
   galois::gPrint("========================================================================================================\n");
@@ -510,6 +532,7 @@ double algoLouvainWithLockingDelayUpdate(Graph &graph, double lower, double thre
   TimerClusteringWhile.start();
   while(true) {
     num_iter++;
+    active_nodes.startIteration(graph);
 
   galois::do_all(galois::iterate(graph),
                 [&](GNode n) {
@@ -521,6 +544,10 @@ double algoLouvainWithLockingDelayUpdate(Graph &graph, double lower, double thre
   galois::GAccumulator<uint32_t> syncRound;
   galois::do_all(galois::iterate(graph),
                 [&](GNode n) {
+                    if(!active_nodes.isActive(n)) {
+                      local_target[n] = graph.getData(n, flag_no_lock).curr_comm_ass;
+                      return;
+                    }
 
                     auto& n_data = graph.getData(n, flag_write_lock);
                     uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
@@ -626,6 +653,7 @@ double algoLouvainWithLockingDelayUpdate(Graph &graph, double lower, double thre
                      c_update[n].size = 0;
                      c_update[n].degree_wt = 0;
                    });
+     active_nodes.finishIteration(graph);
 
 
   }// End while
@@ -768,6 +796,9 @@ double algoLouvainWithColoring(Graph &graph, double lower, double threshold, uin
 
   /* Compute the total weight (2m) and 1/2m terms */
   constant_for_second_term = calConstantForSecondTerm(graph);
+
+  ActiveNodes active_nodes;
+  active_nodes.init(graph, enable_pruning);
   galois::gPrint("constant_for_second_term : ", constant_for_second_term, "\n");
 
   galois::gPrint("========================================================================================================\n");
@@ -784,6 +815,7 @@ double algoLouvainWithColoring(Graph &graph, double lower, double threshold, uin
   TimerClusteringWhile.start();
   while(true) {
     num_iter++;
+    active_nodes.startIteration(graph);
 
     for(int64_t c = 0; c < num_colors; ++c) {
         //galois::gPrint("Color : ", c, "\n");
@@ -791,7 +823,7 @@ double algoLouvainWithColoring(Graph &graph, double lower, double threshold, uin
                   [&](GNode n) {
 
                       auto& n_data = graph.getData(n, flag_write_lock);
-                      if(n_data.colorId == c){
+                      if(n_data.colorId == c && active_nodes.isActive(n)){
                         uint64_t degree = std::distance(graph.edge_begin(n, flag_no_lock),
                                                          graph.edge_end(n,  flag_no_lock));
                         //TODO: Can we make it infinity??
@@ -888,6 +920,7 @@ double algoLouvainWithColoring(Graph &graph, double lower, double threshold, uin
     }
 
     prev_mod = curr_mod;
+    active_nodes.finishIteration(graph);
 
   }// End while
   TimerClusteringWhile.stop();
@@ -905,6 +938,14 @@ double algoLouvainWithColoring(Graph &graph, double lower, double threshold, uin
 }
 
 
+/*
+ * Builds the graph of the communities of graph: one node per community and
+ * one edge per pair of adjacent communities, weighted by the total weight of
+ * the edges between them. Every step is a parallel loop: the nodes are
+ * grouped by community with a counting sort, each community's edges are
+ * merged in a per-thread hash map once to count and once to write them, and
+ * the edge offsets come from a prefix sum. graph_next may be graph itself.
+ */
 void buildNextLevelGraph(Graph& graph, Graph& graph_next, uint64_t num_unique_clusters) {
   std::cerr << "Inside buildNextLevelGraph\n";
 
@@ -913,97 +954,114 @@ void buildNextLevelGraph(Graph& graph, Graph& graph_next, uint64_t num_unique_cl
   uint32_t num_nodes_next = num_unique_clusters;
   uint64_t num_edges_next = 0; //Unknown right now
 
+  /* Group the nodes of each cluster together (counting sort) */
+  galois::StatTimer TimerClusterBags("Timer_Cluster_Bags");
+  TimerClusterBags.start();
+  largeArray cluster_begin; // First member of each cluster in members
+  largeArray members;
+  galois::LargeArray<std::atomic<uint64_t>> cursor;
+  cluster_begin.allocateBlocked(num_nodes_next + 1);
+  members.allocateBlocked(graph.size());
+  cursor.allocateBlocked(num_nodes_next);
+
+  galois::do_all(galois::iterate((uint64_t)0, (uint64_t)num_nodes_next),
+                [&](uint64_t c) {
+                  cursor.constructAt(c, 0);
+                }, galois::no_stats());
 
-  //galois::LargeArray<galois::InsertBag<uint64_t>> cluster_bags;
-  //cluster_bags.allocateBlocked(num_unique_clusters);
-  //std::vector<galois::InsertBag<uint64_t>> cluster_bags(num_unique_clusters);
-  std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-#if 0
   galois::do_all(galois::iterate(graph),
                 [&](GNode n) {
-                    auto n_data = graph.getData(n, flag_no_lock);
-                    cluster_bags[n_data.curr_comm_ass].push_back(n);
-                },
-                galois::loopname("Cluster Bags"),
-                galois::steal());
-#endif
+                  uint64_t c = graph.getData(n, flag_no_lock).curr_comm_ass;
+                  if(c != UNASSIGNED)
+                    galois::atomicAdd(cursor[c], (uint64_t)1);
+                }, galois::loopname("BuildGraph: Count members"));
 
-  // Comment: Serial separation is better than do_all due to contention
-  for(GNode n = 0; n < graph.size(); ++n) {
-      auto n_data = graph.getData(n, flag_no_lock);
-      if(n_data.curr_comm_ass != UNASSIGNED)
-        cluster_bags[n_data.curr_comm_ass].push_back(n);
-      //else galois::gPrint("ISOLATED NODE : ", n, "\n");
-  }
+  galois::do_all(galois::iterate((uint64_t)0, (uint64_t)num_nodes_next),
+                [&](uint64_t c) {
+                  cluster_begin[c] = cursor[c];
+                }, galois::no_stats());
+  cluster_begin[num_nodes_next] = prefixSum(cluster_begin, num_nodes_next);
+
+  galois::do_all(galois::iterate((uint64_t)0, (uint64_t)num_nodes_next),
+                [&](uint64_t c) {
+                  cursor[c] = cluster_begin[c];
+                }, galois::no_stats());
 
+  galois::do_all(galois::iterate(graph),
+                [&](GNode n) {
+                  uint64_t c = graph.getData(n, flag_no_lock).curr_comm_ass;
+                  if(c != UNASSIGNED)
+                    members[cursor[c]++] = n;
+                }, galois::loopname("BuildGraph: Place members"));
+  TimerClusterBags.stop();
+
+  /* Merges the edges of the members of cluster c into the map */
+  auto mergeClusterEdges = [&](uint64_t c, ClusterEdgeMap& map) {
+    uint64_t max_edges = 0;
+    for(uint64_t i = cluster_begin[c]; i < cluster_begin[c + 1]; ++i)
+      max_edges += std::distance(graph.edge_begin(members[i], flag_no_lock),
+                                 graph.edge_end(members[i], flag_no_lock));
+    map.reset(std::min<uint64_t>(max_edges, num_nodes_next));
+
+    for(uint64_t i = cluster_begin[c]; i < cluster_begin[c + 1]; ++i) {
+      GNode n = members[i];
+      assert(graph.getData(n, flag_no_lock).curr_comm_ass == c); // All nodes in this bag must have same cluster id
+      for(auto ii = graph.edge_begin(n, flag_no_lock); ii != graph.edge_end(n, flag_no_lock); ++ii) {
+        auto dst_comm = graph.getData(graph.getEdgeDst(ii), flag_no_lock).curr_comm_ass;
+        assert(dst_comm != UNASSIGNED);
+        map.add(dst_comm, graph.getEdgeData(ii, flag_no_lock));
+      }
+    }
+  };
 
-  std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
-  std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
+  galois::substrate::PerThreadStorage<ClusterEdgeMap> maps;
 
   /* First pass to find the number of edges */
-  galois::do_all(galois::iterate((uint64_t)0, num_unique_clusters),
+  galois::StatTimer TimerFindEdges("Timer_Find_Edges");
+  TimerFindEdges.start();
+  largeArray prefix_edges_count;
+  prefix_edges_count.allocateBlocked(num_nodes_next + 1);
+  galois::do_all(galois::iterate((uint64_t)0, (uint64_t)num_nodes_next),
                 [&](uint64_t c) {
-                    std::map<uint64_t, uint64_t> cluster_local_map;
-                    uint64_t num_unique_clusters = 0;
-                    for(auto cb_ii = cluster_bags[c].begin(); cb_ii != cluster_bags[c].end(); ++cb_ii) {
-
-                      assert(graph.getData(*cb_ii, flag_no_lock).curr_comm_ass == c); // All nodes in this bag must have same cluster id
-
-                      for(auto ii = graph.edge_begin(*cb_ii); ii != graph.edge_end(*cb_ii); ++ii) {
-                        GNode dst = graph.getEdgeDst(ii);
-                        auto dst_data = graph.getData(dst, flag_no_lock);
-                        //assert(dst_data.curr_comm_ass < INF_VAL);
-                        assert(dst_data.curr_comm_ass !=  UNASSIGNED);
-                        auto stored_already = cluster_local_map.find(dst_data.curr_comm_ass); // Check if it already exists
-                        if(stored_already != cluster_local_map.end()) {
-                          edges_data[c][stored_already->second] += graph.getEdgeData(ii);
-                        } else {
-                          cluster_local_map[dst_data.curr_comm_ass] = num_unique_clusters;
-                          edges_id[c].push_back(dst_data.curr_comm_ass);
-                          edges_data[c].push_back(graph.getEdgeData(ii));
-                          num_unique_clusters++;
-                        }
-                      } // End edge loop
-                    }
+                  ClusterEdgeMap& map = *maps.getLocal();
+                  mergeClusterEdges(c, map);
+                  prefix_edges_count[c] = map.size();
                 }, galois::steal(),
-                   galois::loopname("BuildGrah: Find edges"));
-
-  /* Serial loop to reduce all the edge counts */
-  std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
-  galois::GAccumulator<uint64_t> num_edges_acc;
-  galois::do_all(galois::iterate((uint32_t)0, num_nodes_next),
-                [&](uint32_t c){
-                  prefix_edges_count[c] = edges_id[c].size();
-                  num_edges_acc += prefix_edges_count[c];
-                });
-
-  num_edges_next = num_edges_acc.reduce();
-  for(uint32_t c = 1; c < num_nodes_next; ++c) {
-    prefix_edges_count[c] += prefix_edges_count[c - 1];
-  }
+                   galois::loopname("BuildGraph: Find edges"));
 
-  assert(prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
+  num_edges_next = prefixSum(prefix_edges_count, num_nodes_next);
+  prefix_edges_count[num_nodes_next] = num_edges_next;
+  TimerFindEdges.stop();
   galois::gPrint("#nodes : ", num_nodes_next, ", #edges : ", num_edges_next, "\n");
-  galois::gPrint("#prefix last : ", prefix_edges_count[num_unique_clusters - 1], "\n");
-
-#if 0
-  for(uint32_t i = 0; i < num_nodes_next; ++i){
-    for(uint32_t j = 0; j < edges_id[i].size(); ++j){
-      galois::gPrint(i, " -B-> <", edges_id[i][j], " , ", edges_data[i][j], ">\n");
-    }
-  }
-#endif
 
+  /* Second pass writes the edges; graph may be graph_next, so build aside */
   std::cerr << "Graph construction started" << "\n";
 
   galois::StatTimer TimerConstructFrom("Timer_Construct_From");
   TimerConstructFrom.start();
-  graph_next.constructFrom(num_nodes_next, num_edges_next, prefix_edges_count, edges_id, edges_data);
+  Graph coarse;
+  coarse.allocateFrom(num_nodes_next, num_edges_next);
+  coarse.constructNodes();
+  galois::do_all(galois::iterate((uint64_t)0, (uint64_t)num_nodes_next),
+                [&](uint64_t c) {
+                  coarse.fixEndEdge(c, prefix_edges_count[c + 1]);
+                  ClusterEdgeMap& map = *maps.getLocal();
+                  mergeClusterEdges(c, map);
+                  uint64_t e = prefix_edges_count[c];
+                  map.forEach([&](uint64_t dst, EdgeTy wt) {
+                    coarse.constructEdge(e++, dst, wt);
+                  });
+                }, galois::steal(),
+                   galois::loopname("BuildGraph: Write edges"));
+
+  swap(graph_next, coarse);
+  graph_next.determineLocalRanges();
   TimerConstructFrom.stop();
 
   TimerGraphBuild.stop();
   galois::gPrint("Graph construction done\n");
 }
+
 void runMultiPhaseLouvainAlgorithm(Graph& graph, uint64_t min_graph_size, double c_threshold, largeArray& clusters_orig) {
 
   galois::gPrint("Inside runMultiPhaseLouvainAlgorithm\n");
@@ -1054,7 +1112,7 @@ void runMultiPhaseLouvainAlgorithm(Graph& graph, uint64_t min_graph_size, double
     } else {
       galois::do_all(galois::iterate((uint64_t)0, num_nodes_orig),
                     [&](GNode n) {
-                      if(clusters_orig[n] > 0){
+                      if(clusters_orig[n] != UNASSIGNED){
                         assert(clusters_orig[n] < graph_curr->size());
                         //galois::gPrint(clusters_orig[n],"\n");
                         clusters_orig[n] = (*graph_curr).getData(clusters_orig[n], flag_no_lock).curr_comm_ass;
@@ -86,7 +86,7 @@ uint64_t vertexFollowing(Graph& graph){
                     } else {
                       if(degree == 1) {
                         //Check if the destination has degree greater than one
-                        auto dst = graph.getEdgeDst(graph.edge_end(n, galois::MethodFlag::UNPROTECTED));
+                        auto dst = graph.getEdgeDst(graph.edge_begin(n, galois::MethodFlag::UNPROTECTED));
                         uint64_t dst_degree = std::distance(graph.edge_begin(dst, galois::MethodFlag::UNPROTECTED),
                                                          graph.edge_end(dst, galois::MethodFlag::UNPROTECTED));
                         if((dst_degree > 1 || (n > dst))){
@@ -102,6 +102,72 @@ uint64_t vertexFollowing(Graph& graph){
 
 
 
+/*
+ * Vertex pruning for the local-move phase: after the first iteration, only
+ * nodes that changed community in the previous iteration, or have a neighbor
+ * that did, are revisited. Moves elsewhere can still change the degree
+ * weight of a neighboring community, so this is a heuristic that trades a
+ * little modularity for skipping the settled parts of the graph.
+ */
+class ActiveNodes {
+  bool enabled = false;
+  galois::DynamicBitSet active;
+  galois::DynamicBitSet next_active;
+  largeArray comm_before;
+
+public:
+  void init(Graph& graph, bool enable) {
+    enabled = enable;
+    if(!enabled)
+      return;
+    active.resize(graph.size());
+    next_active.resize(graph.size());
+    comm_before.allocateBlocked(graph.size());
+    galois::do_all(galois::iterate(graph),
+                  [&](GNode n) {
+                    active.set(n);
+                  }, galois::no_stats());
+  }
+
+  bool isActive(GNode n) const { return !enabled || active.test(n); }
+
+  /* Records the communities the iteration starts from */
+  void startIteration(Graph& graph) {
+    if(!enabled)
+      return;
+    galois::do_all(galois::iterate(graph),
+                  [&](GNode n) {
+                    comm_before[n] = graph.getData(n, flag_no_lock).curr_comm_ass;
+                  }, galois::no_stats());
+  }
+
+  /*
+   * Activates the nodes that moved in the iteration and their neighbors for
+   * the next one; returns the number of active nodes.
+   */
+  uint64_t finishIteration(Graph& graph) {
+    if(!enabled)
+      return graph.size();
+
+    galois::StatTimer TimerPruning("Timer_Pruning");
+    TimerPruning.start();
+    next_active.reset();
+    galois::do_all(galois::iterate(graph),
+                  [&](GNode n) {
+                    if(graph.getData(n, flag_no_lock).curr_comm_ass == comm_before[n])
+                      return;
+                    next_active.set(n);
+                    for(auto ii = graph.edge_begin(n, flag_no_lock); ii != graph.edge_end(n, flag_no_lock); ++ii)
+                      next_active.set(graph.getEdgeDst(ii));
+                  }, galois::steal(), galois::no_stats());
+    std::swap(active, next_active);
+    uint64_t num_active = active.count();
+    TimerPruning.stop();
+    galois::gPrint("Active nodes for next iteration: ", num_active, "\n");
+    return num_active;
+  }
+};
+
 void sumVertexDegreeWeight(Graph& graph, CommArray& c_info) {
 //void sumVertexDegreeWeight(Graph& graph, std::vector<Comm>& c_info) {
   galois::do_all(galois::iterate(graph),
@@ -408,26 +474,128 @@ double calModularityFinal(Graph& graph) {
   return mod;
 }
 
-uint64_t renumberClustersContiguously(Graph &graph) {
+/*
+ * Replaces a[0, n) with its exclusive prefix sum and returns the total;
+ * blocks of a are summed and then offset in parallel.
+ */
+uint64_t prefixSum(largeArray& a, uint64_t n) {
+  constexpr uint64_t block_size = 1 << 14;
+  uint64_t num_blocks = (n + block_size - 1) / block_size;
+  std::vector<uint64_t> block_sum(num_blocks + 1, 0);
+
+  galois::do_all(galois::iterate((uint64_t)0, num_blocks),
+                [&](uint64_t b) {
+                  uint64_t end = std::min(n, (b + 1) * block_size);
+                  for(uint64_t i = b * block_size; i < end; ++i)
+                    block_sum[b + 1] += a[i];
+                }, galois::no_stats());
+
+  for(uint64_t b = 1; b <= num_blocks; ++b)
+    block_sum[b] += block_sum[b - 1];
+
+  galois::do_all(galois::iterate((uint64_t)0, num_blocks),
+                [&](uint64_t b) {
+                  uint64_t end = std::min(n, (b + 1) * block_size);
+                  uint64_t sum = block_sum[b];
+                  for(uint64_t i = b * block_size; i < end; ++i) {
+                    uint64_t count = a[i];
+                    a[i] = sum;
+                    sum += count;
+                  }
+                }, galois::no_stats());
 
-  std::map<uint64_t, uint64_t> cluster_local_map;
-  uint64_t num_unique_clusters = 0;
+  return block_sum[num_blocks];
+}
 
-  for (GNode n = 0; n < graph.size(); ++n){
-    auto& n_data = graph.getData(n, flag_no_lock);
-    if(n_data.curr_comm_ass != UNASSIGNED) {
-      assert(n_data.curr_comm_ass < graph.size());
-      auto stored_already = cluster_local_map.find(n_data.curr_comm_ass);
-     if(stored_already != cluster_local_map.end()){
-      n_data.curr_comm_ass = stored_already->second;
-     } else {
-      cluster_local_map[n_data.curr_comm_ass] = num_unique_clusters;
-      n_data.curr_comm_ass = num_unique_clusters;
-      num_unique_clusters++;
-     }
+/*
+ * Open addressing map from a neighboring community to the total weight of
+ * the edges to it, reused by each thread for every community it coarsens.
+ */
+class ClusterEdgeMap {
+  std::vector<uint64_t> keys; // UNASSIGNED marks an empty slot
+  std::vector<EdgeTy> weights;
+  std::vector<uint64_t> used; // occupied slots, in insertion order
+  uint32_t shift = 64;
+
+  uint64_t slot(uint64_t key) const {
+    return (key * 0x9E3779B97F4A7C15ull) >> shift;
+  }
+
+public:
+  /* Empties the map and makes room for up to max_keys keys */
+  void reset(uint64_t max_keys) {
+    for(uint64_t s : used)
+      keys[s] = UNASSIGNED;
+    used.clear();
+
+    uint32_t log_size = 4;
+    while((uint64_t(1) << log_size) < 2 * max_keys)
+      ++log_size;
+    if((uint64_t(1) << log_size) > keys.size()) {
+      keys.assign(uint64_t(1) << log_size, UNASSIGNED);
+      weights.resize(keys.size());
+    }
+    shift = 64 - log_size;
+  }
+
+  void add(uint64_t key, EdgeTy wt) {
+    uint64_t mask = (uint64_t(1) << (64 - shift)) - 1;
+    for(uint64_t s = slot(key); ; s = (s + 1) & mask) {
+      if(keys[s] == key) {
+        weights[s] += wt;
+        return;
+      }
+      if(keys[s] == UNASSIGNED) {
+        keys[s] = key;
+        weights[s] = wt;
+        used.push_back(s);
+        return;
+      }
     }
   }
 
+  uint64_t size() const { return used.size(); }
+
+  /* Calls f(key, weight) for every key, in insertion order */
+  template<typename F>
+  void forEach(F f) const {
+    for(uint64_t s : used)
+      f(keys[s], weights[s]);
+  }
+};
+
+/*
+ * Renumbers the communities in use to 0 .. #communities - 1, keeping their
+ * order, and returns the number of communities.
+ */
+uint64_t renumberClustersContiguously(Graph &graph) {
+  largeArray new_id;
+  new_id.allocateBlocked(graph.size());
+
+  galois::do_all(galois::iterate(graph),
+                [&](GNode n) {
+                  new_id[n] = 0;
+                }, galois::no_stats());
+
+  galois::do_all(galois::iterate(graph),
+                [&](GNode n) {
+                  uint64_t c = graph.getData(n, flag_no_lock).curr_comm_ass;
+                  if(c != UNASSIGNED) {
+                    assert(c < graph.size());
+                    // benign race: every writer stores 1
+                    new_id[c] = 1;
+                  }
+                }, galois::no_stats());
+
+  uint64_t num_unique_clusters = prefixSum(new_id, graph.size());
+
+  galois::do_all(galois::iterate(graph),
+                [&](GNode n) {
+                  auto& n_data = graph.getData(n, flag_no_lock);
+                  if(n_data.curr_comm_ass != UNASSIGNED)
+                    n_data.curr_comm_ass = new_id[n_data.curr_comm_ass];
+                }, galois::no_stats());
+
   return num_unique_clusters;
 }
 
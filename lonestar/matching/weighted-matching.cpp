@@ -0,0 +1,437 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/graphs/LCGraph.h"
+#include "llvm/Support/CommandLine.h"
+#include "Lonestar/BoilerPlate.h"
+
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Approximate maximum weight matching";
+static const char* desc =
+    "Computes a matching of large weight in a general graph. The Suitor "
+    "algorithm finds a 1/2-approximate matching, which local augmentations "
+    "then improve.";
+static const char* url = 0;
+
+enum ExecutionType { serial, parallel };
+
+static cll::opt<std::string>
+    inputFilename(cll::Positional,
+                  cll::desc("<input file (symmetric, weighted)>"),
+                  cll::Required);
+static cll::opt<ExecutionType>
+    executionType(cll::desc("Choose execution type:"),
+                  cll::values(clEnumVal(serial, "Serial"),
+                              clEnumVal(parallel, "Parallel"), clEnumValEnd),
+                  cll::init(parallel));
+static cll::opt<unsigned int> refineRounds(
+    "refineRounds",
+    cll::desc("Maximum number of augmentation rounds after the 1/2-approximate "
+              "matching (default 5; 0 disables them)"),
+    cll::init(5));
+
+constexpr static const unsigned CHUNK_SIZE = 64u;
+
+/**
+ * Matching state of a node. The Suitor phase keeps in offer the best proposal
+ * the node has received so far, as the weight of the proposing edge in the
+ * upper half and the proposer in the lower half, so proposals compare by
+ * weight and then by proposer, and a single CAS replaces one.
+ */
+struct Node {
+  std::atomic<uint64_t> offer;
+  uint32_t mate;
+  uint32_t mateWeight;
+};
+
+using Graph = galois::graphs::LC_CSR_Graph<Node, uint32_t>;
+using GNode = Graph::GraphNode;
+
+constexpr static const uint64_t NO_OFFER = 0;
+constexpr static const uint32_t NO_MATE  = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Suitor (Manne and Halappanavar, IPDPS'14) followed by rounds of local
+ * augmentations.
+ *
+ * In Suitor, each node proposes to its heaviest neighbor that prefers it to
+ * the suitor it already has, if any; that suitor is displaced and proposes
+ * again. Ties are broken by node id. When no proposals are left, suitors are
+ * mutual and form the same matching as the greedy algorithm that takes edges
+ * in decreasing order of weight: every edge is no heavier than the matched
+ * edge at one of its endpoints, so the matching has at least half the
+ * maximum weight. Proposals only need CASes on the offers, so this phase
+ * runs without conflict detection.
+ *
+ * An augmentation replaces a matched edge (u, v) with the edges (a, u) and
+ * (v, b) to free nodes a and b when they are heavier together, i.e., it flips
+ * an augmenting path of length 3 of positive gain. Each augmentation reads
+ * the neighborhoods of u and v before it writes, so it is a cautious Galois
+ * operator, and conflicting ones are rolled back by the runtime.
+ *
+ * @tparam Concurrent run with numThreads threads and conflict detection, or
+ * with one thread and none
+ */
+template <bool Concurrent>
+struct SuitorMatching {
+  static const galois::MethodFlag flag =
+      Concurrent ? galois::MethodFlag::WRITE : galois::MethodFlag::UNPROTECTED;
+  constexpr static const galois::MethodFlag unprotected =
+      galois::MethodFlag::UNPROTECTED;
+
+  Graph& graph;
+
+  explicit SuitorMatching(Graph& g) : graph(g) {}
+
+  std::string name() {
+    return std::string(Concurrent ? "Concurrent" : "Serial") + " Suitor";
+  }
+
+  static uint64_t makeOffer(uint32_t weight, GNode proposer) {
+    return uint64_t(weight) << 32 | proposer;
+  }
+
+  /**
+   * Proposes from u to its best neighbor that accepts, and calls
+   * displaced(x) with the suitor x that loses its place, if any. Zero weight
+   * edges add nothing to a matching and are skipped, which keeps NO_OFFER
+   * below every offer.
+   */
+  template <typename F>
+  void propose(GNode u, F displaced) {
+    while (true) {
+      GNode best       = u;
+      uint64_t bestKey = NO_OFFER;
+      for (auto e : graph.edges(u, unprotected)) {
+        GNode v    = graph.getEdgeDst(e);
+        uint32_t w = graph.getEdgeData(e, unprotected);
+        if (v == u || w == 0)
+          continue;
+        uint64_t offer = makeOffer(w, u);
+        // the neighbor's id breaks ties between edges of equal weight
+        uint64_t key = uint64_t(w) << 32 | v;
+        if (key > bestKey &&
+            offer > graph.getData(v, unprotected).offer.load(
+                        std::memory_order_relaxed)) {
+          best    = v;
+          bestKey = key;
+        }
+      }
+      if (bestKey == NO_OFFER)
+        return;
+
+      std::atomic<uint64_t>& target = graph.getData(best, unprotected).offer;
+      uint64_t offer = makeOffer(bestKey >> 32, u);
+      uint64_t old   = target.load(std::memory_order_relaxed);
+      // another proposal may have come in since the scan; if it beats this
+      // one, look for the next best neighbor
+      while (old < offer) {
+        if (target.compare_exchange_weak(old, offer,
+                                         std::memory_order_relaxed)) {
+          if (old != NO_OFFER)
+            displaced(GNode(old));
+          return;
+        }
+      }
+    }
+  }
+
+  //! Matches the nodes whose suitors are mutual
+  void collectMates() {
+    galois::do_all(
+        galois::iterate(graph),
+        [&](GNode n) {
+          Node& nd       = graph.getData(n, unprotected);
+          uint64_t offer = nd.offer.load(std::memory_order_relaxed);
+          nd.mate        = NO_MATE;
+          nd.mateWeight  = 0;
+          if (offer == NO_OFFER)
+            return;
+          GNode suitor = GNode(offer);
+          uint64_t back =
+              graph.getData(suitor, unprotected).offer.load(
+                  std::memory_order_relaxed);
+          if (back != NO_OFFER && GNode(back) == n) {
+            nd.mate       = suitor;
+            nd.mateWeight = offer >> 32;
+          }
+        },
+        galois::loopname("CollectMates"));
+  }
+
+  void suitor() {
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     graph.getData(n, unprotected).offer = NO_OFFER;
+                   },
+                   galois::no_stats(), galois::loopname("InitOffers"));
+
+    galois::for_each(galois::iterate(graph),
+                     [&](GNode u, auto& ctx) {
+                       propose(u, [&](GNode x) { ctx.push(x); });
+                     },
+                     galois::no_conflicts(), galois::chunk_size<CHUNK_SIZE>(),
+                     galois::loopname("Suitor"));
+    collectMates();
+  }
+
+  struct Candidate {
+    GNode node;
+    uint32_t weight;
+  };
+
+  /**
+   * The two heaviest edges from n to free nodes other than exclude, locking
+   * the neighborhood of n.
+   */
+  void freeNeighbors(GNode n, GNode exclude, Candidate& first,
+                     Candidate& second) {
+    first = second = Candidate{n, 0};
+    for (auto e : graph.edges(n, flag)) {
+      GNode a    = graph.getEdgeDst(e);
+      uint32_t w = graph.getEdgeData(e, unprotected);
+      if (a == n || a == exclude || graph.getData(a, flag).mate != NO_MATE)
+        continue;
+      if (w > first.weight) {
+        second = first;
+        first  = Candidate{a, w};
+      } else if (w > second.weight && a != first.node) {
+        second = Candidate{a, w};
+      }
+    }
+  }
+
+  void match(GNode a, GNode b, uint32_t w) {
+    Node& ad      = graph.getData(a, unprotected);
+    Node& bd      = graph.getData(b, unprotected);
+    ad.mate       = b;
+    ad.mateWeight = w;
+    bd.mate       = a;
+    bd.mateWeight = w;
+  }
+
+  //! Augmentation rounds; returns the number of augmentations
+  size_t refine() {
+    galois::InsertBag<GNode> matched;
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     GNode m = graph.getData(n, unprotected).mate;
+                     if (m != NO_MATE && n < m)
+                       matched.push(n);
+                   },
+                   galois::loopname("CollectMatched"));
+
+    size_t total = 0;
+    for (unsigned round = 0; round < refineRounds; ++round) {
+      galois::GAccumulator<size_t> augmented;
+      galois::for_each(
+          galois::iterate(matched),
+          [&](GNode u, auto&) {
+            Node& ud = graph.getData(u, flag);
+            GNode v  = ud.mate;
+            if (v == NO_MATE)
+              return;
+            uint32_t current = ud.mateWeight;
+            graph.getData(v, flag);
+
+            Candidate a1, a2, b1, b2;
+            freeNeighbors(u, v, a1, a2);
+            freeNeighbors(v, u, b1, b2);
+
+            // best pair of distinct free nodes
+            Candidate a = a1, b = b1;
+            if (a1.node == b1.node && a1.weight && b1.weight) {
+              if (uint64_t(a1.weight) + b2.weight >=
+                  uint64_t(a2.weight) + b1.weight)
+                b = b2;
+              else
+                a = a2;
+            }
+            if (!a.weight || !b.weight ||
+                uint64_t(a.weight) + b.weight <= current)
+              return;
+
+            match(a.node, u, a.weight);
+            match(v, b.node, b.weight);
+            augmented += 1;
+          },
+          galois::loopname("Augment"),
+          galois::wl<galois::worklists::PerSocketChunkFIFO<CHUNK_SIZE>>());
+
+      size_t count = augmented.reduce();
+      total += count;
+      std::cout << "Augmentation round " << round << ": " << count
+                << " augmentations\n";
+      if (!count)
+        break;
+      // the new matched edges may be augmented in turn
+      matched.clear();
+      galois::do_all(galois::iterate(graph),
+                     [&](GNode n) {
+                       GNode m = graph.getData(n, unprotected).mate;
+                       if (m != NO_MATE && n < m)
+                         matched.push(n);
+                     },
+                     galois::loopname("CollectMatched"));
+    }
+    return total;
+  }
+};
+
+struct MatchingStats {
+  uint64_t weight;
+  size_t cardinality;
+};
+
+MatchingStats summarize(Graph& graph) {
+  galois::GAccumulator<uint64_t> weight;
+  galois::GAccumulator<size_t> cardinality;
+  galois::do_all(galois::iterate(graph),
+                 [&](GNode n) {
+                   Node& nd = graph.getData(n, galois::MethodFlag::UNPROTECTED);
+                   if (nd.mate != NO_MATE && n < nd.mate) {
+                     weight += nd.mateWeight;
+                     cardinality += 1;
+                   }
+                 },
+                 galois::no_stats(), galois::loopname("Summarize"));
+  return MatchingStats{weight.reduce(), cardinality.reduce()};
+}
+
+/**
+ * Checks that mates are mutual and joined by an edge of the recorded weight
+ * and, if dominant, that every edge is no heavier than the matched edge at
+ * one of its endpoints, which makes the matching 1/2-approximate.
+ */
+bool verify(Graph& graph, bool dominant) {
+  for (GNode n : graph) {
+    Node& nd = graph.getData(n);
+    if (nd.mate == NO_MATE)
+      continue;
+    if (nd.mate >= graph.size() || graph.getData(nd.mate).mate != n) {
+      std::cerr << "node " << n << " is matched to " << nd.mate
+                << ", which is not matched to it\n";
+      return false;
+    }
+    bool found = false;
+    for (auto e : graph.edges(n))
+      found |= graph.getEdgeDst(e) == nd.mate &&
+               graph.getEdgeData(e) == nd.mateWeight;
+    if (!found) {
+      std::cerr << "node " << n << " has no edge of weight " << nd.mateWeight
+                << " to its mate " << nd.mate << "\n";
+      return false;
+    }
+  }
+
+  if (!dominant)
+    return true;
+  for (GNode n : graph) {
+    for (auto e : graph.edges(n)) {
+      GNode m    = graph.getEdgeDst(e);
+      uint32_t w = graph.getEdgeData(e);
+      if (m != n && w > graph.getData(n).mateWeight && w > graph.getData(m).mateWeight) {
+        std::cerr << "edge " << n << " - " << m << " of weight " << w
+                  << " is heavier than the matched edges at both ends\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <bool Concurrent>
+void run(Graph& graph) {
+  SuitorMatching<Concurrent> algo(graph);
+  galois::setActiveThreads(Concurrent ? numThreads : 1);
+  std::cout << "Starting " << algo.name() << "\n";
+
+  galois::StatTimer suitorTimer("SuitorTime");
+  suitorTimer.start();
+  algo.suitor();
+  suitorTimer.stop();
+
+  MatchingStats approx = summarize(graph);
+  std::cout << "1/2-approximate matching: weight " << approx.weight
+            << ", cardinality " << approx.cardinality << "\n";
+  if (!skipVerify && !verify(graph, true)) {
+    GALOIS_DIE("verification of the 1/2-approximate matching failed");
+  }
+
+  galois::StatTimer refineTimer("RefineTime");
+  refineTimer.start();
+  size_t augmentations = algo.refine();
+  refineTimer.stop();
+
+  MatchingStats refined = summarize(graph);
+  std::cout << "Refined matching: weight " << refined.weight
+            << ", cardinality " << refined.cardinality << " ("
+            << augmentations << " augmentations)\n";
+  galois::runtime::reportStat_Single("WeightedMatching", "Weight",
+                                     refined.weight);
+  galois::runtime::reportStat_Single("WeightedMatching", "Cardinality",
+                                     refined.cardinality);
+
+  if (!skipVerify) {
+    if (!verify(graph, false) || refined.weight < approx.weight) {
+      GALOIS_DIE("verification failed");
+    }
+    std::cout << "Verification successful.\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url);
+
+  Graph graph;
+  std::cout << "Reading from file: " << inputFilename << std::endl;
+  galois::graphs::readGraph(graph, inputFilename);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges" << std::endl;
+  if (graph.size() >= NO_MATE) {
+    GALOIS_DIE("too many nodes");
+  }
+
+  galois::StatTimer T;
+  T.start();
+  switch (executionType) {
+  case serial:
+    run<false>(graph);
+    break;
+  case parallel:
+    run<true>(graph);
+    break;
+  default:
+    GALOIS_DIE("unknown execution type");
+  }
+  T.stop();
+
+  return 0;
+}
@@ -21,6 +21,7 @@
 #include <fstream>
 #include <iostream>
 #include <ostream>
+#include <unistd.h>
 #include "matrixCompletion.h"
 #include "galois/runtime/TiledExecutor.h"
 #include "galois/ParallelSTL.h"
@@ -47,6 +48,7 @@ enum Algo {
   simpleALS,
   sgdByItems,
   sgdByEdges,
+  sgdByEdgesHogwild,
   sgdBlockEdge,
   sgdBlockJump,
 };
@@ -68,6 +70,8 @@ static cll::opt<Algo>
                         "SGD using Block jumping "),
              clEnumValN(Algo::sgdByItems, "sgdByItems", "Simple SGD on Items"),
              clEnumValN(Algo::sgdByEdges, "sgdByEdges", "Simple SGD on edges"),
+             clEnumValN(Algo::sgdByEdgesHogwild, "sgdByEdgesHogwild",
+                        "Lock-free (Hogwild) SGD on edges"),
              clEnumValEnd),
          cll::init(Algo::sgdBlockEdge));
 /*
@@ -268,6 +272,7 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
   elapsed.start();
 
   unsigned long lastTime = 0;
+  uint64_t updates       = 0;
 
   for (unsigned int round = 0;; round += deltaRound) {
     if (fixedRounds > 0 && round >= fixedRounds)
@@ -283,9 +288,12 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
         steps[i] = sf.stepSize(round + i);
     }
 
+    unsigned long roundStart = executeAlgoTimer.get_usec();
     executeAlgoTimer.start();
     fn(&steps[0], round + deltaRound, useExactError ? &errorAccum : NULL);
     executeAlgoTimer.stop();
+    unsigned long roundMicros = executeAlgoTimer.get_usec() - roundStart;
+    updates += uint64_t(g.sizeEdges()) * deltaRound;
     double error = useExactError ? errorAccum.reduce() : sumSquaredError(g);
 
     elapsed.stop();
@@ -300,7 +308,9 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
 
     int curRound = round + deltaRound;
     galois::gPrint("R: ", curRound, " elapsed (ms): ", curElapsed,
-                   " GFLOP/s: ", gflops);
+                   " GFLOP/s: ", gflops, " updates/s: ",
+                   roundMicros ? g.sizeEdges() * deltaRound * 1e6 / roundMicros
+                               : 0.0);
     if (useExactError) {
       galois::gPrint(" RMSE (R ", curRound,
                      "): ", std::sqrt(error / g.sizeEdges()), "\n");
@@ -324,6 +334,31 @@ void executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
     }
     last = error;
   }
+
+  if (executeAlgoTimer.get_usec()) {
+    galois::runtime::reportStat_Single(
+        "MatrixCompletion", "UpdatesPerSecond",
+        uint64_t(updates * 1e6 / executeAlgoTimer.get_usec()));
+  }
+}
+
+/**
+ * Items and users per block of the 2D tiled schedule. Unless they are set on
+ * the command line, blocks keep the default ratio of items to users and are
+ * sized so the latent vectors of a block take half of the L2 cache, leaving
+ * the rest for its edges.
+ */
+static std::pair<size_t, size_t> tiledBlockSizes() {
+  if (itemsPerBlock.getNumOccurrences() || usersPerBlock.getNumOccurrences())
+    return std::make_pair(size_t(itemsPerBlock), size_t(usersPerBlock));
+
+  long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (l2 <= 0)
+    l2 = 256 * 1024;
+  double nodes = l2 / 2.0 / (LATENT_VECTOR_SIZE * sizeof(LatentValue));
+  double scale = nodes / (itemsPerBlock + usersPerBlock);
+  return std::make_pair(std::max<size_t>(1, itemsPerBlock * scale),
+                        std::max<size_t>(1, usersPerBlock * scale));
 }
 
 /*
@@ -824,6 +859,91 @@ public:
   }
 };
 
+/**
+ * Hogwild (Niu et al., NIPS'11): threads update the latent vectors of edges
+ * without any locks, so concurrent updates to the same user may overwrite
+ * each other, which SGD tolerates when ratings are sparse. Edges are
+ * scheduled individually rather than by item, so items of high degree are
+ * split among threads.
+ */
+class SGDEdgeHogwildAlgo {
+  struct BasicNode {
+    LatentValue latentVector[LATENT_VECTOR_SIZE];
+  };
+
+  using Node = BasicNode;
+
+public:
+  bool isSgd() const { return true; }
+
+  typedef typename galois::graphs::LC_CSR_Graph<
+      Node, EdgeType>::template with_no_lockable<true>::type Graph;
+
+  void readGraph(Graph& g) { galois::graphs::readGraph(g, inputFilename); }
+
+  std::string name() const { return "sgdByEdgesHogwild"; }
+
+  size_t numItems() const { return NUM_ITEM_NODES; }
+
+private:
+  using GNode         = typename Graph::GraphNode;
+  using edge_iterator = typename Graph::edge_iterator;
+
+  struct Execute {
+    Graph& g;
+    //! item (source) of each edge
+    galois::LargeArray<GNode>& edgeSrc;
+    galois::GAccumulator<size_t>& edgesVisited;
+
+    void operator()(LatentValue* steps, int maxUpdates,
+                    galois::GAccumulator<double>* errorAccum) {
+      const LatentValue stepSize = steps[0];
+      constexpr galois::MethodFlag flag = galois::MethodFlag::UNPROTECTED;
+      galois::do_all(
+          galois::iterate(size_t(0), size_t(g.sizeEdges())),
+          [&](size_t e) {
+            edge_iterator ii(e);
+            LatentValue error = doGradientUpdate(
+                g.getData(edgeSrc[e], flag).latentVector,
+                g.getData(g.getEdgeDst(ii), flag).latentVector, lambda,
+                g.getEdgeData(ii, flag), stepSize);
+            edgesVisited += 1;
+            if (useExactError)
+              *errorAccum += error;
+          },
+          galois::steal(), galois::chunk_size<256>(), galois::no_stats(),
+          galois::loopname("sgdByEdgesHogwild"));
+    }
+  };
+
+public:
+  void operator()(Graph& g, const StepFunction& sf) {
+    verify(g, "sgdByEdgesHogwild");
+    galois::GAccumulator<size_t> edgesVisited;
+
+    galois::LargeArray<GNode> edgeSrc;
+    edgeSrc.allocateInterleaved(g.sizeEdges());
+    galois::do_all(galois::iterate(g.begin(), g.begin() + NUM_ITEM_NODES),
+                   [&](GNode src) {
+                     auto flag = galois::MethodFlag::UNPROTECTED;
+                     for (auto ii : g.edges(src, flag))
+                       edgeSrc[*ii] = src;
+                   },
+                   galois::steal(), galois::no_stats());
+
+    galois::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    Execute fn{g, edgeSrc, edgesVisited};
+    executeUntilConverged(sf, g, fn);
+
+    executeTimer.stop();
+
+    galois::runtime::reportStat_Single("sgdByEdgesHogwild", "EdgesVisited",
+                                       edgesVisited.reduce());
+  }
+};
+
 /*
  * Simple edge-wise operator
  * Use Fixed2DGraphTiledExecutor to divide Items and Users in to blocks.
@@ -860,13 +980,14 @@ private:
   struct Execute {
     Graph& g;
     galois::GAccumulator<unsigned>& edgesVisited;
+    std::pair<size_t, size_t> blockSizes;
 
     void operator()(LatentValue* steps, int maxUpdates,
                     galois::GAccumulator<double>* errorAccum) {
       galois::runtime::Fixed2DGraphTiledExecutor<Graph> executor(g);
       executor.execute(
           g.begin(), g.begin() + NUM_ITEM_NODES, g.begin() + NUM_ITEM_NODES,
-          g.end(), itemsPerBlock, usersPerBlock,
+          g.end(), blockSizes.first, blockSizes.second,
           [&](GNode src, GNode dst, edge_iterator edge) {
             const LatentValue stepSize = steps[0];
             LatentValue error          = doGradientUpdate(
@@ -890,7 +1011,11 @@ public:
     galois::StatTimer executeTimer("Time");
     executeTimer.start();
 
-    Execute fn{g, edgesVisited};
+    std::pair<size_t, size_t> blockSizes = tiledBlockSizes();
+    galois::gPrint("items per block: ", blockSizes.first,
+                   " users per block: ", blockSizes.second, "\n");
+
+    Execute fn{g, edgesVisited, blockSizes};
     executeUntilConverged(sf, g, fn);
 
     executeTimer.stop();
@@ -1508,6 +1633,9 @@ int main(int argc, char** argv) {
   case Algo::sgdByEdges:
     run<SGDEdgeItem>();
     break;
+  case Algo::sgdByEdgesHogwild:
+    run<SGDEdgeHogwildAlgo>();
+    break;
   case Algo::sgdBlockEdge:
     run<SGDBlockEdgeAlgo>();
     break;
@@ -28,9 +28,14 @@
 typedef float LatentValue;
 typedef float EdgeType;
 
-// Purdue, CSGD: 100; Intel: 20
-// static const int LATENT_VECTOR_SIZE = 100;
-static const int LATENT_VECTOR_SIZE = 20; // Purdue, CSGD: 100; Intel: 20
+// Purdue, CSGD: 100; Intel: 20. Set with MATRIX_COMPLETION_LATENT_SIZE in
+// cmake; the kernels below are fastest when it is a multiple of the SIMD
+// width, e.g., 16, 32, 64 or 128, and need it to be a multiple of 4 to
+// avoid scalar code.
+#ifndef MC_LATENT_VECTOR_SIZE
+#define MC_LATENT_VECTOR_SIZE 20
+#endif
+static const int LATENT_VECTOR_SIZE = MC_LATENT_VECTOR_SIZE;
 
 /**
  * Common commandline parameters to for matrix completion algorithms
@@ -117,11 +122,107 @@ static cll::opt<bool>
                          "use deterministic values for latent vector"),
                cll::init(false));
 
+/**
+ * Latent vector kernels written with GCC vector extensions so they compile
+ * to SSE, AVX or AVX-512 depending on the target architecture. Each kernel
+ * uses the widest vector whose lane count divides K, so K = 20 runs on 4
+ * SSE vectors rather than one AVX-512 vector and a scalar tail. Latent
+ * vectors need no particular alignment.
+ */
+namespace latent {
+
+#if defined(__AVX512F__)
+static const int SIMD_BYTES = 64;
+#elif defined(__AVX__)
+static const int SIMD_BYTES = 32;
+#else
+static const int SIMD_BYTES = 16;
+#endif
+
+//! Widest vector size in bytes, at most SIMD_BYTES, that evenly divides K Ts
+template <typename T>
+constexpr int vectorBytes(int K, int bytes = SIMD_BYTES) {
+  return (bytes == 16 || K % (bytes / sizeof(T)) == 0)
+             ? bytes
+             : vectorBytes<T>(K, bytes / 2);
+}
+
+template <typename T, int BYTES>
+struct Simd {
+  static const int LANES = BYTES / sizeof(T);
+  typedef T type __attribute__((vector_size(BYTES)));
+
+  static type load(const T* p) {
+    type v;
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static void store(T* p, type v) { __builtin_memcpy(p, &v, sizeof(v)); }
+  static type splat(T x) { return type{} + x; }
+  static T sum(type v) {
+    T s = 0;
+    for (int i = 0; i < LANES; ++i)
+      s += v[i];
+    return s;
+  }
+};
+
+/**
+ * init + the inner product of a[0, K) and b[0, K). Uses two accumulators
+ * so consecutive multiply-adds do not wait on each other.
+ */
+template <int K, typename T>
+T dot(const T* __restrict__ a, const T* __restrict__ b, T init) {
+  typedef Simd<T, vectorBytes<T>(K)> V;
+  const int FULL = K / V::LANES * V::LANES;
+  typename V::type acc0 = V::splat(0), acc1 = V::splat(0);
+  int i = 0;
+  for (; i + 2 * V::LANES <= FULL; i += 2 * V::LANES) {
+    acc0 += V::load(a + i) * V::load(b + i);
+    acc1 += V::load(a + i + V::LANES) * V::load(b + i + V::LANES);
+  }
+  if (i < FULL) {
+    acc0 += V::load(a + i) * V::load(b + i);
+    i += V::LANES;
+  }
+  init += V::sum(acc0 + acc1);
+  for (; i < K; ++i)
+    init += a[i] * b[i];
+  return init;
+}
+
+/**
+ * One SGD step on the latent vectors of an edge with the given prediction
+ * error: x -= step * (error * y + lambda * x) for x, y the item and user
+ * vectors and the other way around.
+ */
+template <int K, typename T>
+void gradientStep(T* __restrict__ item, T* __restrict__ user, T error,
+                  T lambda, T step) {
+  typedef Simd<T, vectorBytes<T>(K)> V;
+  const int FULL = K / V::LANES * V::LANES;
+  const typename V::type e = V::splat(error), l = V::splat(lambda),
+                         s = V::splat(step);
+  int i = 0;
+  for (; i < FULL; i += V::LANES) {
+    typename V::type x = V::load(item + i);
+    typename V::type y = V::load(user + i);
+    V::store(item + i, x - s * (e * y + l * x));
+    V::store(user + i, y - s * (e * x + l * y));
+  }
+  for (; i < K; ++i) {
+    T x     = item[i];
+    T y     = user[i];
+    item[i] = x - step * (error * y + lambda * x);
+    user[i] = y - step * (error * x + lambda * y);
+  }
+}
+
+} // namespace latent
+
 /**
  * Inner product of 2 vectors.
  *
- * Like std::inner_product but rewritten here to check vectorization
- *
  * @param first1 Pointer to beginning of vector 1
  * @param last1 Pointer to end of vector 1. Should be exactly LATENT_VECTOR_SIZE
  * away from first1
@@ -136,10 +237,7 @@ template <typename T>
 T innerProduct(T* __restrict__ first1, T* __restrict__ last1,
                T* __restrict__ first2, T init) {
   assert(first1 + LATENT_VECTOR_SIZE == last1);
-  for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
-    init += first1[i] * first2[i];
-  }
-  return init;
+  return latent::dot<LATENT_VECTOR_SIZE>(first1, first2, init);
 }
 
 template <typename T>
@@ -176,12 +274,8 @@ T doGradientUpdate(T* __restrict__ itemLatent, T* __restrict__ userLatent,
                          userLatent, -rating);
 
   // Take gradient step to reduce error
-  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
-    T prevItem = itemLatent[i];
-    T prevUser = userLatent[i];
-    itemLatent[i] -= step * (error * prevUser + l * prevItem);
-    userLatent[i] -= step * (error * prevItem + l * prevUser);
-  }
+  latent::gradientStep<LATENT_VECTOR_SIZE>(itemLatent, userLatent, error, l,
+                                           step);
 
   return error;
 }
@@ -23,6 +23,7 @@
 #include "galois/Galois.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
+#include "galois/graphs/SpMV.h"
 #include "galois/graphs/TypeTraits.h"
 
 // These implementations are based on the Push-based PageRank computation
@@ -33,11 +34,15 @@ const char* desc =
 
 constexpr static const unsigned CHUNK_SIZE = 16;
 
-enum Algo { Async, Sync }; // Async has better asbolute performance.
+enum Algo { Async, Sync, Frontier }; // Async has better asbolute performance.
 
 static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
                            cll::values(clEnumVal(Async, "Async"),
-                                       clEnumVal(Sync, "Sync"), clEnumValEnd),
+                                       clEnumVal(Sync, "Sync"),
+                                       clEnumVal(Frontier,
+                                                 "Sync as sparse matrix-"
+                                                 "sparse vector products"),
+                                       clEnumValEnd),
                            cll::init(Async));
 
 struct LNode {
@@ -181,6 +186,67 @@ void syncPageRank(Graph& graph) {
   }
 }
 
+// Sync push where each round is y = A^T x for the sparse vector x of the
+// deltas of the active nodes
+void frontierPageRank(Graph& graph) {
+  galois::graphs::PlusTimes<PRTy> plusTimes;
+  galois::graphs::SparseVector<PRTy> deltas;
+  deltas.allocate(graph.size());
+  galois::graphs::SparseVector<PRTy> pushed;
+  pushed.allocate(graph.size());
+
+  galois::InsertBag<GNode> activeNodes;
+  galois::do_all(galois::iterate(graph),
+                 [&](const GNode& src) { activeNodes.push(src); },
+                 galois::no_stats());
+
+  size_t iter = 0;
+  for (; !activeNodes.empty() && iter < maxIterations; ++iter) {
+
+    galois::do_all(galois::iterate(activeNodes),
+                   [&](const GNode& src) {
+                     constexpr const galois::MethodFlag flag =
+                         galois::MethodFlag::UNPROTECTED;
+                     LNode& sdata = graph.getData(src, flag);
+
+                     if (sdata.residual > tolerance) {
+                       PRTy oldResidual = sdata.residual;
+                       sdata.value += oldResidual;
+                       sdata.residual = 0.0;
+
+                       int src_nout = std::distance(graph.edge_begin(src, flag),
+                                                    graph.edge_end(src, flag));
+                       if (src_nout > 0) {
+                         deltas.set(src, oldResidual * ALPHA / src_nout);
+                       }
+                     }
+                   },
+                   galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+                   galois::loopname("CollectDeltas"), galois::no_stats());
+
+    activeNodes.clear();
+    galois::graphs::spmspv(graph, deltas, pushed, plusTimes);
+    deltas.clear();
+
+    galois::do_all(galois::iterate(pushed.indices()),
+                   [&](uint32_t dst) {
+                     LNode& ddata   = graph.getData(dst);
+                     ddata.residual = ddata.residual + pushed[dst];
+                     if (ddata.residual > tolerance) {
+                       activeNodes.push(dst);
+                     }
+                   },
+                   galois::steal(), galois::chunk_size<CHUNK_SIZE>(),
+                   galois::loopname("ApplyDeltas"), galois::no_stats());
+    pushed.clear();
+  }
+
+  if (iter >= maxIterations) {
+    std::cerr << "ERROR: failed to converge in " << iter << " iterations"
+              << std::endl;
+  }
+}
+
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   LonestarStart(argc, argv, name, desc, url);
@@ -219,6 +285,11 @@ int main(int argc, char** argv) {
     syncPageRank(graph);
     break;
 
+  case Frontier:
+    std::cout << "Running Frontier push version,";
+    frontierPageRank(graph);
+    break;
+
   default:
     std::abort();
   }
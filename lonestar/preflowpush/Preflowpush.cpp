@@ -62,6 +62,16 @@ static cll::opt<int>
                cll::desc("relabel interval X: relabel every X iterations "
                          "(default 0 uses default interval)"),
                cll::init(0));
+static cll::opt<bool>
+    useChaseLev("useChaseLev",
+                cll::desc("Use the work-stealing ChaseLevLIFO worklist instead "
+                          "of PerSocketChunkFIFO (nondet only)"),
+                cll::init(false));
+static cll::opt<bool>
+    useMultiQueue("useMultiQueue",
+                  cll::desc("With -useHLOrder, schedule by height with a "
+                            "MultiQueue instead of OBIM (nondet only)"),
+                  cll::init(false));
 static cll::opt<DetAlgo> detAlgo(
     cll::desc("Deterministic algorithm:"),
     cll::values(clEnumVal(nondet, "Non-deterministic (default)"),
@@ -513,6 +523,8 @@ struct PreflowPush {
     typedef galois::worklists::OrderedByIntegerMetric<decltype(obimIndexer),
                                                       Chunk>
         OBIM;
+    typedef galois::worklists::MultiQueue<decltype(obimIndexer)> MQ;
+    typedef galois::worklists::ChaseLevLIFO<> ChaseLev;
 
     galois::InsertBag<GNode> initial;
     initializePreflow(initial);
@@ -523,8 +535,12 @@ struct PreflowPush {
       Counter counter;
       switch (detAlgo) {
       case nondet:
-        if (useHLOrder) {
+        if (useHLOrder && useMultiQueue) {
+          nonDetDischarge(initial, counter, galois::wl<MQ>(obimIndexer));
+        } else if (useHLOrder) {
           nonDetDischarge(initial, counter, galois::wl<OBIM>(obimIndexer));
+        } else if (useChaseLev) {
+          nonDetDischarge(initial, counter, galois::wl<ChaseLev>());
         } else {
           nonDetDischarge(initial, counter, galois::wl<Chunk>());
         }
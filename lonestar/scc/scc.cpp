@@ -0,0 +1,611 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/AtomicHelpers.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/UnionFind.h"
+#include "galois/graphs/LCGraph.h"
+#include "Lonestar/BoilerPlate.h"
+#include "llvm/Support/CommandLine.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+const char* name = "Strongly Connected Components";
+const char* desc =
+    "Computes the strongly connected components of a directed graph";
+const char* url = 0;
+
+/******************************************************************************/
+/* Declaration of command line arguments */
+/******************************************************************************/
+namespace cll = llvm::cl;
+
+static cll::opt<std::string>
+    inputFilename(cll::Positional, cll::desc("<input file (directed)>"),
+                  cll::Required);
+
+static cll::opt<std::string> transposeGraphName(
+    "graphTranspose",
+    cll::desc("Transpose of the input graph (computed in memory if not "
+              "given)"));
+
+//! Output file for the component of every node
+static cll::opt<std::string>
+    outName("o", cll::desc("output file for the component of every node"));
+
+static cll::opt<bool> skipTrim2("noTrim2",
+                                cll::desc("Skip the trim-2 pass"),
+                                cll::init(false));
+
+/******************************************************************************/
+/* Graph structure declarations + other inits */
+/******************************************************************************/
+/**
+ * A node's component is its union-find representative, a node of the same
+ * component, and color ends up as the representative's id. While the node is
+ * live, i.e., its component is not known yet, inDegree and outDegree count
+ * its edges from and to the other live nodes.
+ */
+struct Node : public galois::UnionFindNode<Node> {
+  using component_type = Node*;
+
+  std::atomic<uint32_t> color;
+  std::atomic<uint32_t> inDegree;
+  std::atomic<uint32_t> outDegree;
+  std::atomic<bool> done;
+
+  Node() : galois::UnionFindNode<Node>(const_cast<Node*>(this)) {}
+
+  component_type component() { return this->get(); }
+
+  //! Makes this node, which must be its own representative, a direct child
+  //! of root; flat trees, as a component is found in one piece
+  void link(Node* root) { m_component.store(root, std::memory_order_relaxed); }
+
+  //! Marks the node done; true for the one caller that does so
+  bool claim() {
+    return !done.load(std::memory_order_relaxed) &&
+           !done.exchange(true, std::memory_order_relaxed);
+  }
+
+  bool isDone() const { return done.load(std::memory_order_relaxed); }
+};
+
+using Graph =
+    galois::graphs::LC_CSR_Graph<Node, void>::with_no_lockable<true>::type;
+using TransposeGraph =
+    galois::graphs::LC_CSR_Graph<void, void>::with_no_lockable<true>::type;
+using GNode = Graph::GraphNode;
+
+//! Chunksize for for_each worklist: best chunksize will depend on input
+constexpr static const unsigned CHUNK_SIZE = 64u;
+constexpr static const uint32_t NO_COLOR = std::numeric_limits<uint32_t>::max();
+constexpr static const galois::MethodFlag flag =
+    galois::MethodFlag::UNPROTECTED;
+
+/******************************************************************************/
+/* Functions for running the algorithm */
+/******************************************************************************/
+/**
+ * Forward-backward plus coloring (Hong et al., SC'13; Slota et al.,
+ * IPDPS'14). Trim-1 repeatedly removes the nodes without live in- or
+ * out-neighbors, which are components of their own; trim-2 removes the
+ * 2-cycles that are a component by themselves. One forward-backward search
+ * from a high degree pivot then finds the giant component, if any, as the
+ * nodes that the pivot both reaches and is reached from. The rest of the
+ * graph falls apart into many small components, which coloring finds a batch
+ * at a time: the largest id that reaches each live node is propagated along
+ * the out-edges, and each node whose color is its own id is the root of a
+ * component, the nodes of its color from which it is reachable, found with a
+ * backward search that stays within the color. Trim-1 runs again after every
+ * other phase.
+ */
+class SCC {
+  Graph& graph;
+  TransposeGraph& transpose;
+
+  galois::GAccumulator<size_t> trimmed;
+  size_t trimmedPairs = 0;
+  size_t pivotSize    = 0;
+  size_t colorRounds  = 0;
+
+  Node& data(GNode n) { return graph.getData(n, flag); }
+
+  //! Ends the search for the component of n, which holds n alone
+  void single(GNode n) { data(n).color.store(n, std::memory_order_relaxed); }
+
+  /**
+   * Removes the newly done nodes in removed from the degrees of their live
+   * neighbors, and keeps trimming the nodes that are left without live in-
+   * or out-neighbors until there are none.
+   */
+  void trim1(galois::InsertBag<GNode>& removed) {
+    galois::for_each(
+        galois::iterate(removed),
+        [&](GNode n, auto& ctx) {
+          for (auto e : graph.edges(n, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            Node& dd  = data(dst);
+            if (!dd.isDone() && galois::atomicSubtract(dd.inDegree, 1u) == 1 &&
+                dd.claim()) {
+              single(dst);
+              trimmed += 1;
+              ctx.push(dst);
+            }
+          }
+          for (auto e : transpose.edges(n, flag)) {
+            GNode src = transpose.getEdgeDst(e);
+            Node& sd  = data(src);
+            if (!sd.isDone() &&
+                galois::atomicSubtract(sd.outDegree, 1u) == 1 && sd.claim()) {
+              single(src);
+              trimmed += 1;
+              ctx.push(src);
+            }
+          }
+        },
+        galois::no_conflicts(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("Trim1"));
+    removed.clear();
+  }
+
+  /**
+   * Recounts the degrees of the live nodes in range and trims. After most of
+   * the graph is removed at once, this is cheaper than having trim1 retire
+   * the removed nodes, as it only scans the edges of the nodes left.
+   *
+   * @param anyDone false if no node is done yet, so only self loops need to
+   * be left out of the counts
+   */
+  template <typename R>
+  void recount(R& range, bool anyDone = true) {
+    galois::do_all(
+        galois::iterate(range),
+        [&](GNode n) {
+          Node& nd = data(n);
+          if (nd.isDone())
+            return;
+          uint32_t out = 0, in = 0;
+          for (auto e : graph.edges(n, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            out += dst != n && !(anyDone && data(dst).isDone());
+          }
+          for (auto e : transpose.edges(n, flag)) {
+            GNode src = transpose.getEdgeDst(e);
+            in += src != n && !(anyDone && data(src).isDone());
+          }
+          nd.outDegree = out;
+          nd.inDegree  = in;
+        },
+        galois::steal(), galois::loopname("CountDegrees"));
+
+    // nodes are only marked once all degrees are counted
+    galois::InsertBag<GNode> removed;
+    galois::do_all(galois::iterate(range),
+                   [&](GNode n) {
+                     Node& nd = data(n);
+                     if (!nd.isDone() && (!nd.inDegree || !nd.outDegree)) {
+                       nd.done = true;
+                       single(n);
+                       trimmed += 1;
+                       removed.push(n);
+                     }
+                   },
+                   galois::loopname("Trim1Seed"));
+    trim1(removed);
+  }
+
+  //! The only live node among the neighbors of n in g, or n if there is none
+  template <typename G>
+  GNode onlyLiveNeighbor(G& g, GNode n) {
+    for (auto e : g.edges(n, flag)) {
+      GNode other = g.getEdgeDst(e);
+      if (other != n && !data(other).isDone())
+        return other;
+    }
+    return n;
+  }
+
+  /**
+   * Removes each pair of live nodes that are each other's only live in-
+   * neighbor, or each other's only live out-neighbor. Pairs are disjoint, and
+   * the degrees stay fixed during the loop, so the smaller node of each pair
+   * can remove it without synchronization.
+   */
+  void trim2(galois::InsertBag<GNode>& live) {
+    galois::InsertBag<GNode> removed;
+    galois::GAccumulator<size_t> pairs;
+    galois::do_all(
+        galois::iterate(live),
+        [&](GNode u) {
+          Node& ud = data(u);
+          if (ud.isDone())
+            return;
+          GNode v = u;
+          if (ud.inDegree == 1) {
+            GNode w = onlyLiveNeighbor(transpose, u);
+            if (u < w && data(w).inDegree == 1 &&
+                onlyLiveNeighbor(transpose, w) == u)
+              v = w;
+          }
+          if (v == u && ud.outDegree == 1) {
+            GNode w = onlyLiveNeighbor(graph, u);
+            if (u < w && data(w).outDegree == 1 &&
+                onlyLiveNeighbor(graph, w) == u)
+              v = w;
+          }
+          if (v == u)
+            return;
+          Node& vd = data(v);
+          ud.merge(&vd);
+          ud.color = u;
+          vd.color = u;
+          ud.done  = true;
+          vd.done  = true;
+          removed.push(u);
+          removed.push(v);
+          pairs += 1;
+        },
+        galois::steal(), galois::loopname("Trim2"));
+    trimmedPairs += pairs.reduce();
+    trim1(removed);
+  }
+
+  //! Live nodes of live, as they may have been removed since it was filled
+  void compact(galois::InsertBag<GNode>*& live, galois::InsertBag<GNode>*& next) {
+    galois::do_all(galois::iterate(*live),
+                   [&](GNode n) {
+                     if (!data(n).isDone())
+                       next->push(n);
+                   },
+                   galois::loopname("Compact"));
+    live->clear();
+    std::swap(live, next);
+  }
+
+  /**
+   * Backward search on the transpose from the roots in frontier, which must
+   * already be claimed, through the live nodes of the same color as the root
+   * they are reached from; each node reached joins its root's component.
+   * Fills removed with the roots and the nodes reached.
+   */
+  void backward(galois::InsertBag<GNode>& roots,
+                galois::InsertBag<GNode>& removed, const char* loopname) {
+    galois::for_each(
+        galois::iterate(roots),
+        [&](GNode n, auto& ctx) {
+          uint32_t c = data(n).color.load(std::memory_order_relaxed);
+          removed.push(n);
+          for (auto e : transpose.edges(n, flag)) {
+            GNode src = transpose.getEdgeDst(e);
+            Node& sd  = data(src);
+            if (sd.color.load(std::memory_order_relaxed) == c && sd.claim()) {
+              sd.link(&data(c));
+              ctx.push(src);
+            }
+          }
+        },
+        galois::no_conflicts(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname(loopname));
+  }
+
+  /**
+   * Forward-backward search from the live node with the largest product of
+   * live in- and out-degree, which is most likely in the giant component.
+   */
+  void forwardBackward(galois::InsertBag<GNode>& live) {
+    if (live.empty())
+      return;
+    galois::GReduceMax<uint64_t> best;
+    galois::do_all(galois::iterate(live),
+                   [&](GNode n) {
+                     Node& nd = data(n);
+                     if (nd.isDone())
+                       return;
+                     uint64_t score =
+                         std::min<uint64_t>(uint64_t(nd.inDegree) * nd.outDegree,
+                                            std::numeric_limits<uint32_t>::max());
+                     best.update(score << 32 | n);
+                   },
+                   galois::loopname("SelectPivot"));
+    GNode pivot = best.reduce() & std::numeric_limits<uint32_t>::max();
+    if (data(pivot).isDone())
+      return;
+
+    // the forward search colors the nodes it reaches with the pivot
+    galois::InsertBag<GNode> start;
+    data(pivot).color = pivot;
+    start.push(pivot);
+    galois::for_each(
+        galois::iterate(start),
+        [&](GNode n, auto& ctx) {
+          for (auto e : graph.edges(n, flag)) {
+            GNode dst = graph.getEdgeDst(e);
+            Node& dd  = data(dst);
+            if (!dd.isDone() &&
+                dd.color.load(std::memory_order_relaxed) != pivot &&
+                dd.color.exchange(pivot, std::memory_order_relaxed) != pivot)
+              ctx.push(dst);
+          }
+        },
+        galois::no_conflicts(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("Forward"));
+
+    galois::InsertBag<GNode> removed;
+    data(pivot).claim();
+    backward(start, removed, "Backward");
+    pivotSize = std::distance(removed.begin(), removed.end());
+  }
+
+  //! Coloring rounds until every node is done
+  void coloring(galois::InsertBag<GNode>*& live, galois::InsertBag<GNode>*& next) {
+    galois::InsertBag<GNode> roots;
+    galois::InsertBag<GNode> removed;
+
+    for (compact(live, next); !live->empty(); compact(live, next)) {
+      ++colorRounds;
+      galois::do_all(galois::iterate(*live),
+                     [&](GNode n) { data(n).color = n; },
+                     galois::loopname("ColorInit"));
+
+      // each node ends up with the largest id that reaches it
+      galois::for_each(
+          galois::iterate(*live),
+          [&](GNode n, auto& ctx) {
+            uint32_t c = data(n).color.load(std::memory_order_relaxed);
+            for (auto e : graph.edges(n, flag)) {
+              GNode dst = graph.getEdgeDst(e);
+              Node& dd  = data(dst);
+              if (!dd.isDone() && galois::atomicMax(dd.color, c) < c)
+                ctx.push(dst);
+            }
+          },
+          galois::no_conflicts(), galois::chunk_size<CHUNK_SIZE>(),
+          galois::loopname("ColorPropagate"));
+
+      galois::do_all(galois::iterate(*live),
+                     [&](GNode n) {
+                       Node& nd = data(n);
+                       if (nd.color == n) {
+                         nd.done = true;
+                         roots.push(n);
+                       }
+                     },
+                     galois::loopname("ColorRoots"));
+
+      backward(roots, removed, "ColorBackward");
+      roots.clear();
+      trim1(removed);
+    }
+  }
+
+public:
+  SCC(Graph& g, TransposeGraph& t) : graph(g), transpose(t) {}
+
+  void operator()() {
+    galois::InsertBag<GNode> bags[2];
+    galois::InsertBag<GNode>* live = &bags[0];
+    galois::InsertBag<GNode>* next = &bags[1];
+
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     Node& nd = data(n);
+                     nd.done  = false;
+                     nd.color = NO_COLOR;
+                   },
+                   galois::loopname("Initialize"));
+    recount(graph, false);
+    galois::do_all(galois::iterate(graph),
+                   [&](GNode n) {
+                     if (!data(n).isDone())
+                       live->push(n);
+                   },
+                   galois::loopname("Live"));
+
+    if (!skipTrim2) {
+      trim2(*live);
+      compact(live, next);
+    }
+    forwardBackward(*live);
+    compact(live, next);
+    recount(*live);
+    coloring(live, next);
+  }
+
+  void report() {
+    galois::runtime::reportStat_Single("SCC", "TrimmedNodes",
+                                       trimmed.reduce());
+    galois::runtime::reportStat_Single("SCC", "TrimmedPairs", trimmedPairs);
+    galois::runtime::reportStat_Single("SCC", "PivotComponentSize", pivotSize);
+    galois::runtime::reportStat_Single("SCC", "ColorRounds", colorRounds);
+  }
+};
+
+/******************************************************************************/
+/* Sanity check operations */
+/******************************************************************************/
+/**
+ * Prints the number of components and the size of the largest one.
+ */
+void printComponents(Graph& graph) {
+  galois::LargeArray<std::atomic<uint32_t>> sizes;
+  sizes.allocateInterleaved(graph.size());
+  galois::do_all(galois::iterate(size_t(0), graph.size()),
+                 [&](size_t i) { sizes.constructAt(i, 0u); },
+                 galois::no_stats());
+
+  galois::GAccumulator<size_t> reps;
+  galois::GReduceMax<uint32_t> largest;
+  galois::do_all(galois::iterate(graph),
+                 [&](GNode n) {
+                   Node& nd = graph.getData(n, flag);
+                   if (nd.isRep())
+                     reps += 1;
+                   uint32_t size = ++sizes[nd.color.load()];
+                   largest.update(size);
+                 },
+                 galois::loopname("CountComponents"));
+
+  std::cout << "Total components: " << reps.reduce()
+            << " (largest size: " << largest.reduce() << ")\n";
+}
+
+/**
+ * Checks that each node's color is the id of its representative, and that
+ * the components are those of a serial Tarjan's algorithm.
+ */
+bool verify(Graph& graph) {
+  size_t numNodes = graph.size();
+  for (GNode n : graph) {
+    Node& nd = graph.getData(n, flag);
+    if (nd.color >= numNodes ||
+        nd.find() != &graph.getData(nd.color.load(), flag)) {
+      std::cerr << "node " << n << " has color " << nd.color
+                << " but a different representative\n";
+      return false;
+    }
+  }
+
+  // iterative Tarjan's algorithm
+  const uint32_t UNSEEN = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> index(numNodes, UNSEEN), low(numNodes);
+  std::vector<uint32_t> component(numNodes, UNSEEN);
+  std::vector<GNode> stack;
+  std::vector<std::pair<GNode, Graph::edge_iterator>> calls;
+  uint32_t nextIndex = 0, numComponents = 0;
+
+  for (GNode root : graph) {
+    if (index[root] != UNSEEN)
+      continue;
+    index[root] = low[root] = nextIndex++;
+    stack.push_back(root);
+    calls.emplace_back(root, graph.edge_begin(root, flag));
+    while (!calls.empty()) {
+      GNode n  = calls.back().first;
+      auto& ii = calls.back().second;
+      if (ii != graph.edge_end(n, flag)) {
+        GNode dst = graph.getEdgeDst(*ii++);
+        if (index[dst] == UNSEEN) {
+          index[dst] = low[dst] = nextIndex++;
+          stack.push_back(dst);
+          calls.emplace_back(dst, graph.edge_begin(dst, flag));
+        } else if (component[dst] == UNSEEN) {
+          low[n] = std::min(low[n], index[dst]);
+        }
+        continue;
+      }
+      calls.pop_back();
+      if (!calls.empty()) {
+        GNode parent = calls.back().first;
+        low[parent]  = std::min(low[parent], low[n]);
+      }
+      if (low[n] == index[n]) {
+        GNode m;
+        do {
+          m = stack.back();
+          stack.pop_back();
+          component[m] = numComponents;
+        } while (m != n);
+        ++numComponents;
+      }
+    }
+  }
+
+  // the two partitions agree if the mapping between them is a bijection
+  std::vector<uint32_t> colorOf(numComponents, UNSEEN);
+  std::vector<uint32_t> componentOf(numNodes, UNSEEN);
+  for (GNode n : graph) {
+    uint32_t c = graph.getData(n, flag).color;
+    uint32_t t = component[n];
+    if (colorOf[t] == UNSEEN)
+      colorOf[t] = c;
+    if (componentOf[c] == UNSEEN)
+      componentOf[c] = t;
+    if (colorOf[t] != c || componentOf[c] != t) {
+      std::cerr << "node " << n << " is in component " << c
+                << " but should be with the nodes of " << colorOf[t] << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url);
+
+  Graph graph;
+  TransposeGraph transpose;
+
+  std::cout << "Reading from file: " << inputFilename << std::endl;
+  galois::graphs::readGraph(graph, inputFilename);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges" << std::endl;
+  if (transposeGraphName.empty()) {
+    galois::graphs::readGraph(transpose, inputFilename);
+    transpose.transpose("SCC");
+  } else {
+    std::cout << "Reading transpose from file: " << transposeGraphName
+              << std::endl;
+    galois::graphs::readGraph(transpose, transposeGraphName);
+  }
+  if (transpose.size() != graph.size() ||
+      transpose.sizeEdges() != graph.sizeEdges()) {
+    GALOIS_DIE("transpose does not match the input graph");
+  }
+
+  galois::preAlloc(numThreads + (3 * graph.size() * sizeof(GNode)) /
+                                    galois::runtime::pagePoolSize());
+  galois::reportPageAlloc("MeminfoPre");
+
+  SCC scc(graph, transpose);
+  galois::StatTimer execTime("Timer_0");
+  execTime.start();
+  scc();
+  execTime.stop();
+
+  galois::reportPageAlloc("MeminfoPost");
+  scc.report();
+  printComponents(graph);
+
+  if (!outName.empty()) {
+    std::ofstream output(outName);
+    for (GNode n : graph)
+      output << n << " " << graph.getData(n, flag).color << "\n";
+  }
+
+  if (!skipVerify) {
+    if (verify(graph)) {
+      std::cout << "Verification successful.\n";
+    } else {
+      GALOIS_DIE("verification failed");
+    }
+  }
+
+  return 0;
+}
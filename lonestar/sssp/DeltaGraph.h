@@ -0,0 +1,218 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef _SSSP_DELTA_GRAPH_H_
+#define _SSSP_DELTA_GRAPH_H_
+
+#include "galois/Galois.h"
+#include "galois/ParallelSTL.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+/**
+ * Weighted graph that takes batches of edge insertions and deletions on top
+ * of an immutable CSR graph. Inserted edges are kept in a per-node overlay;
+ * a deleted CSR edge keeps its slot with the weight DELETED, which edge
+ * iteration skips. If a transpose of the CSR graph is given, in-edges are
+ * kept up to date the same way.
+ *
+ * Updates are applied in parallel over their source (and destination)
+ * nodes; edge iteration must not run concurrently with apply.
+ *
+ * @tparam OutGraph CSR graph with the edge weights as edge data
+ * @tparam InGraph its transpose
+ */
+template <typename OutGraph, typename InGraph = OutGraph>
+class DeltaGraph {
+public:
+  using GNode  = typename OutGraph::GraphNode;
+  using Weight = typename OutGraph::edge_data_type;
+
+  constexpr static const Weight DELETED = std::numeric_limits<Weight>::max();
+
+  //! An inserted edge, stored at the other endpoint
+  struct Edge {
+    GNode node;
+    Weight weight;
+  };
+
+  //! Inserts or deletes one edge src -> dst
+  struct Update {
+    GNode src;
+    GNode dst;
+    //! for deletions, set by apply to the weight of the edge deleted
+    Weight weight;
+    bool insert;
+    //! set by apply: false for a deletion of an edge that does not exist,
+    //! and for an insertion and a deletion that cancel out
+    bool applied;
+  };
+
+private:
+  constexpr static const galois::MethodFlag flag =
+      galois::MethodFlag::UNPROTECTED;
+
+  OutGraph& out;
+  InGraph* in;
+  std::vector<std::vector<Edge>> addedOut;
+  std::vector<std::vector<Edge>> addedIn;
+
+  //! Removes one edge to node from the overlay list, false if there is none
+  static bool eraseAdded(std::vector<Edge>& added, GNode node, Weight& weight,
+                         bool anyWeight) {
+    for (auto& e : added) {
+      if (e.node == node && (anyWeight || e.weight == weight)) {
+        weight = e.weight;
+        e      = added.back();
+        added.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  //! Marks one CSR edge of g from n to node deleted, false if there is none
+  template <typename G>
+  static bool eraseCSR(G& g, GNode n, GNode node, Weight& weight,
+                       bool anyWeight) {
+    for (auto e : g.edges(n, flag)) {
+      Weight& w = g.getEdgeData(e, flag);
+      if (g.getEdgeDst(e) == node && w != DELETED &&
+          (anyWeight || w == weight)) {
+        weight = w;
+        w      = DELETED;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Sorts batch by key and calls f(begin, end) on each run of updates with
+   * the same key, in parallel.
+   */
+  template <typename K, typename F>
+  static void forEachGroup(std::vector<Update>& batch, K key, F f) {
+    galois::ParallelSTL::sort(batch.begin(), batch.end(),
+                              [&](const Update& a, const Update& b) {
+                                return key(a) < key(b);
+                              });
+    galois::do_all(galois::iterate(size_t(0), batch.size()),
+                   [&](size_t i) {
+                     if (i > 0 && key(batch[i - 1]) == key(batch[i]))
+                       return;
+                     size_t j = i + 1;
+                     while (j < batch.size() && key(batch[j]) == key(batch[i]))
+                       ++j;
+                     f(batch.begin() + i, batch.begin() + j);
+                   },
+                   galois::steal(), galois::no_stats(),
+                   galois::loopname("DeltaGraph-Apply"));
+  }
+
+public:
+  //! @param transpose transpose of g, or null if in-edges are not needed
+  DeltaGraph(OutGraph& g, InGraph* transpose)
+      : out(g), in(transpose), addedOut(g.size()),
+        addedIn(transpose ? g.size() : 0) {}
+
+  size_t size() const { return out.size(); }
+
+  bool hasInEdges() const { return in != nullptr; }
+
+  /**
+   * Applies the updates of batch, reordering it. A deletion removes one
+   * edge from src to dst, if any, of whatever weight. If the batch also
+   * inserts such an edge, the deletion cancels that insertion instead, and
+   * neither is applied.
+   */
+  void apply(std::vector<Update>& batch) {
+    forEachGroup(batch, [](const Update& u) { return u.src; },
+                 [&](auto begin, auto end) {
+                   for (auto u = begin; u != end; ++u) {
+                     if (u->insert) {
+                       addedOut[u->src].push_back(Edge{u->dst, u->weight});
+                       u->applied = true;
+                     }
+                   }
+                   for (auto u = begin; u != end; ++u) {
+                     if (u->insert)
+                       continue;
+                     auto ins = std::find_if(begin, end, [&](const Update& o) {
+                       return o.insert && o.applied && o.dst == u->dst;
+                     });
+                     if (ins != end) {
+                       eraseAdded(addedOut[u->src], u->dst, ins->weight, false);
+                       ins->applied = false;
+                       u->applied   = false;
+                       continue;
+                     }
+                     u->applied =
+                         eraseAdded(addedOut[u->src], u->dst, u->weight, true) ||
+                         eraseCSR(out, u->src, u->dst, u->weight, true);
+                   }
+                 });
+    if (!in)
+      return;
+
+    // the reverse of each edge changed above, matched by weight
+    forEachGroup(batch, [](const Update& u) { return u.dst; },
+                 [&](auto begin, auto end) {
+                   for (auto u = begin; u != end; ++u) {
+                     if (!u->applied)
+                       continue;
+                     if (u->insert) {
+                       addedIn[u->dst].push_back(Edge{u->src, u->weight});
+                     } else {
+                       Weight w = u->weight;
+                       if (!eraseAdded(addedIn[u->dst], u->src, w, false))
+                         eraseCSR(*in, u->dst, u->src, w, false);
+                     }
+                   }
+                 });
+  }
+
+  //! Calls f(dst, weight) for every out-edge of n
+  template <typename F>
+  void forEachOut(GNode n, F f) {
+    for (auto e : out.edges(n, flag)) {
+      Weight w = out.getEdgeData(e, flag);
+      if (w != DELETED)
+        f(out.getEdgeDst(e), w);
+    }
+    for (const Edge& e : addedOut[n])
+      f(e.node, e.weight);
+  }
+
+  //! Calls f(src, weight) for every in-edge of n; needs the transpose
+  template <typename F>
+  void forEachIn(GNode n, F f) {
+    for (auto e : in->edges(n, flag)) {
+      Weight w = in->getEdgeData(e, flag);
+      if (w != DELETED)
+        f(in->getEdgeDst(e), w);
+    }
+    for (const Edge& e : addedIn[n])
+      f(e.node, e.weight);
+  }
+};
+
+#endif
@@ -0,0 +1,489 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Bag.h"
+#include "galois/LargeArray.h"
+#include "galois/Reduction.h"
+#include "galois/Timer.h"
+#include "galois/graphs/LCGraph.h"
+#include "llvm/Support/CommandLine.h"
+
+#include "Lonestar/BoilerPlate.h"
+#include "Lonestar/BFS_SSSP.h"
+#include "DeltaGraph.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace cll = llvm::cl;
+
+static const char* name = "Incremental Single Source Shortest Path";
+static const char* desc =
+    "Maintains the shortest paths from a source node in a directed graph "
+    "under batches of edge insertions and deletions, and compares the repair "
+    "of each batch with a recomputation from scratch";
+static const char* url = "single_source_shortest_path";
+
+static cll::opt<std::string>
+    filename(cll::Positional, cll::desc("<input graph>"), cll::Required);
+static cll::opt<std::string> transposeGraphName(
+    "graphTranspose",
+    cll::desc("Transpose of the input graph, needed for deletions (computed "
+              "in memory if not given)"));
+static cll::opt<unsigned int>
+    startNode("startNode",
+              cll::desc("Node to start search from (default value 0)"),
+              cll::init(0));
+static cll::opt<unsigned int>
+    stepShift("delta",
+              cll::desc("Shift value for the deltastep (default value 13)"),
+              cll::init(13));
+static cll::opt<bool>
+    unitWeights("bfs", cll::desc("Ignore edge weights, i.e., maintain BFS "
+                                 "levels (-delta is then ignored)"),
+                cll::init(false));
+static cll::opt<std::string> streamFile(
+    "stream",
+    cll::desc("File of edge updates, one per line: \"a src dst weight\" to "
+              "insert an edge or \"d src dst\" to delete one (random updates "
+              "if not given)"));
+static cll::opt<unsigned int>
+    batchSize("batchSize", cll::desc("Updates per batch (default 10000)"),
+              cll::init(10000));
+static cll::opt<unsigned int> numBatches(
+    "numBatches",
+    cll::desc("Number of random batches (default 10; ignored with -stream)"),
+    cll::init(10));
+static cll::opt<unsigned int> deletePercent(
+    "deletePercent",
+    cll::desc("Percentage of random updates that delete an edge (default 0)"),
+    cll::init(0));
+static cll::opt<unsigned int>
+    maxWeight("maxWeight",
+              cll::desc("Largest weight of a random edge (default 100)"),
+              cll::init(100));
+static cll::opt<unsigned int>
+    seed("seed", cll::desc("Seed of the random updates (default 0)"),
+         cll::init(0));
+static cll::opt<bool> recompute(
+    "recompute",
+    cll::desc("Also recompute the distances from scratch after every batch, "
+              "for comparison (default true)"),
+    cll::init(true));
+
+using Graph = galois::graphs::LC_CSR_Graph<void, uint32_t>::with_no_lockable<
+    true>::type::with_numa_alloc<true>::type;
+typedef Graph::GraphNode GNode;
+
+constexpr static const unsigned CHUNK_SIZE = 64u;
+
+using SSSP                 = BFS_SSSP<Graph, uint32_t, true>;
+using Dist                 = SSSP::Dist;
+using UpdateRequest        = SSSP::UpdateRequest;
+using UpdateRequestIndexer = SSSP::UpdateRequestIndexer;
+using Edges                = DeltaGraph<Graph>;
+using Update               = Edges::Update;
+
+namespace gwl = galois::worklists;
+using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
+using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+
+/**
+ * Shortest path distances from a source that are repaired after each batch
+ * of updates instead of recomputed.
+ *
+ * Each node's label packs its distance, in the upper half, with its parent
+ * in a shortest path tree, so that one CAS updates both and labels order by
+ * distance. Insertions seed the worklist with the heads of the new edges that
+ * shorten a path. A deleted edge only matters if it is a tree edge: the
+ * subtree below it loses its distances, each node of the subtree restarts
+ * from the best of its in-neighbors outside of the subtree, and is a seed if
+ * it has one. From the seeds, the usual delta-stepping relaxation with an
+ * OBIM worklist brings the distances back to a fixed point, touching only
+ * the part of the graph whose distances change.
+ *
+ * @tparam UNIT every edge has weight 1, i.e., these are BFS levels
+ */
+template <bool UNIT>
+class IncrementalSSSP {
+  using Label = uint64_t;
+
+  constexpr static const Dist INFINITY_DIST = SSSP::DIST_INFINITY;
+  constexpr static const GNode NO_PARENT    = ~GNode(0);
+
+  Edges& edges;
+  GNode source;
+  unsigned shift;
+  galois::LargeArray<std::atomic<Label>> labels;
+
+  static Label makeLabel(Dist d, GNode parent) {
+    return Label(d) << 32 | parent;
+  }
+  static Dist distOf(Label l) { return l >> 32; }
+  static GNode parentOf(Label l) { return GNode(l); }
+
+  static uint64_t weight(Edges::Weight w) { return UNIT ? 1 : w; }
+
+  std::atomic<Label>& label(GNode n) { return labels[n]; }
+
+  //! Lowers the distance of n to d through parent, if it is shorter
+  bool lower(GNode n, Dist d, GNode parent) {
+    Label old = label(n).load(std::memory_order_relaxed);
+    while (distOf(old) > d) {
+      if (label(n).compare_exchange_weak(old, makeLabel(d, parent),
+                                         std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  //! Delta-stepping from the seeds, whose labels are already set
+  void relax(galois::InsertBag<UpdateRequest>& seeds) {
+    galois::for_each(
+        galois::iterate(seeds),
+        [&](const UpdateRequest& item, auto& ctx) {
+          Dist sd = distOf(label(item.src).load(std::memory_order_relaxed));
+          if (sd < item.dist)
+            return;
+          edges.forEachOut(item.src, [&](GNode dst, Edges::Weight w) {
+            uint64_t nd = sd + weight(w);
+            if (nd < INFINITY_DIST && lower(dst, nd, item.src))
+              ctx.push(UpdateRequest(dst, nd));
+          });
+        },
+        galois::wl<OBIM>(UpdateRequestIndexer{shift}), galois::no_conflicts(),
+        galois::loopname("SSSP"));
+  }
+
+public:
+  IncrementalSSSP(Edges& e, GNode s, unsigned deltaShift)
+      : edges(e), source(s), shift(UNIT ? 0 : deltaShift) {
+    labels.allocateInterleaved(edges.size());
+  }
+
+  Dist distance(GNode n) { return distOf(label(n)); }
+
+  //! Computes the distances from scratch
+  void compute() {
+    galois::do_all(galois::iterate(size_t(0), edges.size()),
+                   [&](size_t n) {
+                     labels.constructAt(n, makeLabel(INFINITY_DIST, NO_PARENT));
+                   },
+                   galois::no_stats(), galois::loopname("InitLabels"));
+    label(source) = makeLabel(0, NO_PARENT);
+    galois::InsertBag<UpdateRequest> seeds;
+    seeds.push(UpdateRequest(source, 0));
+    relax(seeds);
+  }
+
+  /**
+   * Repairs the distances after batch has been applied to the graph.
+   * Deletions need the in-edges of the graph.
+   *
+   * @returns number of nodes whose distance was invalidated by deletions
+   */
+  size_t update(const std::vector<Update>& batch) {
+    // a node whose tree edge is deleted loses its distance; it keeps its
+    // parent, which marks it as an invalidated child of the parent
+    galois::InsertBag<GNode> roots;
+    galois::do_all(
+        galois::iterate(batch),
+        [&](const Update& u) {
+          if (u.insert || !u.applied)
+            return;
+          Label l = label(u.dst).load(std::memory_order_relaxed);
+          if (parentOf(l) == u.src && distOf(l) != INFINITY_DIST &&
+              label(u.dst).compare_exchange_strong(
+                  l, makeLabel(INFINITY_DIST, u.src)))
+            roots.push(u.dst);
+        },
+        galois::no_stats(), galois::loopname("DeletedTreeEdges"));
+
+    // and so does the rest of the subtree below it
+    galois::InsertBag<GNode> invalid;
+    galois::for_each(
+        galois::iterate(roots),
+        [&](GNode n, auto& ctx) {
+          invalid.push(n);
+          edges.forEachOut(n, [&](GNode c, Edges::Weight) {
+            Label l = label(c).load(std::memory_order_relaxed);
+            if (parentOf(l) == n && distOf(l) != INFINITY_DIST &&
+                label(c).compare_exchange_strong(
+                    l, makeLabel(INFINITY_DIST, n)))
+              ctx.push(c);
+          });
+        },
+        galois::no_conflicts(), galois::chunk_size<CHUNK_SIZE>(),
+        galois::loopname("Invalidate"));
+
+    // restart the invalidated nodes from their valid in-neighbors; all of
+    // them are read before any is written, so none restarts from another
+    struct Restart {
+      GNode node;
+      Label label;
+    };
+    galois::InsertBag<Restart> restarts;
+    galois::do_all(galois::iterate(invalid),
+                   [&](GNode n) {
+                     Label best = makeLabel(INFINITY_DIST, NO_PARENT);
+                     edges.forEachIn(n, [&](GNode src, Edges::Weight w) {
+                       Dist sd = distOf(label(src).load(
+                           std::memory_order_relaxed));
+                       uint64_t nd = sd + weight(w);
+                       if (sd != INFINITY_DIST && nd < INFINITY_DIST)
+                         best = std::min(best, makeLabel(nd, src));
+                     });
+                     restarts.push(Restart{n, best});
+                   },
+                   galois::steal(), galois::loopname("Restart"));
+
+    galois::InsertBag<UpdateRequest> seeds;
+    galois::do_all(galois::iterate(restarts),
+                   [&](const Restart& r) {
+                     label(r.node) = r.label;
+                     if (distOf(r.label) != INFINITY_DIST)
+                       seeds.push(UpdateRequest(r.node, distOf(r.label)));
+                   },
+                   galois::no_stats(), galois::loopname("RestartSeeds"));
+
+    galois::do_all(galois::iterate(batch),
+                   [&](const Update& u) {
+                     if (!u.insert || !u.applied)
+                       return;
+                     Dist sd = distance(u.src);
+                     uint64_t nd = sd + weight(u.weight);
+                     if (sd != INFINITY_DIST && nd < INFINITY_DIST &&
+                         lower(u.dst, nd, u.src))
+                       seeds.push(UpdateRequest(u.dst, nd));
+                   },
+                   galois::no_stats(), galois::loopname("InsertSeeds"));
+
+    relax(seeds);
+    return std::distance(invalid.begin(), invalid.end());
+  }
+};
+
+//! Source node of edge e
+GNode edgeSource(Graph& graph, uint64_t e) {
+  auto n = std::partition_point(
+      graph.begin(), graph.end(),
+      [&](GNode n) { return *graph.edge_end(n) <= e; });
+  return *n;
+}
+
+//! Random updates: insertions of edges between uniformly random nodes and
+//! deletions of uniformly random edges of the input graph
+std::vector<std::vector<Update>> randomStream(Graph& graph) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<GNode> node(0, graph.size() - 1);
+  std::uniform_int_distribution<uint64_t> edge(0, graph.sizeEdges() - 1);
+  std::uniform_int_distribution<uint32_t> weight(1, maxWeight);
+  std::uniform_int_distribution<unsigned> percent(0, 99);
+
+  std::vector<std::vector<Update>> batches(numBatches);
+  for (auto& batch : batches) {
+    for (size_t i = 0; i < batchSize; ++i) {
+      if (percent(gen) < deletePercent && graph.sizeEdges()) {
+        uint64_t e = edge(gen);
+        batch.push_back(
+            Update{edgeSource(graph, e), graph.getEdgeDst(e), 0, false, false});
+      } else {
+        batch.push_back(Update{node(gen), node(gen), weight(gen), true, false});
+      }
+    }
+  }
+  return batches;
+}
+
+std::vector<std::vector<Update>> readStream(Graph& graph) {
+  std::ifstream in(streamFile);
+  if (!in)
+    GALOIS_SYS_DIE("unable to open ", streamFile);
+
+  std::vector<std::vector<Update>> batches;
+  std::string line;
+  for (size_t lineNo = 1; std::getline(in, line); ++lineNo) {
+    std::istringstream fields(line);
+    char op;
+    uint64_t src, dst, w = 1;
+    if (!(fields >> op)) // blank line
+      continue;
+    if (!(fields >> src >> dst) || (op == 'a' && !(fields >> w)) ||
+        (op != 'a' && op != 'd') || src >= graph.size() ||
+        dst >= graph.size() || w >= Edges::DELETED) {
+      GALOIS_DIE("bad update on line ", lineNo, " of ", streamFile);
+    }
+    if (batches.empty() || batches.back().size() == batchSize)
+      batches.emplace_back();
+    batches.back().push_back(
+        Update{GNode(src), GNode(dst), uint32_t(w), op == 'a', false});
+  }
+  return batches;
+}
+
+template <bool UNIT>
+void run(Graph& graph, Graph* transpose, GNode source,
+         std::vector<std::vector<Update>>& batches) {
+  Edges edges(graph, transpose);
+  IncrementalSSSP<UNIT> incremental(edges, source, stepShift);
+  IncrementalSSSP<UNIT> scratch(edges, source, stepShift);
+
+  galois::StatTimer initial("InitialTime");
+  initial.start();
+  incremental.compute();
+  initial.stop();
+
+  uint64_t updateTime = 0, recomputeTime = 0;
+  size_t invalidated = 0, mismatches = 0;
+  for (size_t b = 0; b < batches.size(); ++b) {
+    std::vector<Update>& batch = batches[b];
+    galois::Timer applyTimer, updateTimer;
+    applyTimer.start();
+    edges.apply(batch);
+    applyTimer.stop();
+
+    updateTimer.start();
+    size_t invalid = incremental.update(batch);
+    updateTimer.stop();
+    updateTime += applyTimer.get_usec() + updateTimer.get_usec();
+    invalidated += invalid;
+
+    std::cout << "Batch " << b << ": " << batch.size() << " updates, "
+              << invalid << " nodes invalidated, update "
+              << (applyTimer.get_usec() + updateTimer.get_usec()) / 1000.0
+              << " ms";
+
+    bool last = b + 1 == batches.size();
+    if (recompute || (last && !skipVerify)) {
+      galois::Timer recomputeTimer;
+      recomputeTimer.start();
+      scratch.compute();
+      recomputeTimer.stop();
+      recomputeTime += recomputeTimer.get_usec();
+      std::cout << ", recompute " << recomputeTimer.get_usec() / 1000.0
+                << " ms";
+
+      if (!skipVerify) {
+        galois::GAccumulator<size_t> wrong;
+        galois::do_all(galois::iterate(size_t(0), graph.size()),
+                       [&](size_t n) {
+                         wrong += incremental.distance(n) !=
+                                  scratch.distance(n);
+                       },
+                       galois::no_stats(), galois::loopname("Compare"));
+        mismatches += wrong.reduce();
+      }
+    }
+    std::cout << "\n";
+  }
+
+  galois::runtime::reportStat_Single("IncrementalSSSP", "Batches",
+                                     batches.size());
+  galois::runtime::reportStat_Single("IncrementalSSSP", "InvalidatedNodes",
+                                     invalidated);
+  galois::runtime::reportStat_Single("IncrementalSSSP", "UpdateTimeUsec",
+                                     updateTime);
+  if (recompute) {
+    galois::runtime::reportStat_Single("IncrementalSSSP",
+                                       "RecomputeTimeUsec", recomputeTime);
+    std::cout << "Total update time " << updateTime / 1000.0
+              << " ms, recompute time " << recomputeTime / 1000.0 << " ms\n";
+  }
+
+  galois::GReduceMax<Dist> maxDist;
+  galois::GAccumulator<size_t> reached;
+  galois::do_all(galois::iterate(size_t(0), graph.size()),
+                 [&](size_t n) {
+                   Dist d = incremental.distance(n);
+                   if (d != SSSP::DIST_INFINITY) {
+                     maxDist.update(d);
+                     reached += 1;
+                   }
+                 },
+                 galois::no_stats(), galois::loopname("Sanity check"));
+  std::cout << "Reached " << reached.reduce() << " nodes, max dist "
+            << maxDist.reduce() << "\n";
+
+  if (!skipVerify) {
+    if (mismatches) {
+      GALOIS_DIE(mismatches, " distances differ from a recomputation");
+    }
+    std::cout << "Verification successful.\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  LonestarStart(argc, argv, name, desc, url);
+
+  Graph graph;
+  std::cout << "Reading from file: " << filename << std::endl;
+  galois::graphs::readGraph(graph, filename);
+  std::cout << "Read " << graph.size() << " nodes, " << graph.sizeEdges()
+            << " edges" << std::endl;
+
+  if (startNode >= graph.size()) {
+    GALOIS_DIE("failed to set source: ", startNode);
+  }
+  if (maxWeight < 1 || maxWeight >= Edges::DELETED) {
+    GALOIS_DIE("maxWeight must be in [1, ", Edges::DELETED, ")");
+  }
+  if (deletePercent > 100) {
+    GALOIS_DIE("deletePercent must be at most 100");
+  }
+
+  auto batches = streamFile.empty() ? randomStream(graph) : readStream(graph);
+  bool deletions = false;
+  for (auto& batch : batches)
+    for (auto& u : batch)
+      deletions |= !u.insert;
+
+  // deleted tree edges restart nodes from their in-neighbors
+  Graph transpose;
+  if (deletions) {
+    if (transposeGraphName.empty()) {
+      galois::graphs::readGraph(transpose, filename);
+      transpose.transpose("IncrementalSSSP");
+    } else {
+      std::cout << "Reading transpose from file: " << transposeGraphName
+                << std::endl;
+      galois::graphs::readGraph(transpose, transposeGraphName);
+    }
+  }
+
+  galois::preAlloc(numThreads +
+                   graph.size() * 64 / galois::runtime::pagePoolSize());
+  galois::reportPageAlloc("MeminfoPre");
+
+  galois::StatTimer Tmain;
+  Tmain.start();
+  if (unitWeights)
+    run<true>(graph, deletions ? &transpose : nullptr, startNode, batches);
+  else
+    run<false>(graph, deletions ? &transpose : nullptr, startNode, batches);
+  Tmain.stop();
+
+  galois::reportPageAlloc("MeminfoPost");
+  return 0;
+}
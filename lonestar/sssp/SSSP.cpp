@@ -64,12 +64,18 @@ enum Algo {
   dijkstraTile,
   dijkstra,
   topo,
-  topoTile
+  topoTile,
+  deltaTileAdaptive,
+  deltaStepAdaptive,
+  multiQueueTile,
+  multiQueue
 };
 
-const char* const ALGO_NAMES[] = {"deltaTile", "deltaStep",    "serDeltaTile",
-                                  "serDelta",  "dijkstraTile", "dijkstra",
-                                  "topo",      "topoTile"};
+const char* const ALGO_NAMES[] = {
+    "deltaTile",    "deltaStep", "serDeltaTile", "serDelta",
+    "dijkstraTile", "dijkstra",  "topo",         "topoTile",
+    "deltaTileAdaptive", "deltaStepAdaptive",
+    "multiQueueTile",    "multiQueue"};
 
 static cll::opt<Algo>
     algo("algo", cll::desc("Choose an algorithm:"),
@@ -79,7 +85,19 @@ static cll::opt<Algo>
                      clEnumVal(serDelta, "serDelta"),
                      clEnumVal(dijkstraTile, "dijkstraTile"),
                      clEnumVal(dijkstra, "dijkstra"), clEnumVal(topo, "topo"),
-                     clEnumVal(topoTile, "topoTile"), clEnumValEnd),
+                     clEnumVal(topoTile, "topoTile"),
+                     clEnumVal(deltaTileAdaptive,
+                               "deltaTile with a bucket width (-delta is the "
+                               "initial value) adapted at runtime"),
+                     clEnumVal(deltaStepAdaptive,
+                               "deltaStep with a bucket width (-delta is the "
+                               "initial value) adapted at runtime"),
+                     clEnumVal(multiQueueTile,
+                               "deltaTile scheduled by a MultiQueue instead "
+                               "of OBIM"),
+                     clEnumVal(multiQueue, "deltaStep scheduled by a "
+                                           "MultiQueue instead of OBIM"),
+                     clEnumValEnd),
          cll::init(deltaTile));
 
 // typedef galois::graphs::LC_InlineEdge_Graph<std::atomic<unsigned int>,
@@ -105,20 +123,22 @@ using ReqPushWrap          = SSSP::ReqPushWrap;
 using OutEdgeRangeFn       = SSSP::OutEdgeRangeFn;
 using TileRangeFn          = SSSP::TileRangeFn;
 
-template <typename T, typename P, typename R>
+namespace gwl = galois::worklists;
+using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
+using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+using AdaptiveOBIM =
+    gwl::AdaptiveOrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+using MQ = gwl::MultiQueue<UpdateRequestIndexer>;
+
+template <typename T, typename P, typename R, typename WL>
 void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
-                   const R& edgeRange) {
+                   const R& edgeRange, const WL& wl) {
 
   //! [reducible for self-defined stats]
   galois::GAccumulator<size_t> BadWork;
   //! [reducible for self-defined stats]
   galois::GAccumulator<size_t> WLEmptyWork;
 
-  namespace gwl = galois::worklists;
-
-  using PSchunk = gwl::PerSocketChunkFIFO<CHUNK_SIZE>;
-  using OBIM    = gwl::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
-
   graph.getData(source) = 0;
 
   galois::InsertBag<T> initBag;
@@ -167,8 +187,7 @@ void deltaStepAlgo(Graph& graph, GNode source, const P& pushWrap,
                        }
                      }
                    },
-                   galois::wl<OBIM>(UpdateRequestIndexer{stepShift}),
-                   galois::no_conflicts(), galois::loopname("SSSP"));
+                   wl, galois::no_conflicts(), galois::loopname("SSSP"));
 
   if (TRACK_WORK) {
     //! [report self-defined stats]
@@ -390,7 +409,8 @@ int main(int argc, char** argv) {
   galois::reportPageAlloc("MeminfoPre");
 
   if (algo == deltaStep || algo == deltaTile || algo == serDelta ||
-      algo == serDeltaTile) {
+      algo == serDeltaTile || algo == deltaStepAdaptive ||
+      algo == deltaTileAdaptive) {
     std::cout << "INFO: Using delta-step of " << (1 << stepShift) << "\n";
     std::cout
         << "WARNING: Performance varies considerably due to delta parameter.\n";
@@ -410,12 +430,38 @@ int main(int argc, char** argv) {
 
   switch (algo) {
   case deltaTile:
-    deltaStepAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
-                               TileRangeFn());
+    deltaStepAlgo<SrcEdgeTile>(
+        graph, source, SrcEdgeTilePushWrap{graph}, TileRangeFn(),
+        galois::wl<OBIM>(UpdateRequestIndexer{stepShift}));
     break;
   case deltaStep:
+    deltaStepAlgo<UpdateRequest>(
+        graph, source, ReqPushWrap(), OutEdgeRangeFn{graph},
+        galois::wl<OBIM>(UpdateRequestIndexer{stepShift}));
+    break;
+  case deltaTileAdaptive:
+    // the adaptive worklist buckets raw distances itself
+    deltaStepAlgo<SrcEdgeTile>(
+        graph, source, SrcEdgeTilePushWrap{graph}, TileRangeFn(),
+        galois::wl<AdaptiveOBIM>(UpdateRequestIndexer{0},
+                                 unsigned(stepShift)));
+    break;
+  case deltaStepAdaptive:
+    deltaStepAlgo<UpdateRequest>(
+        graph, source, ReqPushWrap(), OutEdgeRangeFn{graph},
+        galois::wl<AdaptiveOBIM>(UpdateRequestIndexer{0},
+                                 unsigned(stepShift)));
+    break;
+  case multiQueueTile:
+    // heaps order exact distances; there are no buckets to size
+    deltaStepAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
+                               TileRangeFn(),
+                               galois::wl<MQ>(UpdateRequestIndexer{0}));
+    break;
+  case multiQueue:
     deltaStepAlgo<UpdateRequest>(graph, source, ReqPushWrap(),
-                                 OutEdgeRangeFn{graph});
+                                 OutEdgeRangeFn{graph},
+                                 galois::wl<MQ>(UpdateRequestIndexer{0}));
     break;
   case serDeltaTile:
     serDeltaAlgo<SrcEdgeTile>(graph, source, SrcEdgeTilePushWrap{graph},
@@ -20,9 +20,11 @@
 #include "galois/Galois.h"
 #include "galois/Reduction.h"
 #include "galois/Bag.h"
+#include "galois/Intersection.h"
 #include "galois/Timer.h"
 #include "galois/graphs/LCGraph.h"
 #include "galois/ParallelSTL.h"
+#include "galois/substrate/PerThreadStorage.h"
 #include "llvm/Support/CommandLine.h"
 #include "Lonestar/BoilerPlate.h"
 
@@ -41,6 +43,8 @@ const char* desc = "Counts the triangles in a graph";
 const char* url  = 0;
 
 constexpr static const unsigned CHUNK_SIZE  = 64u;
+//! Nodes with at least this many higher neighbors get a neighbor bitmap
+constexpr static const size_t HUB_DEGREE = 1024;
 enum Algo {
   nodeiterator,
   edgeiterator,
@@ -59,6 +63,11 @@ static cll::opt<Algo> algo(
                            "Ordered Simple Count (default)"),
                 clEnumValEnd),
     cll::init(Algo::orderedCount));
+static cll::opt<std::string> snapshotFilename(
+    "snapshot",
+    cll::desc("Load the prepared graph from this snapshot file; it is "
+              "written after preparing the graph if it does not exist"),
+    cll::init(""));
 
 typedef galois::graphs::LC_CSR_Graph<uint32_t, void>::with_numa_alloc<
     true>::type ::with_no_lockable<true>::type Graph;
@@ -91,27 +100,15 @@ Iterator lowerBound(Iterator first, Iterator last, Compare comp) {
 }
 
 /**
- * std::set_intersection over edge_iterators.
+ * Size of the intersection of the destinations of [aa, ea) and [bb, eb),
+ * which must be sorted.
  */
 template <typename G>
 size_t countEqual(G& g, typename G::edge_iterator aa,
                   typename G::edge_iterator ea, typename G::edge_iterator bb,
                   typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::GraphNode a = g.getEdgeDst(aa);
-    typename G::GraphNode b = g.getEdgeDst(bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
+  return galois::intersection::count(g.getEdgeDstPtr(aa), ea - aa,
+                                     g.getEdgeDstPtr(bb), eb - bb);
 }
 
 template <typename G>
@@ -186,12 +183,18 @@ struct IdLess {
  *       triangle += 1
  * </code>
  *
+ * For a fixed v and a, the b's are the neighbors of v not less than v that
+ * are also neighbors of a, so the inner loop is one intersection per a. All of
+ * them share the same side, so for a node with many such neighbors, the side
+ * is put in a bitmap and each intersection becomes a probe per neighbor of a.
+ *
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
 void nodeIteratingAlgo(Graph& graph) {
 
   galois::GAccumulator<size_t> numTriangles;
+  galois::substrate::PerThreadStorage<galois::intersection::NodeBitmap> bitmaps;
 
   //! [profile w/ vtune]
   galois::runtime::profileVtune(
@@ -209,22 +212,39 @@ void nodeIteratingAlgo(Graph& graph) {
                   lowerBound(first, last, LessThan<Graph>(graph, n));
               Graph::edge_iterator bb =
                   lowerBound(first, last, GreaterThanOrEqual<Graph>(graph, n));
+              if (first == ea || bb == last)
+                return;
+
+              const GNode* hi = graph.getEdgeDstPtr(bb);
+              size_t numHi    = last - bb;
+              galois::intersection::NodeBitmap* bitmap = nullptr;
+              if (numHi >= HUB_DEGREE) {
+                bitmap = bitmaps.getLocal();
+                if (bitmap->universe() < graph.size())
+                  bitmap->resize(graph.size());
+                bitmap->set(hi, numHi);
+              }
 
-              for (; bb != last; ++bb) {
-                GNode B = graph.getEdgeDst(bb);
-                for (auto aa = first; aa != ea; ++aa) {
-                  GNode A = graph.getEdgeDst(aa);
-                  Graph::edge_iterator vv =
-                      graph.edge_begin(A, galois::MethodFlag::UNPROTECTED);
-                  Graph::edge_iterator ev =
-                      graph.edge_end(A, galois::MethodFlag::UNPROTECTED);
-                  Graph::edge_iterator it =
-                      lowerBound(vv, ev, LessThan<Graph>(graph, B));
-                  if (it != ev && graph.getEdgeDst(it) == B) {
-                    numTriangles += 1;
-                  }
+              size_t count = 0;
+              for (auto aa = first; aa != ea; ++aa) {
+                GNode A = graph.getEdgeDst(aa);
+                Graph::edge_iterator vv =
+                    graph.edge_begin(A, galois::MethodFlag::UNPROTECTED);
+                Graph::edge_iterator ev =
+                    graph.edge_end(A, galois::MethodFlag::UNPROTECTED);
+                // neighbors of A not less than n
+                Graph::edge_iterator it =
+                    lowerBound(vv, ev, LessThan<Graph>(graph, n));
+                if (bitmap) {
+                  count += bitmap->count(graph.getEdgeDstPtr(it), ev - it);
+                } else {
+                  count += galois::intersection::count(
+                      graph.getEdgeDstPtr(it), ev - it, hi, numHi);
                 }
               }
+              if (bitmap)
+                bitmap->clear(hi, numHi);
+              numTriangles += count;
             },
             galois::chunk_size<CHUNK_SIZE>(), galois::steal(),
             galois::loopname("nodeIteratingAlgo"));
@@ -386,6 +406,14 @@ void makeGraph(Graph& graph, const std::string& triangleFilename) {
 }
 
 void readGraph(Graph& graph) {
+  if (!snapshotFilename.empty()) {
+    std::ifstream snapshotFile(snapshotFilename.c_str());
+    if (snapshotFile.good()) {
+      graph.loadSnapshot(snapshotFilename);
+      return;
+    }
+  }
+
   if (inputFilename.find(".gr.triangles") !=
       inputFilename.size() - strlen(".gr.triangles")) {
     // Not directly passed .gr.triangles file
@@ -406,6 +434,11 @@ void readGraph(Graph& graph) {
   for (GNode n : graph) {
     graph.getData(n) = index++;
   }
+
+  if (!snapshotFilename.empty()) {
+    std::cout << "Writing graph snapshot: " << snapshotFilename << "\n";
+    graph.saveSnapshot(snapshotFilename);
+  }
 }
 
 int main(int argc, char** argv) {
@@ -60,13 +60,15 @@ static cll::opt<uint32_t>
              cll::desc("Shift value for the delta step (default value 0)"),
              cll::init(0));
 
-enum Exec { Sync, Async };
+enum Exec { Sync, Async, Pipelined };
 
 static cll::opt<Exec> execution(
     "exec",
     cll::desc("Distributed Execution Model (default value Async):"),
     cll::values(clEnumVal(Sync, "Bulk-synchronous Parallel (BSP)"), 
-    clEnumVal(Async, "Bulk-asynchronous Parallel (BASP)"), clEnumValEnd),
+    clEnumVal(Async, "Bulk-asynchronous Parallel (BASP)"),
+    clEnumVal(Pipelined, "BSP with the reduce overlapped with the compute"),
+    clEnumValEnd),
     cll::init(Async));
 
 /******************************************************************************/
@@ -241,12 +243,27 @@ struct BFS {
 #else
         abort();
 #endif
+      } else if (personality == CPU && execution == Pipelined) {
+        syncSubstrate->pipelinedCompute<writeDestination, readSource,
+                                        Reduce_min_dist_current,
+                                        Bitset_dist_current>(
+            "BFS", nodesWithEdges.begin(), nodesWithEdges.end(),
+            [&](auto begin, auto end) {
+              galois::do_all(
+                  galois::iterate(begin, end),
+                  BFS(priority, &_graph, dga, work_edges), galois::steal(),
+                  galois::no_stats(),
+                  galois::loopname(
+                      syncSubstrate->get_run_identifier("BFS").c_str()));
+            });
       } else if (personality == CPU) {
         galois::do_all(
             galois::iterate(nodesWithEdges), BFS(priority, &_graph, dga, work_edges), galois::steal(),
             galois::no_stats(),
             galois::loopname(syncSubstrate->get_run_identifier("BFS").c_str()));
       }
+      // overlap the termination reduction with the sync
+      dga.start_reduce();
       syncSubstrate->sync<writeDestination, readSource, Reduce_min_dist_current,
                           Bitset_dist_current, async>("BFS");
 
@@ -328,8 +345,9 @@ struct BFSSanityCheck {
                      galois::no_stats(), galois::loopname("BFSSanityCheck"));
     }
 
-    uint64_t num_visited  = dgas.reduce();
-    uint32_t max_distance = dgm.reduce();
+    galois::DGReduceFused(dgas, dgm).reduce();
+    uint64_t num_visited  = dgas.read();
+    uint32_t max_distance = dgm.read();
 
     // Only host 0 will print the info
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
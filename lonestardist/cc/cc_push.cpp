@@ -46,13 +46,15 @@ static cll::opt<unsigned int> maxIterations("maxIterations",
                                                       "Default 1000"),
                                             cll::init(1000));
 
-enum Exec { Sync, Async };
+enum Exec { Sync, Async, Pipelined };
 
 static cll::opt<Exec> execution(
     "exec",
     cll::desc("Distributed Execution Model (default value Async):"),
     cll::values(clEnumVal(Sync, "Bulk-synchronous Parallel (BSP)"), 
-    clEnumVal(Async, "Bulk-asynchronous Parallel (BASP)"), clEnumValEnd),
+    clEnumVal(Async, "Bulk-asynchronous Parallel (BASP)"),
+    clEnumVal(Pipelined, "BSP with the reduce overlapped with the compute"),
+    clEnumValEnd),
     cll::init(Async));
 
 /******************************************************************************/
@@ -196,6 +198,18 @@ struct ConnectedComp {
 #else
         abort();
 #endif
+      } else if (personality == CPU && execution == Pipelined) {
+        syncSubstrate->pipelinedCompute<writeDestination, readSource,
+                                        Reduce_min_comp_current,
+                                        Bitset_comp_current>(
+            "ConnectedComp", nodesWithEdges.begin(), nodesWithEdges.end(),
+            [&](auto begin, auto end) {
+              galois::do_all(
+                  galois::iterate(begin, end), ConnectedComp(&_graph, dga),
+                  galois::no_stats(), galois::steal(),
+                  galois::loopname(
+                      syncSubstrate->get_run_identifier("ConnectedComp").c_str()));
+            });
       } else if (personality == CPU) {
         galois::do_all(galois::iterate(nodesWithEdges),
                        ConnectedComp(&_graph, dga), galois::no_stats(),
@@ -49,7 +49,9 @@ enum PARTITIONING_SCHEME {
   GINGER_I,              //!< Ginger, incoming
   FENNEL_O,              //!< Fennel, oec
   FENNEL_I,              //!< Fennel, iec
-  SUGAR_O                //!< Sugar, oec
+  SUGAR_O,               //!< Sugar, oec
+  FILE_O,                //!< edge cut from a partition file, outgoing
+  FILE_I                 //!< edge cut from a partition file, incoming
 };
 
 /**
@@ -84,6 +86,10 @@ inline const char* EnumToString(PARTITIONING_SCHEME e) {
     return "fennel-iec";
   case SUGAR_O:
     return "sugar-oec";
+  case FILE_O:
+    return "file-oec";
+  case FILE_I:
+    return "file-iec";
   default:
     GALOIS_DIE("Unsupported partition");
   }
@@ -104,6 +110,8 @@ extern cll::opt<std::string> inputFileTranspose;
 extern cll::opt<bool> inputFileSymmetric;
 //! partitioning scheme to use
 extern cll::opt<galois::graphs::PARTITIONING_SCHEME> partitionScheme;
+//! partition file for the file partitioning schemes
+extern cll::opt<std::string> partitionFile;
 ////! path to vertex id map for custom edge cut
 //extern cll::opt<std::string> vertexIDMapFileName;
 //! true if you want to read graph structure from a file
@@ -178,6 +186,13 @@ constructSymmetricGraph(std::vector<unsigned>& scaleFactor) {
     return cuspPartitionGraph<SugarP, NodeData, EdgeData>(
       inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
     );
+
+  case FILE_O:
+  case FILE_I:
+    FileP::partitionFile() = partitionFile;
+    return cuspPartitionGraph<FileP, NodeData, EdgeData>(
+      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, true, inputFileTranspose
+    );
   default:
     GALOIS_DIE("Error: partition scheme specified is invalid");
     return nullptr;
@@ -293,6 +308,23 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
       inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
     );
 
+  case FILE_O:
+    FileP::partitionFile() = partitionFile;
+    return cuspPartitionGraph<FileP, NodeData, EdgeData>(
+      inputFile, galois::CUSP_CSR, galois::CUSP_CSR, false, inputFileTranspose
+    );
+  case FILE_I:
+    if (inputFileTranspose.size()) {
+      FileP::partitionFile() = partitionFile;
+      return cuspPartitionGraph<FileP, NodeData, EdgeData>(
+        inputFile, galois::CUSP_CSC, galois::CUSP_CSR, false, inputFileTranspose
+      );
+    } else {
+      GALOIS_DIE("Error: attempting file incoming edge cut without transpose "
+                 "graph");
+      break;
+    }
+
   default:
     GALOIS_DIE("Error: partition scheme specified is invalid");
     return nullptr;
@@ -423,6 +455,23 @@ constructGraph(std::vector<unsigned>& scaleFactor) {
       inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
     );
 
+  case FILE_O:
+    FileP::partitionFile() = partitionFile;
+    return cuspPartitionGraph<FileP, NodeData, EdgeData>(
+      inputFile, galois::CUSP_CSR, galois::CUSP_CSC, false, inputFileTranspose
+    );
+  case FILE_I:
+    if (inputFileTranspose.size()) {
+      FileP::partitionFile() = partitionFile;
+      return cuspPartitionGraph<FileP, NodeData, EdgeData>(
+        inputFile, galois::CUSP_CSC, galois::CUSP_CSC, false, inputFileTranspose
+      );
+    } else {
+      GALOIS_DIE("Error: (file-i) iterate over in-edges without transpose "
+                 "graph");
+      break;
+    }
+
   default:
     GALOIS_DIE("Error: partition scheme specified is invalid");
     return nullptr;
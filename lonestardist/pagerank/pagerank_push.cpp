@@ -262,6 +262,8 @@ struct PageRank {
             galois::loopname(syncSubstrate->get_run_identifier("PageRank").c_str()));
       }
 
+      // overlap the termination reduction with the sync
+      dga.start_reduce();
       syncSubstrate->sync<writeDestination, readSource, Reduce_add_residual,
                   Bitset_residual, async>("PageRank");
 
@@ -383,13 +385,17 @@ struct PageRankSanity {
                      galois::no_stats(), galois::loopname("PageRankSanity"));
     }
 
-    float max_rank          = max_value.reduce();
-    float min_rank          = min_value.reduce();
-    float rank_sum          = DGA_sum.reduce();
-    float residual_sum      = DGA_sum_residual.reduce();
-    uint64_t over_tolerance = DGA_residual_over_tolerance.reduce();
-    float max_res           = max_residual.reduce();
-    float min_res           = min_residual.reduce();
+    galois::DGReduceFused(max_value, min_value, DGA_sum, DGA_sum_residual,
+                          DGA_residual_over_tolerance, max_residual,
+                          min_residual)
+        .reduce();
+    float max_rank          = max_value.read();
+    float min_rank          = min_value.read();
+    float rank_sum          = DGA_sum.read();
+    float residual_sum      = DGA_sum_residual.read();
+    uint64_t over_tolerance = DGA_residual_over_tolerance.read();
+    float max_res           = max_residual.read();
+    float min_res           = min_residual.read();
 
     // Only node 0 will print data
     if (galois::runtime::getSystemNetworkInterface().ID == 0) {
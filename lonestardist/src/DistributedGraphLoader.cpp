@@ -55,9 +55,19 @@ cll::opt<PARTITIONING_SCHEME> partitionScheme(
         clEnumValN(FENNEL_O, "fennel-o", "fennel, outgoing edge cut, using CuSP"),
         clEnumValN(FENNEL_I, "fennel-i", "fennel, incoming edge cut, using CuSP"),
         clEnumValN(SUGAR_O, "sugar-o", "fennel, incoming edge cut, using CuSP"),
+        clEnumValN(FILE_O, "file-o",
+                   "outgoing edge cut from -partitionFile, using CuSP"),
+        clEnumValN(FILE_I, "file-i",
+                   "incoming edge cut from -partitionFile, using CuSP"),
         clEnumValEnd),
     cll::init(OEC));
 
+cll::opt<std::string>
+    partitionFile("partitionFile",
+                  cll::desc("<binary partition file, one uint32 host per "
+                            "node, e.g. from gmetis -partitionFile>"),
+                  cll::init(""));
+
 //cll::opt<std::string>
 //    vertexIDMapFileName("vertexIDMapFileName",
 //                        cll::desc("<file containing the "
@@ -55,13 +55,15 @@ static cll::opt<uint32_t>
              cll::desc("Shift value for the delta step (default value 0)"),
              cll::init(0));
 
-enum Exec { Sync, Async };
+enum Exec { Sync, Async, Pipelined };
 
 static cll::opt<Exec> execution(
     "exec",
     cll::desc("Distributed Execution Model (default value Async):"),
     cll::values(clEnumVal(Sync, "Bulk-synchronous Parallel (BSP)"), 
-    clEnumVal(Async, "Bulk-asynchronous Parallel (BASP)"), clEnumValEnd),
+    clEnumVal(Async, "Bulk-asynchronous Parallel (BASP)"),
+    clEnumVal(Pipelined, "BSP with the reduce overlapped with the compute"),
+    clEnumValEnd),
     cll::init(Async));
 
 /******************************************************************************/
@@ -233,6 +235,19 @@ struct SSSP {
 #else
         abort();
 #endif
+      } else if (personality == CPU && execution == Pipelined) {
+        syncSubstrate->pipelinedCompute<writeDestination, readSource,
+                                        Reduce_min_dist_current,
+                                        Bitset_dist_current>(
+            "SSSP", nodesWithEdges.begin(), nodesWithEdges.end(),
+            [&](auto begin, auto end) {
+              galois::do_all(
+                  galois::iterate(begin, end),
+                  SSSP{priority, &_graph, dga, work_edges}, galois::no_stats(),
+                  galois::loopname(
+                      syncSubstrate->get_run_identifier("SSSP").c_str()),
+                  galois::steal());
+            });
       } else if (personality == CPU) {
         galois::do_all(
             galois::iterate(nodesWithEdges), SSSP{priority, &_graph, dga, work_edges},
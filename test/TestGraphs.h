@@ -0,0 +1,77 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * @file TestGraphs.h
+ *
+ * Builds the small FileGraphs that the unit tests read into other graph
+ * types.
+ */
+#ifndef GALOIS_TEST_TESTGRAPHS_H
+#define GALOIS_TEST_TESTGRAPHS_H
+
+#include "galois/graphs/FileGraph.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//! Out-neighbors of every node, in the order they are written
+typedef std::vector<std::vector<uint32_t>> Adjacency;
+
+//! Adds numEdges edges whose endpoints are drawn uniformly by gen
+inline void addRandomEdges(Adjacency& adj, std::mt19937& gen,
+                           size_t numEdges) {
+  std::uniform_int_distribution<uint32_t> node(0, adj.size() - 1);
+  for (size_t i = 0; i < numEdges; ++i)
+    adj[node(gen)].push_back(node(gen));
+}
+
+//! Default edge data of test graphs
+inline int edgeWeight(uint32_t src, uint32_t dst) { return src * 31 + dst; }
+
+/**
+ * Writes the graph with adjacency lists adj and int edge data
+ * weight(src, dst) to out.
+ */
+template <typename WeightFn = int (*)(uint32_t, uint32_t)>
+void makeGraph(galois::graphs::FileGraph& out, const Adjacency& adj,
+               WeightFn weight = edgeWeight) {
+  size_t numEdges = 0;
+  for (auto& a : adj)
+    numEdges += a.size();
+
+  galois::graphs::FileGraphWriter p;
+  p.setNumNodes(adj.size());
+  p.setNumEdges(numEdges);
+  p.setSizeofEdgeData(sizeof(int));
+  p.phase1();
+  for (size_t src = 0; src < adj.size(); ++src)
+    p.incrementDegree(src, adj[src].size());
+  p.phase2();
+  std::vector<int> edgeData(numEdges);
+  for (size_t src = 0; src < adj.size(); ++src)
+    for (auto dst : adj[src])
+      edgeData[p.addNeighbor(src, dst)] = weight(src, dst);
+  int* raw = p.finish<int>();
+  std::copy(edgeData.begin(), edgeData.end(), raw);
+  out = std::move(p);
+}
+
+#endif
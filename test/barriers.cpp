@@ -20,6 +20,7 @@
 #include "galois/Timer.h"
 #include "galois/Galois.h"
 #include "galois/substrate/Barrier.h"
+#include "galois/substrate/CacheLineStorage.h"
 
 #include <iostream>
 #include <cstdlib>
@@ -68,7 +69,59 @@ void test(std::unique_ptr<galois::substrate::Barrier> b) {
     galois::on_each(e);
     t.stop();
     std::cout << bname << "," << b->name() << "," << M << "," << t.get()
-              << "\n";
+              << "," << t.get_usec() * 1000 / iter << "\n";
+    M -= 1;
+  }
+}
+
+/**
+ * A bulk-synchronous round: every thread contributes whether it did work and
+ * all threads learn whether anyone did. Compares a barrier followed by a
+ * reduction (what a do_all plus a reducer costs) with a combining barrier.
+ */
+void testCombined(std::unique_ptr<galois::substrate::CombiningBarrier> b) {
+  unsigned M = numThreads;
+  if (M > 16)
+    M /= 2;
+  while (M) {
+    galois::setActiveThreads(M);
+    b->reinit(M);
+
+    galois::Timer t1;
+    t1.start();
+    galois::on_each([&](unsigned tid, unsigned) {
+      for (unsigned i = 0; i < iter; ++i) {
+        if (b->waitAny(tid == i % M) != true)
+          GALOIS_DIE("combining barrier lost a flag");
+      }
+    });
+    t1.stop();
+
+    galois::substrate::CacheLineStorage<std::atomic<unsigned>> any[3];
+    for (auto& a : any)
+      a.data = 0;
+    galois::Timer t2;
+    t2.start();
+    galois::on_each([&](unsigned tid, unsigned) {
+      for (unsigned i = 0; i < iter; ++i) {
+        // rotate counters: the one reset here was last read before the
+        // previous barrier and is next written after the following one
+        auto& cur = any[i % 3].data;
+        if (tid == i % M)
+          cur.fetch_add(1);
+        b->wait();
+        if (cur.load() == 0)
+          GALOIS_DIE("barrier lost a flag");
+        if (tid == 0)
+          any[(i + 2) % 3].data = 0;
+      }
+    });
+    t2.stop();
+
+    std::cout << bname << "," << b->name() << "-waitAny," << M << ","
+              << t1.get() << "," << t1.get_usec() * 1000 / iter << "\n";
+    std::cout << bname << "," << b->name() << "-wait+reduce," << M << ","
+              << t2.get() << "," << t2.get_usec() * 1000 / iter << "\n";
     M -= 1;
   }
 }
@@ -85,11 +138,14 @@ int main(int argc, char** argv) {
     numThreads = galois::substrate::getThreadPool().getMaxThreads();
 
   gethostname(bname, sizeof(bname));
+  std::cout << "host,barrier,threads,ms,ns/round\n";
   using namespace galois::substrate;
   test(createPthreadBarrier(1));
   test(createCountingBarrier(1));
   test(createMCSBarrier(1));
   test(createTopoBarrier(1));
   test(createDisseminationBarrier(1));
+  test(createHierarchicalBarrier(1));
+  testCombined(createHierarchicalBarrier(1));
   return 0;
 }
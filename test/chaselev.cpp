@@ -0,0 +1,96 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/WorkList.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//! Owner pushes and pops while thieves steal; every item is taken once
+void testDeque() {
+  const int numItems   = 200000;
+  const int numThieves = 3;
+
+  galois::worklists::ChaseLevDeque<int> deque;
+  std::vector<std::atomic<int>> taken(numItems);
+  for (auto& t : taken)
+    t = 0;
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < numThieves; ++i) {
+    thieves.emplace_back([&]() {
+      while (!done || !deque.empty()) {
+        if (auto v = deque.steal())
+          taken[*v] += 1;
+      }
+    });
+  }
+
+  for (int i = 0; i < numItems; ++i) {
+    deque.push(i);
+    // pop every third item to exercise owner/thief races on the last item
+    if (i % 3 == 0) {
+      if (auto v = deque.pop())
+        taken[*v] += 1;
+    }
+  }
+  while (auto v = deque.pop())
+    taken[*v] += 1;
+  done = true;
+  for (auto& t : thieves)
+    t.join();
+
+  for (auto& t : taken)
+    GALOIS_ASSERT(t == 1);
+}
+
+//! Binary tree of work generated inside for_each
+void testForEach() {
+  galois::GAccumulator<size_t> count;
+  const int depth = 16;
+  std::vector<int> initial(4, 0);
+
+  galois::for_each(galois::iterate(initial),
+                   [&](int level, auto& ctx) {
+                     count += 1;
+                     if (level < depth) {
+                       ctx.push(level + 1);
+                       ctx.push(level + 1);
+                     }
+                   },
+                   galois::wl<galois::worklists::ChaseLevLIFO<>>(),
+                   galois::no_conflicts(), galois::loopname("chaselev"));
+
+  GALOIS_ASSERT(count.reduce() == initial.size() * ((2u << depth) - 1));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(std::thread::hardware_concurrency());
+
+  testDeque();
+  testForEach();
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "TestGraphs.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef galois::graphs::LC_CSR_Graph<int, int> CSRGraph;
+typedef galois::graphs::LC_Compressed_Graph<int, int> CompressedGraph;
+
+//! Random graph with a few hub nodes so that skip index entries are used
+void makeHubGraph(galois::graphs::FileGraph& out, size_t numNodes) {
+  std::mt19937 gen(numNodes);
+  std::uniform_int_distribution<uint32_t> node(0, numNodes - 1);
+  Adjacency adj(numNodes);
+
+  addRandomEdges(adj, gen, numNodes * 8);
+  for (size_t i = 0; i < numNodes * 2; ++i) {
+    adj[0].push_back(node(gen));
+    adj[numNodes - 1].push_back(node(gen));
+  }
+  makeGraph(out, adj);
+}
+
+void check(CSRGraph& expected, CompressedGraph& actual) {
+  GALOIS_ASSERT(expected.size() == actual.size());
+  GALOIS_ASSERT(expected.sizeEdges() == actual.sizeEdges());
+
+  galois::do_all(galois::iterate(expected), [&](CSRGraph::GraphNode n) {
+    GALOIS_ASSERT(actual.getDegree(n) ==
+                  (uint64_t)std::distance(expected.edge_begin(n),
+                                          expected.edge_end(n)));
+    auto ii = actual.edge_begin(n);
+    for (auto e : expected.edges(n)) {
+      GALOIS_ASSERT(ii != actual.edge_end(n));
+      GALOIS_ASSERT(expected.getEdgeDst(e) == actual.getEdgeDst(ii));
+      GALOIS_ASSERT(expected.getEdgeData(e) == actual.getEdgeData(ii));
+      ++ii;
+    }
+    GALOIS_ASSERT(ii == actual.edge_end(n));
+
+    // random access jumps backwards and forwards across skip index blocks
+    auto degree = std::distance(expected.edge_begin(n), expected.edge_end(n));
+    GALOIS_ASSERT(std::distance(actual.edge_begin(n), actual.edge_end(n)) ==
+                  degree);
+    for (auto k = degree - 1; k >= 0; k -= 7) {
+      GALOIS_ASSERT(actual.getEdgeDst(actual.edge_end(n) - (degree - k)) ==
+                    expected.getEdgeDst(expected.edge_begin(n) + k));
+      GALOIS_ASSERT(actual.getEdgeDst(actual.edge_begin(n) + k) ==
+                    expected.getEdgeDst(expected.edge_begin(n) + k));
+    }
+
+    for (auto e : expected.edges(n)) {
+      auto found = actual.findEdge(n, expected.getEdgeDst(e));
+      GALOIS_ASSERT(found != actual.edge_end(n));
+      GALOIS_ASSERT(actual.getEdgeDst(found) == expected.getEdgeDst(e));
+    }
+  });
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  galois::graphs::FileGraph f;
+  makeHubGraph(f, 1000);
+
+  // neighbors are compared in sorted order
+  CSRGraph expected;
+  galois::graphs::readGraph(expected, f);
+  expected.sortAllEdgesByDst();
+
+  CompressedGraph compressed;
+  galois::graphs::readGraph(compressed, f);
+  check(expected, compressed);
+  GALOIS_ASSERT(compressed.sizeEdgeBytes() <
+                compressed.sizeEdges() * sizeof(uint32_t));
+  GALOIS_ASSERT(compressed.findEdge(1, 1000) == compressed.edge_end(1));
+
+  std::string filename = "compressed-graph-test.tmp";
+  compressed.toFile(filename);
+  CompressedGraph reloaded;
+  galois::graphs::readGraph(reloaded, filename);
+  std::remove(filename.c_str());
+  check(expected, reloaded);
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "TestGraphs.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Compares the edge data of the read graph with the file
+struct SameData {
+  template <typename GraphTy>
+  bool operator()(galois::graphs::FileGraph& expected,
+                  galois::graphs::FileGraph::edge_iterator e, GraphTy& actual,
+                  typename GraphTy::edge_iterator ii) const {
+    return expected.getEdgeData<int>(e) == actual.getEdgeData(ii);
+  }
+};
+
+//! Graphs without edge data have nothing to compare
+struct NoData {
+  template <typename GraphTy>
+  bool operator()(galois::graphs::FileGraph&,
+                  galois::graphs::FileGraph::edge_iterator, GraphTy&,
+                  typename GraphTy::edge_iterator) const {
+    return true;
+  }
+};
+
+template <typename GraphTy, typename DataCheck>
+void check(galois::graphs::FileGraph& expected, const std::string& filename,
+           DataCheck sameData) {
+  GraphTy actual;
+  galois::graphs::readGraph(actual, filename);
+
+  GALOIS_ASSERT(expected.size() == actual.size());
+  GALOIS_ASSERT(expected.sizeEdges() == actual.sizeEdges());
+  for (auto n : expected) {
+    auto ii = actual.edge_begin(n);
+    for (auto e : expected.edges(n)) {
+      GALOIS_ASSERT(ii != actual.edge_end(n));
+      GALOIS_ASSERT(expected.getEdgeDst(e) == actual.getEdgeDst(ii));
+      GALOIS_ASSERT(sameData(expected, e, actual, ii));
+      ++ii;
+    }
+    GALOIS_ASSERT(ii == actual.edge_end(n));
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(std::thread::hardware_concurrency());
+
+  // an odd number of edges exercises the padding after the destinations
+  std::mt19937 gen(1000);
+  Adjacency adj(1000);
+  addRandomEdges(adj, gen, 1000 * 8 + 1);
+  galois::graphs::FileGraph f;
+  makeGraph(f, adj);
+  std::string filename = "graph-file-reader-test.tmp";
+  f.toFile(filename);
+
+  typedef galois::graphs::LC_CSR_Graph<int, int> Graph;
+  check<Graph>(f, filename, SameData());
+  check<Graph::with_numa_alloc<true>::type>(f, filename, SameData());
+  check<galois::graphs::LC_CSR_Graph<int, void>>(f, filename, NoData());
+  check<Graph::with_file_edge_data<void>::type>(f, filename, NoData());
+  // edge data converted from the file type
+  check<galois::graphs::LC_CSR_Graph<int, long>::with_file_edge_data<int>::type>(
+      f, filename, SameData());
+
+  std::remove(filename.c_str());
+
+  return 0;
+}
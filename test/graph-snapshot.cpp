@@ -0,0 +1,145 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/B_LC_CSR_Graph.h"
+#include "galois/graphs/LCGraph.h"
+#include "TestGraphs.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+void writeGraph(const std::string& filename, size_t numNodes) {
+  std::mt19937 gen(numNodes);
+  Adjacency adj(numNodes);
+  addRandomEdges(adj, gen, numNodes * 8);
+  galois::graphs::FileGraph f;
+  makeGraph(f, adj);
+  f.toFile(filename);
+}
+
+template <typename GraphTy>
+void checkSame(GraphTy& expected, GraphTy& actual) {
+  GALOIS_ASSERT(expected.size() == actual.size());
+  GALOIS_ASSERT(expected.sizeEdges() == actual.sizeEdges());
+  for (auto n : expected) {
+    GALOIS_ASSERT(expected.getData(n) == actual.getData(n));
+    auto ii = actual.edge_begin(n);
+    for (auto e : expected.edges(n)) {
+      GALOIS_ASSERT(ii != actual.edge_end(n));
+      GALOIS_ASSERT(expected.getEdgeDst(e) == actual.getEdgeDst(ii));
+      GALOIS_ASSERT(expected.getEdgeData(e) == actual.getEdgeData(ii));
+      ++ii;
+    }
+    GALOIS_ASSERT(ii == actual.edge_end(n));
+  }
+}
+
+template <typename GraphTy>
+void checkSameIn(GraphTy& expected, GraphTy& actual) {
+  for (auto n : expected) {
+    auto ii = actual.in_edge_begin(n);
+    for (auto e : expected.in_edges(n)) {
+      GALOIS_ASSERT(ii != actual.in_edge_end(n));
+      GALOIS_ASSERT(expected.getInEdgeDst(e) == actual.getInEdgeDst(ii));
+      GALOIS_ASSERT(expected.getInEdgeData(e) == actual.getInEdgeData(ii));
+      ++ii;
+    }
+    GALOIS_ASSERT(ii == actual.in_edge_end(n));
+  }
+}
+
+void testOutEdges(const std::string& input, const std::string& snapshot) {
+  typedef galois::graphs::LC_CSR_Graph<int, int>::with_no_lockable<true>::type
+      Graph;
+
+  Graph expected;
+  galois::graphs::readGraph(expected, input);
+  expected.transpose();
+  expected.sortAllEdgesByDst();
+  for (auto n : expected)
+    expected.getData(n) = n * 7;
+  expected.saveSnapshot(snapshot, galois::graphs::GraphSnapshot::TRANSPOSED);
+
+  Graph actual;
+  uint64_t flags = actual.loadSnapshot(snapshot);
+  GALOIS_ASSERT(flags & galois::graphs::GraphSnapshot::SORTED_BY_DST);
+  GALOIS_ASSERT(flags & galois::graphs::GraphSnapshot::TRANSPOSED);
+  checkSame(expected, actual);
+
+  // writes go to private pages and never reach the file
+  for (auto n : actual)
+    actual.getData(n) = -1;
+  Graph again;
+  again.loadSnapshot(snapshot);
+  checkSame(expected, again);
+
+  // a graph without sorted edges is recorded as such
+  Graph unsorted;
+  galois::graphs::readGraph(unsorted, input);
+  unsorted.saveSnapshot(snapshot);
+  flags = again.loadSnapshot(snapshot);
+  GALOIS_ASSERT(!(flags & galois::graphs::GraphSnapshot::SORTED_BY_DST));
+  GALOIS_ASSERT(again.sizeEdges() == unsorted.sizeEdges());
+}
+
+void testInEdges(const std::string& input, const std::string& snapshot) {
+  typedef galois::graphs::B_LC_CSR_Graph<int, int, true, true> Graph;
+
+  Graph expected;
+  galois::graphs::readGraph(expected, input);
+  expected.constructIncomingEdges();
+  expected.sortAllInEdgesByDst();
+  expected.saveSnapshot(snapshot);
+
+  Graph actual;
+  uint64_t flags = actual.loadSnapshot(snapshot);
+  GALOIS_ASSERT(flags & galois::graphs::GraphSnapshot::IN_SORTED_BY_DST);
+  checkSame(expected, actual);
+  checkSameIn(expected, actual);
+
+  // in-edges are constructed when the snapshot has none
+  galois::graphs::LC_CSR_Graph<int, int>::with_no_lockable<true>::type outOnly;
+  galois::graphs::readGraph(outOnly, input);
+  outOnly.saveSnapshot(snapshot);
+  Graph rebuilt;
+  rebuilt.loadSnapshot(snapshot);
+  rebuilt.sortAllInEdgesByDst();
+  checkSameIn(expected, rebuilt);
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(std::thread::hardware_concurrency());
+
+  std::string input    = "graph-snapshot-test.gr.tmp";
+  std::string snapshot = "graph-snapshot-test.snap.tmp";
+  writeGraph(input, 1000);
+
+  testOutEdges(input, snapshot);
+  testInEdges(input, snapshot);
+
+  std::remove(input.c_str());
+  std::remove(snapshot.c_str());
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * Checks that every set intersection kernel agrees with std::set_intersection
+ * and reports the time per intersection of each kernel across size ratios,
+ * as CSV. Usage: intersection [size of smaller set] [repetitions]
+ */
+
+#include "galois/Galois.h"
+#include "galois/Intersection.h"
+#include "galois/Timer.h"
+#include "galois/gIO.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace galois::intersection;
+
+const Kernel kernels[] = {SCALAR, GALLOP, AVX2, AVX512, AUTO};
+
+//! Sorted set of n distinct values drawn from [0, universe)
+template <typename T>
+std::vector<T> makeSet(std::mt19937& gen, size_t n, size_t universe) {
+  std::uniform_int_distribution<T> dist(0, universe - 1);
+  std::vector<T> v;
+  while (v.size() < n) {
+    for (size_t i = v.size(); i < n; ++i)
+      v.push_back(dist(gen));
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+  }
+  return v;
+}
+
+template <typename T>
+std::vector<T> expected(const std::vector<T>& a, const std::vector<T>& b) {
+  std::vector<T> r;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(r));
+  return r;
+}
+
+void check(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs) {
+  std::vector<uint32_t> exp = expected(lhs, rhs);
+  const uint32_t* x         = lhs.data();
+  const uint32_t* y         = rhs.data();
+  size_t nx = lhs.size(), ny = rhs.size();
+  std::vector<uint32_t> out(std::min(nx, ny)), posX(out.size()),
+      posY(out.size());
+
+  for (Kernel k : kernels) {
+    if (!isSupported(k))
+      continue;
+    GALOIS_ASSERT(count(x, nx, y, ny, k) == exp.size(), kernelName(k));
+    size_t m = intersect(x, nx, y, ny, out.data(), k);
+    GALOIS_ASSERT(m == exp.size(), kernelName(k));
+    GALOIS_ASSERT(std::equal(exp.begin(), exp.end(), out.begin()),
+                  kernelName(k));
+    m = intersectPositions(x, nx, y, ny, posX.data(), posY.data(), k);
+    GALOIS_ASSERT(m == exp.size(), kernelName(k));
+    for (size_t i = 0; i < m; ++i)
+      GALOIS_ASSERT(x[posX[i]] == exp[i] && y[posY[i]] == exp[i],
+                    kernelName(k));
+  }
+
+  NodeBitmap bitmap(1 << 20);
+  bitmap.set(x, nx);
+  GALOIS_ASSERT(bitmap.count(y, ny) == exp.size());
+  bitmap.clear(x, nx);
+  GALOIS_ASSERT(bitmap.count(y, ny) == 0);
+}
+
+void check64(const std::vector<uint64_t>& lhs,
+             const std::vector<uint64_t>& rhs) {
+  std::vector<uint64_t> exp = expected(lhs, rhs);
+  std::vector<uint64_t> out(std::min(lhs.size(), rhs.size()));
+  for (Kernel k : kernels) {
+    if (!isSupported(k))
+      continue;
+    size_t m = intersect(lhs.data(), lhs.size(), rhs.data(), rhs.size(),
+                         out.data(), k);
+    GALOIS_ASSERT(m == exp.size(), kernelName(k));
+    GALOIS_ASSERT(std::equal(exp.begin(), exp.end(), out.begin()),
+                  kernelName(k));
+  }
+}
+
+void testCorrectness() {
+  std::mt19937 gen(0);
+  for (size_t na : {0, 1, 7, 15, 16, 17, 100, 1000}) {
+    for (size_t nb : {0, 1, 8, 31, 33, 200, 5000}) {
+      // dense universes give many matches, sparse ones few
+      for (size_t universe : {2 * (na + nb) + 1, 20 * (na + nb) + 1}) {
+        check(makeSet<uint32_t>(gen, na, universe),
+              makeSet<uint32_t>(gen, nb, universe));
+        check64(makeSet<uint64_t>(gen, na, universe),
+                makeSet<uint64_t>(gen, nb, universe));
+      }
+    }
+  }
+  // identical and disjoint sets
+  std::vector<uint32_t> a = makeSet<uint32_t>(gen, 1000, 5000);
+  check(a, a);
+  std::vector<uint32_t> lo(100), hi(100);
+  for (uint32_t i = 0; i < 100; ++i) {
+    lo[i] = i;
+    hi[i] = 1000 + i;
+  }
+  check(lo, hi);
+  check(hi, lo);
+}
+
+void benchmark(size_t small, unsigned reps) {
+  std::mt19937 gen(1);
+  std::cout << "kernel,small,large,ns/intersection\n";
+  for (size_t ratio : {1, 2, 4, 16, 64, 256}) {
+    size_t large    = small * ratio;
+    size_t universe = 4 * large;
+    std::vector<std::vector<uint32_t>> as, bs;
+    for (unsigned i = 0; i < 16; ++i) {
+      as.push_back(makeSet<uint32_t>(gen, small, universe));
+      bs.push_back(makeSet<uint32_t>(gen, large, universe));
+    }
+    for (Kernel k : kernels) {
+      if (!isSupported(k))
+        continue;
+      size_t sum = 0;
+      galois::Timer t;
+      t.start();
+      for (unsigned r = 0; r < reps; ++r)
+        for (unsigned i = 0; i < as.size(); ++i)
+          sum += count(as[i].data(), small, bs[i].data(), large, k);
+      t.stop();
+      GALOIS_ASSERT(sum > 0 || large == 0);
+      std::cout << kernelName(k) << "," << small << "," << large << ","
+                << t.get_usec() * 1000.0 / (reps * as.size()) << "\n";
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  size_t small  = argc > 1 ? atoi(argv[1]) : 64;
+  unsigned reps = argc > 2 ? atoi(argv[2]) : 200;
+
+  std::cout << "best kernel: " << kernelName(bestKernel()) << "\n";
+  testCorrectness();
+  benchmark(small, reps);
+  return 0;
+}
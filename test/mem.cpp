@@ -68,5 +68,49 @@ int main(int argc, char** argv) {
     GALOIS_ASSERT(allocated);
   }
 
+  // arena pages are recycled after clear instead of mapped again, and do
+  // not come from the page pool
+  size_t newPages;
+  int pagePoolPages = numPagePoolAllocForThread(0);
+  {
+    ArenaBumpHeap arena;
+    for (unsigned i = 0; i < 4 * baseAllocSize / sizeof(element); ++i)
+      new (arena.allocate(sizeof(element))) element(i);
+    element* big = static_cast<element*>(arena.allocate(baseAllocSize + 1));
+    big->val     = 1;
+    arena.clear();
+    newPages = NumaPageArena::getInstance()->stats(0).newPages;
+    GALOIS_ASSERT(newPages >= 4);
+    for (unsigned i = 0; i < 4 * baseAllocSize / sizeof(element); ++i)
+      new (arena.allocate(sizeof(element))) element(i);
+    arena.clear();
+    GALOIS_ASSERT(NumaPageArena::getInstance()->stats(0).newPages ==
+                  newPages);
+  }
+  GALOIS_ASSERT(NumaPageArena::used());
+  GALOIS_ASSERT(numPagePoolAllocForThread(0) == pagePoolPages);
+
+  // once no arena heap is alive, its pages are unmapped
+  {
+    ArenaBumpHeap arena;
+    arena.allocate(sizeof(element));
+    GALOIS_ASSERT(NumaPageArena::getInstance()->stats(0).newPages ==
+                  newPages + 1);
+  }
+
+  // the per-iteration heap only uses the arena when asked to
+  {
+    IterAllocHeap heap;
+    heap.allocate(sizeof(element));
+    heap.clear();
+    GALOIS_ASSERT(NumaPageArena::getInstance()->stats(0).newPages ==
+                  newPages + 1);
+    IterAllocHeap arenaHeap;
+    arenaHeap.useArena();
+    arenaHeap.allocate(sizeof(element));
+    GALOIS_ASSERT(NumaPageArena::getInstance()->stats(0).newPages ==
+                  newPages + 2);
+  }
+
   return 0;
 }
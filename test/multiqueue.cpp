@@ -0,0 +1,98 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Reduction.h"
+#include "galois/worklists/WorkList.h"
+
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Identity {
+  int operator()(int x) const { return x; }
+};
+
+typedef galois::worklists::MultiQueue<Identity, 2, 4, int, int> MQ;
+
+//! Single threaded version is an exact priority queue
+void testSerial() {
+  MQ::rethread<false> wl;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> dist(-1000, 1000);
+
+  for (int i = 0; i < 1000; ++i)
+    wl.push(dist(gen));
+  int last = std::numeric_limits<int>::min();
+  for (int i = 0; i < 1000; ++i) {
+    auto v = wl.pop();
+    GALOIS_ASSERT(v && *v >= last);
+    last = *v;
+  }
+  GALOIS_ASSERT(!wl.pop());
+
+  // items still in the push buffer are popped in order with the heap
+  for (int i = 0; i < 10; ++i)
+    wl.push(10 * i);
+  wl.push(5);
+  for (int expected : {0, 5, 10}) {
+    auto v = wl.pop();
+    GALOIS_ASSERT(v && *v == expected);
+  }
+  wl.push(1);
+  auto v = wl.pop();
+  GALOIS_ASSERT(v && *v == 1);
+  for (int i = 2; i < 10; ++i) {
+    v = wl.pop();
+    GALOIS_ASSERT(v && *v == 10 * i);
+  }
+  GALOIS_ASSERT(!wl.pop());
+}
+
+//! Binary tree of work generated inside for_each; nothing is lost in the
+//! per-thread insert buffers
+void testForEach() {
+  galois::GAccumulator<size_t> count;
+  const int depth = 16;
+  std::vector<int> initial(4, 0);
+
+  galois::for_each(galois::iterate(initial),
+                   [&](int level, auto& ctx) {
+                     count += 1;
+                     if (level < depth) {
+                       ctx.push(level + 1);
+                       ctx.push(level + 1);
+                     }
+                   },
+                   galois::wl<MQ>(), galois::no_conflicts(),
+                   galois::loopname("multiqueue"));
+
+  GALOIS_ASSERT(count.reduce() == initial.size() * ((2u << depth) - 1));
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(std::thread::hardware_concurrency());
+
+  testSerial();
+  testForEach();
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+#include "galois/Galois.h"
+#include "galois/graphs/PartitionFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(std::thread::hardware_concurrency());
+
+  const std::string filename = "partition-file-test.part.tmp";
+  const uint64_t numNodes    = 100003;
+  const uint32_t numParts    = 7;
+
+  std::mt19937 gen(numNodes);
+  std::uniform_int_distribution<uint32_t> part(0, numParts - 1);
+  std::vector<uint32_t> parts(numNodes);
+  for (auto& p : parts)
+    p = part(gen);
+
+  galois::graphs::writePartitionFile(filename, parts.data(), numNodes);
+
+  // whole file, then contiguous ranges as hosts would read them
+  auto all = galois::graphs::readPartitionFile(filename, numNodes, numParts, 0,
+                                               numNodes);
+  GALOIS_ASSERT(all == parts);
+  for (unsigned host = 0; host < 5; ++host) {
+    auto r = galois::block_range(uint64_t(0), numNodes, host, 5);
+    auto slice = galois::graphs::readPartitionFile(filename, numNodes,
+                                                   numParts, r.first, r.second);
+    GALOIS_ASSERT(slice.size() == r.second - r.first);
+    GALOIS_ASSERT(std::equal(slice.begin(), slice.end(),
+                             parts.begin() + r.first));
+  }
+  GALOIS_ASSERT(galois::graphs::readPartitionFile(filename, numNodes, numParts,
+                                                  numNodes, numNodes)
+                    .empty());
+
+  std::remove(filename.c_str());
+  return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/gIO.h"
+#include "galois/substrate/CacheLineStorage.h"
+#include "galois/substrate/PerThreadStorage.h"
+
+#include <cstdint>
+
+struct alignas(32) Vec4 {
+  double v[4];
+};
+
+struct alignas(64) Vec8 {
+  double v[8];
+};
+
+template <typename T>
+bool aligned(T* p) {
+  return reinterpret_cast<uintptr_t>(p) % alignof(T) == 0;
+}
+
+template <typename PTS>
+void checkAligned(PTS& pts) {
+  galois::on_each([&](unsigned, unsigned) {
+    GALOIS_ASSERT(aligned(pts.getLocal()), "misaligned per-thread storage");
+  });
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(galois::substrate::getThreadPool().getMaxThreads());
+
+  // small allocations first so that later offsets are not trivially aligned
+  galois::substrate::PerThreadStorage<char> c;
+  galois::substrate::PerThreadStorage<uint16_t> s;
+  galois::substrate::PerThreadStorage<Vec4> v4;
+  galois::substrate::PerThreadStorage<char> c2;
+  galois::substrate::PerThreadStorage<Vec8> v8;
+  galois::substrate::PerThreadStorage<uint32_t> u;
+  galois::substrate::PerThreadStorage<galois::substrate::CacheLineStorage<int>>
+      cl;
+
+  checkAligned(v4);
+  checkAligned(v8);
+  checkAligned(cl);
+
+  // write through the aligned types, as vectorized code would
+  galois::on_each([&](unsigned tid, unsigned) {
+    for (unsigned i = 0; i < 8; ++i)
+      v8.getLocal()->v[i] = tid + i;
+    for (unsigned i = 0; i < 4; ++i)
+      v4.getLocal()->v[i] = tid + i;
+  });
+  galois::on_each([&](unsigned tid, unsigned) {
+    GALOIS_ASSERT(v8.getLocal()->v[7] == tid + 7);
+    GALOIS_ASSERT(v4.getLocal()->v[3] == tid + 3);
+  });
+
+  return 0;
+}
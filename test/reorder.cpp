@@ -0,0 +1,156 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/Reorder.h"
+#include "TestGraphs.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+typedef galois::graphs::FileGraph FileGraph;
+typedef galois::graphs::LC_CSR_Graph<int, int> Graph;
+typedef galois::graphs::LC_CSR_Graph<int, void> VoidGraph;
+typedef galois::LargeArray<uint32_t> Permutation;
+
+int edgeData(FileGraph& g, FileGraph::edge_iterator ii) {
+  return g.getEdgeData<int>(ii);
+}
+
+int edgeData(Graph& g, Graph::edge_iterator ii) { return g.getEdgeData(ii); }
+
+int edgeData(VoidGraph&, VoidGraph::edge_iterator) { return 0; }
+
+void checkPermutation(const Permutation& perm) {
+  std::vector<bool> seen(perm.size(), false);
+  for (auto n : perm) {
+    GALOIS_ASSERT(n < perm.size() && !seen[n]);
+    seen[n] = true;
+  }
+}
+
+//! Every edge (src, dst, w) of in must be (p[src], p[dst], w) in out, in order
+template <typename G1, typename G2>
+void checkRelabel(G1& in, G2& out, const Permutation& perm) {
+  GALOIS_ASSERT(in.size() == out.size());
+  GALOIS_ASSERT(in.sizeEdges() == out.sizeEdges());
+  for (uint32_t src = 0; src < in.size(); ++src) {
+    auto jj = out.edge_begin(perm[src]);
+    for (auto ii = in.edge_begin(src), ei = in.edge_end(src); ii != ei;
+         ++ii, ++jj) {
+      GALOIS_ASSERT(jj != out.edge_end(perm[src]));
+      GALOIS_ASSERT(out.getEdgeDst(jj) == perm[in.getEdgeDst(ii)]);
+      GALOIS_ASSERT(edgeData(out, jj) == edgeData(in, ii));
+    }
+    GALOIS_ASSERT(jj == out.edge_end(perm[src]));
+  }
+}
+
+void testOrderings() {
+  const size_t numNodes = 2000;
+  std::mt19937 gen(numNodes);
+  std::uniform_int_distribution<uint32_t> node(0, numNodes - 1);
+  Adjacency adj(numNodes);
+  addRandomEdges(adj, gen, numNodes * 8);
+  for (size_t i = 0; i < numNodes; ++i)
+    adj[7].push_back(node(gen));
+
+  FileGraph graph;
+  makeGraph(graph, adj);
+  Graph lcgraph;
+  galois::graphs::readGraph(lcgraph, graph);
+  VoidGraph voidgraph;
+  galois::graphs::readGraph(voidgraph, graph);
+
+  for (int policy = 0; policy < 4; ++policy) {
+    Permutation perm;
+    perm.create(numNodes);
+    switch (policy) {
+    case 0:
+      galois::graphs::degreeSortPermutation(graph, perm);
+      // the hub comes first
+      GALOIS_ASSERT(perm[7] == 0);
+      break;
+    case 1:
+      galois::graphs::hubClusterPermutation(graph, perm);
+      GALOIS_ASSERT(perm[7] < numNodes / 2);
+      break;
+    case 2:
+      galois::graphs::rcmPermutation(graph, perm);
+      break;
+    case 3:
+      galois::graphs::gorderPermutation(lcgraph, perm);
+      break;
+    }
+    checkPermutation(perm);
+
+    FileGraph out;
+    galois::graphs::relabel<int>(graph, perm, out);
+    checkRelabel(graph, out, perm);
+
+    Graph lcout;
+    galois::graphs::relabel(lcgraph, perm, lcout);
+    checkRelabel(graph, lcout, perm);
+
+    VoidGraph voidout;
+    galois::graphs::relabel(voidgraph, perm, voidout);
+    checkRelabel(voidgraph, voidout, perm);
+  }
+}
+
+//! RCM recovers a bandwidth 1 ordering of a randomly labeled path
+void testRCMPath() {
+  const size_t numNodes = 1000;
+  std::vector<uint32_t> label(numNodes);
+  std::iota(label.begin(), label.end(), 0);
+  std::shuffle(label.begin(), label.end(), std::mt19937(0));
+
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for (size_t i = 0; i + 1 < numNodes; ++i) {
+    edges.emplace_back(label[i], label[i + 1]);
+    edges.emplace_back(label[i + 1], label[i]);
+  }
+  Adjacency adj(numNodes);
+  for (auto& e : edges)
+    adj[e.first].push_back(e.second);
+  FileGraph graph;
+  makeGraph(graph, adj);
+
+  Permutation perm;
+  perm.create(numNodes);
+  galois::graphs::rcmPermutation(graph, perm);
+  checkPermutation(perm);
+  for (auto& e : edges) {
+    int64_t d = int64_t(perm[e.first]) - int64_t(perm[e.second]);
+    GALOIS_ASSERT(d == 1 || d == -1);
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(2);
+
+  testOrderings();
+  testRCMPath();
+
+  return 0;
+}
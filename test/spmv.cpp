@@ -0,0 +1,172 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/graphs/LCGraph.h"
+#include "galois/graphs/SpMV.h"
+#include "TestGraphs.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace galois::graphs;
+
+typedef LC_CSR_Graph<int, int>::with_no_lockable<true>::type WeightedGraph;
+typedef LC_CSR_Graph<int, void>::with_no_lockable<true>::type PatternGraph;
+
+const size_t widths[] = {1, 7, 64, 1000, size_t(1) << 40};
+
+void writeGraph(const std::string& filename, size_t numNodes) {
+  std::mt19937 gen(numNodes);
+  // skewed sources so that some rows are empty and some are long
+  std::uniform_real_distribution<double> unit;
+  std::uniform_int_distribution<uint32_t> node(0, numNodes - 1);
+  Adjacency adj(numNodes);
+
+  for (size_t i = 0; i < numNodes * 8; ++i) {
+    double u = unit(gen);
+    adj[size_t(numNodes * u * u * u)].push_back(node(gen));
+  }
+
+  FileGraph f;
+  makeGraph(f, adj, [](uint32_t src, uint32_t dst) {
+    return int((src * 31 + dst) % 17 + 1);
+  });
+  f.toFile(filename);
+}
+
+template <typename Graph, typename Semiring>
+std::vector<typename Semiring::value_type>
+reference(Graph& g, const std::vector<typename Semiring::value_type>& x,
+          const Semiring& sr) {
+  std::vector<typename Semiring::value_type> y(g.size(), sr.zero());
+  for (auto r : g)
+    for (auto e : g.edges(r))
+      y[r] = sr.add(y[r], sr.multiply(internal::edgeValue(g, e),
+                                      x[g.getEdgeDst(e)]));
+  return y;
+}
+
+template <typename Graph, typename Semiring>
+void checkMultiply(Graph& g, const std::vector<typename Semiring::value_type>& x,
+                   const Semiring& sr) {
+  typedef typename Semiring::value_type T;
+  typedef CacheBlockedCSR<internal::EdgeValueOf<Graph>> Blocked;
+  std::vector<T> expected = reference(g, x, sr);
+
+  std::vector<T> y(g.size());
+  spmv(g, x, y, sr);
+  GALOIS_ASSERT(y == expected);
+
+  for (size_t w : widths) {
+    Blocked blocked(g, w);
+    GALOIS_ASSERT(blocked.sizeEdges() == g.sizeEdges());
+    GALOIS_ASSERT(blocked.segmentWidth() <= std::max<size_t>(w, 1));
+    std::fill(y.begin(), y.end(), T(42));
+    blocked.multiply(x, y, sr);
+    GALOIS_ASSERT(y == expected, "segment width ", w);
+  }
+}
+
+void testSpMV(const std::string& input) {
+  WeightedGraph weighted;
+  readGraph(weighted, input);
+  PatternGraph pattern;
+  readGraph(pattern, input);
+
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int64_t> value(-1000, 1000);
+  std::vector<int64_t> x(weighted.size());
+  for (auto& v : x)
+    v = value(gen);
+  checkMultiply(weighted, x, PlusTimes<int64_t>());
+  checkMultiply(pattern, x, PlusTimes<int64_t>());
+
+  std::vector<uint32_t> dist(weighted.size(), MinPlus<uint32_t>().zero());
+  for (size_t i = 0; i < dist.size(); i += 5)
+    dist[i] = i % 100;
+  checkMultiply(weighted, dist, MinPlus<uint32_t>());
+  checkMultiply(pattern, dist, MinPlus<uint32_t>());
+}
+
+void testSpMSpV(const std::string& input) {
+  WeightedGraph g;
+  readGraph(g, input);
+  PlusTimes<int64_t> sr;
+
+  SparseVector<int64_t> x, y;
+  x.allocate(g.size());
+  y.allocate(g.size());
+  std::vector<int64_t> dense(g.size());
+  for (size_t i = 0; i < g.size(); i += 3) {
+    dense[i] = i + 1;
+    x.set(i, i + 1);
+  }
+
+  for (int round = 0; round < 2; ++round) {
+    // y = A^T x, computed by pushing x along the edges
+    std::vector<int64_t> expected(g.size());
+    for (auto c : g)
+      for (auto e : g.edges(c))
+        expected[g.getEdgeDst(e)] += g.getEdgeData(e) * dense[c];
+
+    spmspv(g, x, y, sr);
+
+    size_t nonzeros = 0;
+    for (uint32_t i : y.indices()) {
+      GALOIS_ASSERT(y[i] == expected[i]);
+      ++nonzeros;
+    }
+    size_t touched = 0;
+    std::vector<bool> isTarget(g.size());
+    for (auto c : g)
+      if (dense[c])
+        for (auto e : g.edges(c))
+          isTarget[g.getEdgeDst(e)] = true;
+    for (size_t i = 0; i < g.size(); ++i) {
+      touched += isTarget[i];
+      if (!isTarget[i])
+        GALOIS_ASSERT(y[i] == 0);
+    }
+    GALOIS_ASSERT(nonzeros == touched);
+
+    // clear must leave an all zero vector that can be reused
+    y.clear();
+    GALOIS_ASSERT(y.empty());
+    for (size_t i = 0; i < g.size(); ++i)
+      GALOIS_ASSERT(y[i] == 0);
+  }
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+  galois::setActiveThreads(std::thread::hardware_concurrency());
+
+  std::string input = "spmv-test.gr.tmp";
+  writeGraph(input, 3000);
+
+  testSpMV(input);
+  testSpMSpV(input);
+
+  std::remove(input.c_str());
+  return 0;
+}
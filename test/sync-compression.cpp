@@ -0,0 +1,107 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "galois/Galois.h"
+#include "galois/runtime/SyncCompression.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using galois::runtime::ValuePacker;
+
+void checkOffsets(const std::vector<unsigned int>& offsets) {
+  galois::PODResizeableArray<uint8_t> packed;
+  galois::runtime::packOffsets(offsets.data(), offsets.size(), packed);
+  galois::PODResizeableArray<unsigned int> unpacked;
+  galois::runtime::unpackOffsets(packed.data(), offsets.size(), unpacked);
+  GALOIS_ASSERT(unpacked.size() == offsets.size());
+  GALOIS_ASSERT(std::equal(offsets.begin(), offsets.end(), unpacked.begin()));
+}
+
+//! Round trips values bit for bit, so NaN and -0.0 compare correctly
+template <typename T>
+void checkValues(const std::vector<T>& values) {
+  static_assert(ValuePacker<T>::packable, "type should be packable");
+  galois::PODResizeableArray<uint8_t> packed;
+  ValuePacker<T>::pack(values.data(), values.size(), packed);
+  std::vector<T> unpacked(values.size() + 1);
+  ValuePacker<T>::unpack(packed.data(), values.size(), unpacked.data());
+  GALOIS_ASSERT(values.empty() ||
+                std::memcmp(values.data(), unpacked.data(),
+                            values.size() * sizeof(T)) == 0);
+}
+
+template <typename T>
+void checkIntegers() {
+  typedef std::numeric_limits<T> L;
+  checkValues<T>({});
+  checkValues<T>({T(7)});
+  checkValues<T>({L::min()});
+  checkValues<T>({L::max(), L::min(), T(0), L::max()});
+  checkValues<T>({T(5), T(3), T(1000000), T(3)});
+  if (L::is_signed)
+    checkValues<T>({T(-1), T(0), L::min(), T(L::min() + 1), T(-42)});
+}
+
+template <typename T>
+void checkFloats() {
+  typedef std::numeric_limits<T> L;
+  checkValues<T>({});
+  checkValues<T>({T(1.5)});
+  checkValues<T>({T(-0.0)});
+  checkValues<T>({L::quiet_NaN(), T(-0.0), T(0.0), L::denorm_min(),
+                  -L::denorm_min(), L::min() / 2, L::infinity(),
+                  -L::infinity(), L::max(), L::lowest()});
+  checkValues<T>({T(1), T(1), T(1.0001), T(-3), std::nextafter(T(-3), T(0))});
+}
+
+int main() {
+  galois::SharedMemSys Galois_runtime;
+
+  checkOffsets({});
+  checkOffsets({0});
+  checkOffsets({UINT32_MAX});
+  checkOffsets({0, 1, 2, 127, 128, 16511, 16512});
+  // gaps that need the full five varint bytes
+  checkOffsets({1, UINT32_MAX - 1, UINT32_MAX});
+  checkOffsets({0, UINT32_MAX});
+
+  checkIntegers<int>();
+  checkIntegers<unsigned int>();
+  checkIntegers<int64_t>();
+  checkIntegers<uint64_t>();
+  checkIntegers<int16_t>();
+  checkIntegers<uint8_t>();
+  checkValues<int>({INT_MIN, INT_MAX});
+  checkValues<int>({INT_MIN});
+
+  checkFloats<float>();
+  checkFloats<double>();
+  checkValues<float>({FLT_MIN, FLT_TRUE_MIN, -FLT_TRUE_MIN});
+  checkValues<double>({DBL_MIN, DBL_TRUE_MIN, -DBL_TRUE_MIN});
+
+  static_assert(!ValuePacker<bool>::packable, "bool should not be packed");
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * Measures the latency of detecting termination once all threads are idle,
+ * which is what every round of a bulk-synchronous loop pays, for each
+ * termination detection algorithm across thread counts. Usage:
+ * termination [rounds] [threads]
+ */
+
+#include "galois/Timer.h"
+#include "galois/Galois.h"
+#include "galois/substrate/Barrier.h"
+#include "galois/substrate/Termination.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+
+unsigned iter       = 0;
+unsigned numThreads = 0;
+
+char bname[100];
+
+//! Exposes init so detectors can be used outside of the runtime
+template <typename T>
+struct Detector : public T {
+  using T::init;
+};
+
+template <typename T>
+void test(const char* name) {
+  Detector<T> term;
+  unsigned M = numThreads;
+  if (M > 16)
+    M /= 2;
+  while (M) {
+    galois::setActiveThreads(M);
+    term.init(M);
+    galois::substrate::Barrier& barrier = galois::substrate::getBarrier(M);
+    galois::Timer t;
+    t.start();
+    galois::on_each([&](unsigned tid, unsigned) {
+      for (unsigned i = 0; i < iter; ++i) {
+        term.initializeThread();
+        barrier.wait();
+        // one thread did work this round, so at least one wave is wasted
+        term.localTermination(tid == i % M);
+        while (!term.globalTermination())
+          term.localTermination(false);
+        barrier.wait();
+      }
+    });
+    t.stop();
+    std::cout << bname << "," << name << "," << M << "," << t.get() << ","
+              << t.get_usec() * 1000 / iter << "\n";
+    M -= 1;
+  }
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys Galois_runtime;
+  if (argc > 1)
+    iter = atoi(argv[1]);
+  else
+    iter = 16 * 1024;
+  if (argc > 2)
+    numThreads = atoi(argv[2]);
+  else
+    numThreads = galois::substrate::getThreadPool().getMaxThreads();
+
+  gethostname(bname, sizeof(bname));
+  std::cout << "host,detector,threads,ms,ns/round\n";
+  using namespace galois::substrate::internal;
+  test<LocalTerminationDetection<>>("Ring");
+  test<TreeTerminationDetection<>>("Tree");
+  test<HierarchicalTerminationDetection<>>("Hierarchical");
+  return 0;
+}
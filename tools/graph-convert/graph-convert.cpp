@@ -20,6 +20,9 @@
 #include "galois/Galois.h"
 #include "galois/LargeArray.h"
 #include "galois/graphs/FileGraph.h"
+#include "galois/graphs/LC_Compressed_Graph.h"
+#include "galois/graphs/Reorder.h"
+#include "galois/graphs/Util.h"
 
 #include "llvm/Support/CommandLine.h"
 
@@ -35,8 +38,12 @@
 #include <string>
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cstdlib>
-#include <boost/algorithm/string.hpp> 
+#include <cstring>
+#include <numeric>
 
 // TODO: move these enums to a common location for all graph convert tools
 enum ConvertMode {
@@ -51,6 +58,7 @@ enum ConvertMode {
   gr2binarypbbs64,
   gr2bsml,
   gr2cgr,
+  gr2compressedgr,
   gr2dimacs,
   gr2adjacencylist,
   gr2edgelist,
@@ -64,6 +72,7 @@ enum ConvertMode {
   gr2pbbsedges,
   gr2randgr,
   gr2randomweightgr,
+  gr2reorderedgr,
   gr2ringgr,
   gr2rmat,
   gr2metis,
@@ -88,6 +97,8 @@ enum ConvertMode {
 
 enum EdgeType { float32_, float64_, int32_, int64_, uint32_, uint64_, void_ };
 
+enum ReorderPolicy { degree, hubcluster, rcm, gorder };
+
 namespace cll = llvm::cl;
 
 static cll::opt<std::string>
@@ -140,6 +151,9 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2bsml, "Convert binary gr to binary sparse MATLAB matrix"),
         clEnumVal(gr2cgr,
                   "Clean up binary gr: remove self edges and multi-edges"),
+        clEnumVal(gr2compressedgr, "Convert binary gr to compressed gr "
+                                   "(varint encoded gaps, see "
+                                   "LC_Compressed_Graph)"),
         clEnumVal(gr2dimacs, "Convert binary gr to dimacs"),
         clEnumVal(gr2adjacencylist, "Convert binary gr to adjacency list"),
         clEnumVal(gr2edgelist, "Convert binary gr to edgelist"),
@@ -155,6 +169,8 @@ static cll::opt<ConvertMode> convertMode(
         clEnumVal(gr2pbbsedges, "Convert binary gr to pbbs edge list"),
         clEnumVal(gr2randgr, "Randomly permute nodes of binary gr"),
         clEnumVal(gr2randomweightgr, "Add or Randomize edge weights"),
+        clEnumVal(gr2reorderedgr, "Relabel nodes of binary gr for locality "
+                                  "(see -reorder)"),
         clEnumVal(gr2ringgr, "Convert binary gr to strongly connected graph by "
                              "adding ring overlay"),
         clEnumVal(gr2rmat, "Convert binary gr to RMAT graph"),
@@ -202,6 +218,18 @@ static cll::opt<int>
              cll::init(1));
 static cll::opt<int> maxDegree("maxDegree", cll::desc("maximum degree to keep"),
                                cll::init(2 * 1024));
+static cll::opt<ReorderPolicy> reorderPolicy(
+    "reorder", cll::desc("Node ordering for gr2reorderedgr:"),
+    cll::values(clEnumVal(degree, "Sort by decreasing out-degree"),
+                clEnumVal(hubcluster, "Move above average degree nodes first"),
+                clEnumVal(rcm, "Reverse Cuthill-McKee"),
+                clEnumVal(gorder, "Windowed locality ordering (Gorder)"),
+                clEnumValEnd),
+    cll::init(degree));
+static cll::opt<unsigned> gorderWindow(
+    "gorderWindow", cll::desc("window size for -reorder=gorder"), cll::init(5));
+static cll::opt<int> numThreads("t", cll::desc("Number of threads (default 1)"),
+                                cll::init(1));
 
 struct Conversion {};
 struct HasOnlyVoidSpecialization {};
@@ -336,146 +364,402 @@ void outputPermutation(const T& perm) {
 }
 
 /**
- * Custom spliting of a line in the input text file.
- * To be used for reading edges in edgelist format (src dst edge_weight) or 
- * csv format (src,dst,edge_weight). 
- * 
- * @param line : single line from a file
- * @param iss  : std::stringStream to be returned with split parts
- * @param delim: Custom delimiter; [space] for edgelist, [,] for CSV 
+ * Text input file, mapped into memory so that chunks of whole lines can be
+ * parsed in parallel.
  */
-void splitString(std::string line, std::vector<std::string> &result, std::stringstream &iss, std::string delim) {
-  boost::split(result, line, boost::is_any_of(delim)); 
-  // Populate
-  std::copy(result.begin(), result.end(),std::ostream_iterator<std::string>(iss,"\n"));
-  return;
-}
+class TextFile {
+  int fd;
+  char* base;
+  size_t length;
+
+public:
+  explicit TextFile(const std::string& filename) : base(nullptr), length(0) {
+    fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+      GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+    struct stat buf;
+    if (fstat(fd, &buf) == -1)
+      GALOIS_SYS_DIE("failed reading ", "'", filename, "'");
+    length = buf.st_size;
+    if (length) {
+      void* m = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m == MAP_FAILED)
+        GALOIS_SYS_DIE("failed mapping ", "'", filename, "'");
+      base = static_cast<char*>(m);
+      madvise(base, length, MADV_SEQUENTIAL);
+    }
+  }
+
+  ~TextFile() {
+    if (base)
+      munmap(base, length);
+    close(fd);
+  }
+
+  TextFile(const TextFile&) = delete;
+  TextFile& operator=(const TextFile&) = delete;
+
+  const char* begin() const { return base; }
+  const char* end() const { return base + length; }
+  size_t size() const { return length; }
+
+  //! End of the line starting at p: its newline, or the end of the file
+  const char* lineEnd(const char* p) const {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end() - p));
+    return eol ? eol : end();
+  }
+
+  //! Start of the line after the one containing p
+  const char* nextLine(const char* p) const {
+    const char* eol = lineEnd(p);
+    return eol == end() ? eol : eol + 1;
+  }
+
+  /**
+   * Splits [start, end()) into chunks of whole lines of about chunkBytes
+   * each. Chunk i is [bounds[i], bounds[i + 1]).
+   */
+  std::vector<const char*> split(const char* start, size_t chunkBytes) const {
+    std::vector<const char*> bounds{start};
+    while (bounds.back() != end()) {
+      const char* p = bounds.back();
+      if (size_t(end() - p) <= chunkBytes)
+        bounds.push_back(end());
+      else
+        bounds.push_back(nextLine(p + chunkBytes - 1));
+    }
+    return bounds;
+  }
+};
 
 /**
- * Common function to convert formats similar to edgelist by passing
- * custom delimiter:
- * 
- * Edgelist: delim:[space]
- * src dst weight
- * 
- * CSV: delim: [,] (NOTE: First line (labels) in CSV is ignored)
- * src,dst,weight 
- * 
+ * Numbers on one line of text, separated by whitespace or delim. Integers
+ * are parsed by hand; floating point values go through strtod.
  */
-template <typename EdgeTy>
-void edgelistStyleWithCustomDelim(const bool skipFirstLine, const std::string& infilename, const std::string& outfilename, std::string delim) {
-    typedef galois::graphs::FileGraphWriter Writer;
-    typedef galois::LargeArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
+class LineTokens {
+  const char* p;
+  const char* eol;
+  char delim;
 
-    Writer p;
-    EdgeData edgeData;
-    std::ifstream infile(infilename.c_str());
+  bool isSeparator(char c) const {
+    return c == ' ' || c == '\t' || c == '\r' || c == delim;
+  }
 
-    size_t numNodes = 0;
-    size_t numEdges = 0;
+  void skipSeparators() {
+    while (p != eol && isSeparator(*p))
+      ++p;
+  }
 
-    std::vector<std::string> result; 
-    std::string line;
-    if(skipFirstLine){
-      std::getline(infile, line);
-      galois::gPrint("WARNING: First line is assumed to contain labels and is ignored\n");
-      galois::gPrint("First Line : " , line, "\n");
-    }
-    while (std::getline(infile, line)) {
-      std::stringstream iss;
-      // Populate
-      splitString(line, result, iss, delim);
-      size_t src;
-      size_t dst;
-      edge_value_type data;
-
-      iss >> src >> dst;
-      
-      if (EdgeData::has_value)
-        iss >> data;
-        
-    
-      if (infile) {
-        ++numEdges;
-        if (src > numNodes)
-          numNodes = src;
-        if (dst > numNodes)
-          numNodes = dst;
-      }
-    }
+public:
+  LineTokens(const char* line, const char* e, char d)
+      : p(line), eol(e), delim(d) {}
 
-    numNodes++;
-    p.setNumNodes(numNodes);
-    p.setNumEdges(numEdges);
-    p.setSizeofEdgeData(EdgeData::size_of::value);
-    edgeData.create(numEdges);
+  //! First character of the next token, or '\0' at the end of the line
+  char peek() {
+    skipSeparators();
+    return p == eol ? '\0' : *p;
+  }
 
-    galois::gPrint(numNodes, " , ", numEdges, "\n");
-    infile.clear();
-    infile.seekg(0, std::ios::beg);
-    p.phase1();
+  void skipToken() {
+    skipSeparators();
+    while (p != eol && !isSeparator(*p))
+      ++p;
+  }
 
-    result.clear(); 
-    line.clear();
-    if(skipFirstLine){
-      std::getline(infile, line); /* Ignore first line */
-    }
-    while (std::getline(infile, line)) {
-      std::stringstream iss(line);
-      // Populate
-      splitString(line, result, iss, delim);
-      size_t src;
-      size_t dst;
-      edge_value_type data;
+  //! Parses the next token as an integer; false if it does not start with one
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value, bool>::type
+  next(T& value) {
+    skipSeparators();
+    bool negative = false;
+    if (p != eol && (*p == '-' || *p == '+'))
+      negative = *p++ == '-';
+    if (p == eol || unsigned(*p - '0') > 9)
+      return false;
+    uint64_t v = 0;
+    for (; p != eol && unsigned(*p - '0') <= 9; ++p)
+      v = v * 10 + (*p - '0');
+    // ignore the rest of the token, e.g., the fraction of "1.5"
+    while (p != eol && !isSeparator(*p))
+      ++p;
+    value = negative ? static_cast<T>(-static_cast<int64_t>(v))
+                     : static_cast<T>(v);
+    return true;
+  }
 
-      iss >> src >> dst;
+  //! Graphs without edge data have no value to parse
+  bool next(void*&) { return false; }
+
+  //! Parses the next token as a floating point value
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+  next(T& value) {
+    skipSeparators();
+    const char* start = p;
+    while (p != eol && !isSeparator(*p))
+      ++p;
+    char buf[64];
+    size_t len = p - start;
+    if (len == 0 || len >= sizeof(buf))
+      return false;
+    std::copy(start, p, buf);
+    buf[len] = '\0';
+    char* last;
+    value = strtod(buf, &last);
+    return last != buf;
+  }
+};
 
-      if (EdgeData::has_value)
-        iss >> data;
+/**
+ * Edges parsed from one chunk of a text file, in file order.
+ */
+template <typename EdgeTy>
+struct TextChunk {
+  typedef galois::LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  std::vector<uint64_t> src;
+  std::vector<uint64_t> dst;
+  std::vector<edge_value_type> data;
+  uint64_t maxNode = 0;
+
+  void push(uint64_t s, uint64_t d,
+            const edge_value_type& value = edge_value_type()) {
+    src.push_back(s);
+    dst.push_back(d);
+    if (EdgeData::has_value)
+      data.push_back(value);
+    maxNode = std::max(maxNode, std::max(s, d));
+  }
+};
 
-      if (infile) {
-        p.incrementDegree(src);
-      }
-    }
+/**
+ * Edges of a text file, in file order.
+ */
+template <typename EdgeTy>
+struct TextEdges {
+  typedef galois::LargeArray<EdgeTy> EdgeData;
 
-    infile.clear();
-    infile.seekg(0, std::ios::beg);
-    p.phase2();
+  galois::LargeArray<uint64_t> src;
+  galois::LargeArray<uint64_t> dst;
+  EdgeData data;
+  //! largest node id seen
+  uint64_t maxNode = 0;
 
-    result.clear(); 
-    line.clear();
-    if(skipFirstLine){
-      std::getline(infile, line); /* Ignore first line */
-    }
-    while (std::getline(infile, line)) {
-      std::stringstream iss(line);
-      // Populate
-      splitString(line, result, iss, delim);
-      size_t src;
-      size_t dst;
-      edge_value_type data{};
+  size_t size() const { return src.size(); }
+};
 
-      iss >> src >> dst;
+/**
+ * Parses the lines of file from start to the end in parallel. Each line
+ * is handed to parseLine(LineTokens&, TextChunk<EdgeTy>&), which pushes
+ * the edges on it, if any.
+ */
+template <typename EdgeTy, typename ParseLine>
+void readTextEdges(const TextFile& file, const char* start, char delim,
+                   ParseLine parseLine, TextEdges<EdgeTy>& edges) {
+  typedef TextChunk<EdgeTy> Chunk;
+
+  galois::Timer timer;
+  timer.start();
+
+  // enough chunks to balance load, but not so small that they are all overhead
+  size_t bytes      = file.end() - start;
+  size_t chunkBytes = bytes / (16 * galois::getActiveThreads());
+  chunkBytes = std::min(std::max(chunkBytes, size_t(1) << 20), size_t(1) << 26);
+  std::vector<const char*> bounds = file.split(start, chunkBytes);
+  std::vector<Chunk> chunks(bounds.size() - 1);
+
+  galois::do_all(
+      galois::iterate(size_t(0), chunks.size()),
+      [&](size_t c) {
+        for (const char* line = bounds[c]; line != bounds[c + 1];) {
+          const char* eol = file.lineEnd(line);
+          LineTokens tokens(line, eol, delim);
+          parseLine(tokens, chunks[c]);
+          line = eol == file.end() ? eol : eol + 1;
+        }
+      },
+      galois::steal(), galois::chunk_size<1>(), galois::loopname("ParseText"));
 
-      if (EdgeData::has_value)
-        iss >> data;
+  std::vector<size_t> offsets(chunks.size() + 1);
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    offsets[c + 1] = offsets[c] + chunks[c].src.size();
+    edges.maxNode  = std::max(edges.maxNode, chunks[c].maxNode);
+  }
+  edges.src.allocateInterleaved(offsets.back());
+  edges.dst.allocateInterleaved(offsets.back());
+  edges.data.allocateInterleaved(offsets.back());
+
+  galois::do_all(
+      galois::iterate(size_t(0), chunks.size()),
+      [&](size_t c) {
+        Chunk& chunk = chunks[c];
+        std::copy(chunk.src.begin(), chunk.src.end(), &edges.src[offsets[c]]);
+        std::copy(chunk.dst.begin(), chunk.dst.end(), &edges.dst[offsets[c]]);
+        for (size_t i = 0; i < chunk.data.size(); ++i)
+          edges.data.set(offsets[c] + i, chunk.data[i]);
+        chunk = Chunk();
+      },
+      galois::steal(), galois::chunk_size<1>(), galois::loopname("GatherText"));
+
+  timer.stop();
+  double seconds = std::max(timer.get_usec(), 1UL) / 1e6;
+  std::cout << "Parsed " << bytes / (1 << 20) << " MB, " << edges.size()
+            << " edges in " << timer.get() << " ms ("
+            << static_cast<uint64_t>(bytes / seconds / (1 << 20))
+            << " MB/s, " << static_cast<uint64_t>(edges.size() / seconds)
+            << " edges/s)\n";
+}
 
-      if (infile) {
-        edgeData.set(p.addNeighbor(src, dst), data);
-      }
-    }
+/**
+ * Replaces each element of the array with the sum of the ones before it,
+ * in parallel, and returns the total.
+ */
+template <typename T>
+T exclusivePrefixSum(galois::LargeArray<T>& array) {
+  std::vector<T> sums(galois::getActiveThreads() + 1);
+  galois::on_each([&](unsigned tid, unsigned total) {
+    auto r = galois::block_range(size_t(0), array.size(), tid, total);
+    T sum  = 0;
+    for (size_t i = r.first; i < r.second; ++i)
+      sum += array[i];
+    sums[tid + 1] = sum;
+  });
+  std::partial_sum(sums.begin(), sums.end(), sums.begin());
+  galois::on_each([&](unsigned tid, unsigned total) {
+    auto r = galois::block_range(size_t(0), array.size(), tid, total);
+    T sum  = sums[tid];
+    for (size_t i = r.first; i < r.second; ++i) {
+      T v      = array[i];
+      array[i] = sum;
+      sum += v;
+    }
+  });
+  return sums.back();
+}
 
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(std::make_move_iterator(edgeData.begin()),
-                              std::make_move_iterator(edgeData.end()),
-                              rawEdgeData);
+/**
+ * Writes edges to outfilename as a gr graph with numNodes nodes, keeping
+ * the edges of each node in file order. Edges are bucketed by source in
+ * parallel by counting degrees, taking their prefix sum and scattering
+ * edge ids into place, after which each bucket is sorted back into file
+ * order.
+ */
+template <typename EdgeTy>
+void writeTextEdges(TextEdges<EdgeTy>& edges, size_t numNodes,
+                    const std::string& outfilename) {
+  typedef galois::graphs::FileGraphWriter Writer;
+  typedef galois::LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  galois::Timer timer;
+  timer.start();
+
+  size_t numEdges = edges.size();
+  galois::LargeArray<uint64_t> ends;
+  ends.allocateInterleaved(numNodes);
+  galois::do_all(galois::iterate(size_t(0), numNodes),
+                 [&](size_t n) { ends[n] = 0; });
+  galois::do_all(galois::iterate(size_t(0), numEdges), [&](size_t e) {
+    __atomic_fetch_add(&ends[edges.src[e]], 1, __ATOMIC_RELAXED);
+  });
+  exclusivePrefixSum(ends);
+
+  // after this, ends[n] is one past the last edge of n
+  galois::LargeArray<uint64_t> order;
+  order.allocateInterleaved(numEdges);
+  galois::do_all(galois::iterate(size_t(0), numEdges), [&](size_t e) {
+    order[__atomic_fetch_add(&ends[edges.src[e]], 1, __ATOMIC_RELAXED)] = e;
+  });
+
+  Writer p;
+  p.setNumNodes(numNodes);
+  p.setNumEdges(numEdges);
+  p.setSizeofEdgeData(EdgeData::size_of::value);
+  p.phase1();
+  // each node touches only its own degree and edges of p
+  galois::do_all(
+      galois::iterate(size_t(0), numNodes),
+      [&](size_t n) {
+        uint64_t begin = n ? ends[n - 1] : 0;
+        std::sort(&order[begin], &order[0] + ends[n]);
+        if (ends[n] != begin)
+          p.incrementDegree(n, ends[n] - begin);
+      },
+      galois::steal(), galois::loopname("SortText"));
+
+  EdgeData edgeData;
+  edgeData.allocateInterleaved(numEdges);
+  p.phase2();
+  galois::do_all(
+      galois::iterate(size_t(0), numNodes),
+      [&](size_t n) {
+        for (uint64_t k = n ? ends[n - 1] : 0; k != ends[n]; ++k) {
+          uint64_t e = order[k];
+          edgeData.set(p.addNeighbor(n, edges.dst[e]), edges.data[e]);
+        }
+      },
+      galois::steal(), galois::loopname("WriteText"));
+
+  edge_value_type* rawEdgeData = p.finish<edge_value_type>();
+  if (EdgeData::has_value)
+    std::uninitialized_copy(std::make_move_iterator(edgeData.begin()),
+                            std::make_move_iterator(edgeData.end()),
+                            rawEdgeData);
+  timer.stop();
+  std::cout << "CSR build time: " << timer.get() << " ms\n";
+
+  p.toFile(outfilename);
+  printStatus(numNodes, numEdges);
+}
 
-    p.toFile(outfilename);
-    printStatus(numNodes, numEdges);
+/**
+ * Common function to convert formats similar to edgelist by passing
+ * custom delimiter:
+ *
+ * Edgelist: delim:[space]
+ * src dst weight
+ *
+ * CSV: delim: [,] (NOTE: First line (labels) in CSV is ignored)
+ * src,dst,weight
+ *
+ * Blank lines and lines starting with '#' or '%' are ignored.
+ */
+template <typename EdgeTy>
+void edgelistStyleWithCustomDelim(const bool skipFirstLine,
+                                  const std::string& infilename,
+                                  const std::string& outfilename, char delim) {
+  typedef typename TextChunk<EdgeTy>::EdgeData EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  TextFile file(infilename);
+  const char* start = file.begin();
+  if (skipFirstLine) {
+    start = file.nextLine(start);
+    galois::gPrint("WARNING: First line is assumed to contain labels and is "
+                   "ignored\n");
+    galois::gPrint("First Line : ", std::string(file.begin(), start), "\n");
   }
 
+  TextEdges<EdgeTy> edges;
+  readTextEdges<EdgeTy>(
+      file, start, delim,
+      [](LineTokens& tokens, TextChunk<EdgeTy>& chunk) {
+        char c = tokens.peek();
+        if (c == '#' || c == '%')
+          return;
+        uint64_t src, dst;
+        edge_value_type data{};
+        if (!tokens.next(src) || !tokens.next(dst))
+          return;
+        if (EdgeData::has_value)
+          tokens.next(data);
+        chunk.push(src, dst, data);
+      },
+      edges);
+
+  writeTextEdges(edges, edges.maxNode + 1, outfilename);
+}
 
 /**
  * Assumption: First line has labels
@@ -490,7 +774,7 @@ struct CSV2Gr : public Conversion {
      * WARNING: First line is assumed to contain labels and is ignored;
      * The first bool arg to edgelistStyleWithCustomDelim is skipFirstLine=True
      */
-    edgelistStyleWithCustomDelim<EdgeTy>(true, infilename, outfilename, ",");
+    edgelistStyleWithCustomDelim<EdgeTy>(true, infilename, outfilename, ',');
   }
 };
 
@@ -502,7 +786,7 @@ struct CSV2Gr : public Conversion {
 struct Edgelist2Gr : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    edgelistStyleWithCustomDelim<EdgeTy>(false, infilename, outfilename, "\t ");
+    edgelistStyleWithCustomDelim<EdgeTy>(false, infilename, outfilename, ' ');
   }
 };
 
@@ -513,49 +797,31 @@ struct Edgelist2Gr : public Conversion {
 struct Edgelist2Binary : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    std::ifstream infile(infilename.c_str());
-    std::ofstream outfile(outfilename.c_str());
-
-    size_t numNodes = 0;
-    size_t numEdges = 0;
-
-    uint32_t bufferSize = 10000;
-    std::vector<uint32_t> buffer(bufferSize);
-    uint32_t counter = 0;
-    while (infile) {
-      // size_t src;
-      // size_t dst;
-      uint32_t src;
-      uint32_t dst;
-
-      infile >> src >> dst;
-
-      buffer[counter++] = src;
-      buffer[counter++] = dst;
-      if (counter == bufferSize) {
-        // flush it to the output file.
-        outfile.write(reinterpret_cast<char*>(&buffer[0]),
-                      sizeof(uint32_t) * counter);
-        counter = 0;
-      }
-      if (infile) {
-        ++numEdges;
-        if (src > numNodes)
-          numNodes = src;
-        if (dst > numNodes)
-          numNodes = dst;
-      } else {
-        counter -= 2;
-      }
-    }
+    TextFile file(infilename);
+    TextEdges<void> edges;
+    readTextEdges<void>(file, file.begin(), ' ',
+                        [](LineTokens& tokens, TextChunk<void>& chunk) {
+                          uint32_t src;
+                          uint32_t dst;
+                          if (tokens.next(src) && tokens.next(dst))
+                            chunk.push(src, dst);
+                        },
+                        edges);
+
+    galois::LargeArray<uint32_t> buffer;
+    buffer.allocateInterleaved(2 * edges.size());
+    galois::do_all(galois::iterate(size_t(0), edges.size()), [&](size_t e) {
+      buffer[2 * e]     = edges.src[e];
+      buffer[2 * e + 1] = edges.dst[e];
+    });
 
-    if (counter) {
-      // flush it to the output file.
-      outfile.write(reinterpret_cast<char*>(&buffer[0]),
-                    sizeof(uint32_t) * counter);
-    }
+    std::ofstream outfile(outfilename.c_str());
+    outfile.write(reinterpret_cast<char*>(buffer.data()),
+                  sizeof(uint32_t) * buffer.size());
+    if (!outfile)
+      GALOIS_DIE("failed writing ", outfilename);
 
-    printStatus(numNodes, numEdges);
+    printStatus(edges.maxNode, edges.size());
   }
 };
 
@@ -572,103 +838,55 @@ struct Edgelist2Binary : public Conversion {
 struct Mtx2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
-    typedef galois::LargeArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
-
-    Writer p;
-    EdgeData edgeData;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-      if (!infile) {
-        GALOIS_DIE("Failed to open input file");
-      }
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() != '%') {
-          break;
-        }
-        infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() != 3) {
-        GALOIS_DIE("Unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[0]);
-      // nedges = std::stoull(tokens[2]);
-      nnodes = strtoull(tokens[0].c_str(), NULL, 0);
-      nedges = strtoull(tokens[2].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges(nedges);
-        p.setSizeofEdgeData(EdgeData::size_of::value);
-        edgeData.create(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        if ((edge_num % (nedges / 500)) == 0) {
-          printf("Phase %d: current edge progress %lf%%\n", phase,
-                 ((double)edge_num / nedges) * 100);
-        }
-        uint32_t cur_id, neighbor_id;
-        double weight = 1;
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("Error: node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("Error: neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          edgeData.set(p.addNeighbor(cur_id - 1, neighbor_id - 1),
-                       static_cast<edge_value_type>(weight));
-        }
-
-        infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-      }
+    typedef typename TextChunk<EdgeTy>::edge_value_type edge_value_type;
+
+    TextFile file(infilename);
+
+    // Skip comments
+    const char* start = file.begin();
+    while (start != file.end() && *start == '%')
+      start = file.nextLine(start);
+
+    // Read header
+    const char* eol = file.lineEnd(start);
+    LineTokens header(start, eol, ' ');
+    uint64_t nnodes, ncols, nedges;
+    if (!header.next(nnodes) || !header.next(ncols) || !header.next(nedges) ||
+        header.peek() != '\0') {
+      GALOIS_DIE("Unknown problem specification line: ",
+                 std::string(start, eol));
+    }
+
+    TextEdges<EdgeTy> edges;
+    readTextEdges<EdgeTy>(
+        file, file.nextLine(start), ' ',
+        [&](LineTokens& tokens, TextChunk<EdgeTy>& chunk) {
+          if (tokens.peek() == '\0')
+            return;
+          uint64_t cur_id, neighbor_id;
+          double weight = 1;
+          if (!tokens.next(cur_id) || !tokens.next(neighbor_id)) {
+            GALOIS_DIE("Error: malformed edge line");
+          }
+          tokens.next(weight);
+          if (cur_id == 0 || cur_id > nnodes) {
+            GALOIS_DIE("Error: node id out of range: ", cur_id);
+          }
+          if (neighbor_id == 0 || neighbor_id > nnodes) {
+            GALOIS_DIE("Error: neighbor id out of range: ", neighbor_id);
+          }
+          // 1 indexed
+          chunk.push(cur_id - 1, neighbor_id - 1,
+                     static_cast<edge_value_type>(weight));
+        },
+        edges);
 
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("Error: additional lines in file");
-      }
+    if (edges.size() != nedges) {
+      GALOIS_DIE("Error: expected ", nedges, " edges but found ",
+                 edges.size());
     }
-    // this is for the progress print
-
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(std::make_move_iterator(edgeData.begin()),
-                              std::make_move_iterator(edgeData.end()),
-                              rawEdgeData);
 
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    writeTextEdges(edges, nnodes, outfilename);
   }
 };
 
@@ -711,70 +929,24 @@ struct Nodelist2Gr : public HasOnlyVoidSpecialization {
   void convert(const std::string& infilename, const std::string& outfilename) {
     static_assert(std::is_same<EdgeTy, void>::value,
                   "conversion undefined for non-void graphs");
-    typedef galois::graphs::FileGraphWriter Writer;
-
-    Writer p;
-    std::ifstream infile(infilename.c_str());
-
-    size_t numNodes = 0;
-    size_t numEdges = 0;
-
-    while (infile) {
-      size_t src;
-      size_t numNeighbors;
-
-      infile >> src >> numNeighbors;
-
-      if (infile) {
-        if (src > numNodes)
-          numNodes = src;
-        numEdges += numNeighbors;
-      }
-      infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    }
-
-    numNodes++;
-    p.setNumNodes(numNodes);
-    p.setNumEdges(numEdges);
-
-    infile.clear();
-    infile.seekg(0, std::ios::beg);
-    p.phase1();
-    while (infile) {
-      size_t src;
-      size_t numNeighbors;
-
-      infile >> src >> numNeighbors;
-
-      if (infile) {
-        p.incrementDegree(src, numNeighbors);
-      }
-      infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    }
-
-    infile.clear();
-    infile.seekg(0, std::ios::beg);
-    p.phase2();
-    while (infile) {
-      size_t src;
-      size_t numNeighbors;
-
-      infile >> src >> numNeighbors;
-
-      for (; infile && numNeighbors > 0; --numNeighbors) {
-        size_t dst;
-        infile >> dst;
-        if (infile)
-          p.addNeighbor(src, dst);
-      }
-
-      infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    }
-
-    p.finish<void>();
 
-    p.toFile(outfilename);
-    printStatus(numNodes, numEdges);
+    TextFile file(infilename);
+    TextEdges<void> edges;
+    readTextEdges<void>(file, file.begin(), ' ',
+                        [](LineTokens& tokens, TextChunk<void>& chunk) {
+                          uint64_t src;
+                          uint64_t numNeighbors;
+                          if (!tokens.next(src) || !tokens.next(numNeighbors))
+                            return;
+                          chunk.maxNode = std::max(chunk.maxNode, src);
+                          uint64_t dst;
+                          for (; numNeighbors > 0 && tokens.next(dst);
+                               --numNeighbors)
+                            chunk.push(src, dst);
+                        },
+                        edges);
+
+    writeTextEdges(edges, edges.maxNode + 1, outfilename);
   }
 };
 
@@ -2018,6 +2190,71 @@ struct Cleanup : public Conversion {
   }
 };
 
+/**
+ * Compresses the adjacency lists of a binary gr. Neighbors are sorted and
+ * stored as varint encoded gaps; the output is read by readGraph() into a
+ * LC_Compressed_Graph without re-encoding.
+ */
+struct Gr2CompressedGr : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::graphs::LC_Compressed_Graph<void, EdgeTy, true> Graph;
+
+    Graph graph;
+    galois::graphs::readGraph(graph, infilename);
+    graph.toFile(outfilename);
+
+    printStatus(graph.size(), graph.sizeEdges());
+    std::cout << "Edge bytes: " << graph.sizeEdgeBytes() << " (vs "
+              << graph.sizeEdges() * sizeof(uint32_t) << " uncompressed)\n";
+  }
+};
+
+/**
+ * Relabels nodes with one of the orderings in galois/graphs/Reorder.h. The
+ * permutation is written to -outputNodePermutation.
+ */
+struct Reorder : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    typedef galois::graphs::FileGraph Graph;
+    typedef galois::LargeArray<Graph::GraphNode> Permutation;
+
+    Graph graph, out;
+    graph.fromFile(infilename);
+
+    Permutation perm;
+    perm.create(graph.size());
+
+    galois::Timer timer;
+    timer.start();
+    switch (reorderPolicy) {
+    case degree:
+      galois::graphs::degreeSortPermutation(graph, perm);
+      break;
+    case hubcluster:
+      galois::graphs::hubClusterPermutation(graph, perm);
+      break;
+    case rcm:
+      galois::graphs::rcmPermutation(graph, perm);
+      break;
+    case gorder:
+      galois::graphs::gorderPermutation(graph, perm, gorderWindow);
+      break;
+    default:
+      abort();
+    }
+    timer.stop();
+    std::cout << "Ordering time: " << timer.get() << " ms\n";
+
+    galois::graphs::relabel<EdgeTy>(graph, perm, out);
+    outputPermutation(perm);
+
+    out.toFile(outfilename);
+    printStatus(out.size(), out.sizeEdges());
+  }
+};
+
 template <template <typename, typename> class SortBy, bool NeedsEdgeData>
 struct SortEdges
     : public boost::mpl::if_c<NeedsEdgeData, HasNoVoidSpecialization,
@@ -2146,102 +2383,64 @@ struct MakeUnsymmetric : public Conversion {
 struct Dimacs2Gr : public HasNoVoidSpecialization {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
-    typedef galois::graphs::FileGraphWriter Writer;
-    typedef galois::LargeArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
-
-    Writer p;
-    EdgeData edgeData;
-    uint32_t nnodes;
-    size_t nedges;
-
-    for (int phase = 0; phase < 2; ++phase) {
-      std::ifstream infile(infilename.c_str());
-
-      // Skip comments
-      while (infile) {
-        if (infile.peek() == 'p') {
-          break;
-        }
-        infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-      }
-
-      // Read header
-      char header[256];
-      infile.getline(header, 256);
-      std::istringstream line(header, std::istringstream::in);
-      std::vector<std::string> tokens;
-      while (line) {
-        std::string tmp;
-        line >> tmp;
-        if (line) {
-          tokens.push_back(tmp);
-        }
-      }
-      if (tokens.size() < 3 || tokens[0].compare("p") != 0) {
-        GALOIS_DIE("Unknown problem specification line: ", line.str());
-      }
-      // Prefer C functions for maximum compatibility
-      // nnodes = std::stoull(tokens[tokens.size() - 2]);
-      // nedges = std::stoull(tokens[tokens.size() - 1]);
-      nnodes = strtoull(tokens[tokens.size() - 2].c_str(), NULL, 0);
-      nedges = strtoull(tokens[tokens.size() - 1].c_str(), NULL, 0);
-
-      // Parse edges
-      if (phase == 0) {
-        p.setNumNodes(nnodes);
-        p.setNumEdges(nedges);
-        p.setSizeofEdgeData(EdgeData::size_of::value);
-        edgeData.create(nedges);
-        p.phase1();
-      } else {
-        p.phase2();
-      }
-
-      for (size_t edge_num = 0; edge_num < nedges; ++edge_num) {
-        uint32_t cur_id, neighbor_id;
-        int32_t weight;
-        std::string tmp;
-        infile >> tmp;
-
-        if (tmp.compare("a") != 0) {
-          --edge_num;
-          infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-          continue;
-        }
-
-        infile >> cur_id >> neighbor_id >> weight;
-        if (cur_id == 0 || cur_id > nnodes) {
-          GALOIS_DIE("Error: node id out of range: ", cur_id);
-        }
-        if (neighbor_id == 0 || neighbor_id > nnodes) {
-          GALOIS_DIE("Error: neighbor id out of range: ", neighbor_id);
-        }
-
-        // 1 indexed
-        if (phase == 0) {
-          p.incrementDegree(cur_id - 1);
-        } else {
-          edgeData.set(p.addNeighbor(cur_id - 1, neighbor_id - 1), weight);
-        }
-
-        infile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-      }
+    typedef typename TextChunk<EdgeTy>::edge_value_type edge_value_type;
+
+    TextFile file(infilename);
+
+    // Skip comments
+    const char* start = file.begin();
+    while (start != file.end() && *start != 'p')
+      start = file.nextLine(start);
+
+    // Read header: p <problem> <num nodes> <num edges>
+    const char* eol = file.lineEnd(start);
+    LineTokens header(start, eol, ' ');
+    std::vector<uint64_t> numbers;
+    header.skipToken();
+    while (header.peek() != '\0') {
+      uint64_t v;
+      if (header.next(v))
+        numbers.push_back(v);
+      else
+        header.skipToken();
+    }
+    if (start == file.end() || numbers.size() < 2) {
+      GALOIS_DIE("Unknown problem specification line: ",
+                 std::string(start, eol));
+    }
+    uint64_t nnodes = numbers[numbers.size() - 2];
+    uint64_t nedges = numbers[numbers.size() - 1];
+
+    TextEdges<EdgeTy> edges;
+    readTextEdges<EdgeTy>(
+        file, file.nextLine(start), ' ',
+        [&](LineTokens& tokens, TextChunk<EdgeTy>& chunk) {
+          if (tokens.peek() != 'a')
+            return;
+          tokens.skipToken();
+          uint64_t cur_id, neighbor_id;
+          edge_value_type weight{};
+          if (!tokens.next(cur_id) || !tokens.next(neighbor_id) ||
+              !tokens.next(weight)) {
+            GALOIS_DIE("Error: malformed arc line");
+          }
+          if (cur_id == 0 || cur_id > nnodes) {
+            GALOIS_DIE("Error: node id out of range: ", cur_id);
+          }
+          if (neighbor_id == 0 || neighbor_id > nnodes) {
+            GALOIS_DIE("Error: neighbor id out of range: ", neighbor_id);
+          }
+          // 1 indexed
+          chunk.push(cur_id - 1, neighbor_id - 1, weight);
+        },
+        edges);
 
-      infile.peek();
-      if (!infile.eof()) {
-        GALOIS_DIE("Error: additional lines in file");
-      }
+    if (edges.size() != nedges) {
+      GALOIS_DIE("Error: expected ", nedges, " arcs but found ",
+                 edges.size());
     }
 
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(std::make_move_iterator(edgeData.begin()),
-                              std::make_move_iterator(edgeData.end()),
-                              rawEdgeData);
-
-    p.toFile(outfilename);
-    printStatus(p.size(), p.sizeEdges());
+    writeTextEdges(edges, nnodes, outfilename);
   }
 };
 
@@ -2940,6 +3139,7 @@ struct Svmlight2Gr : public HasNoVoidSpecialization {
 int main(int argc, char** argv) {
   galois::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  galois::setActiveThreads(numThreads);
   std::ios_base::sync_with_stdio(false);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
@@ -2975,6 +3175,9 @@ int main(int argc, char** argv) {
   case gr2cgr:
     convert<Cleanup>();
     break;
+  case gr2compressedgr:
+    convert<Gr2CompressedGr>();
+    break;
   case gr2dimacs:
     convert<Gr2Dimacs>();
     break;
@@ -3014,6 +3217,9 @@ int main(int argc, char** argv) {
   case gr2randomweightgr:
     convert<RandomizeEdgeWeights>();
     break;
+  case gr2reorderedgr:
+    convert<Reorder>();
+    break;
   case gr2ringgr:
     convert<AddRing<false>>();
     break;
@@ -0,0 +1,206 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting parallelism.
+ * The code is being released under the terms of the 3-Clause BSD License (a
+ * copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+/**
+ * Builds a graph the way applications do at startup (read a .gr, optionally
+ * transpose, sort edges and construct in-edges) and writes it as a snapshot
+ * that LC_CSR_Graph::loadSnapshot can map in place.
+ *
+ * With -benchmark, also times startup through the current path against
+ * loading the snapshot. Each startup is followed by one pass over all edges,
+ * since loading a snapshot defers reading pages until they are first used.
+ * With -cold, both files are evicted from the page cache before they are
+ * used.
+ */
+
+#include "galois/Galois.h"
+#include "galois/Timer.h"
+#include "galois/graphs/B_LC_CSR_Graph.h"
+#include "galois/graphs/LCGraph.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <iostream>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cll = llvm::cl;
+
+enum EdgeType { edgeVoid, edgeUint32 };
+
+static cll::opt<std::string>
+    inputFilename(cll::Positional, cll::desc("<input .gr file>"),
+                  cll::Required);
+static cll::opt<std::string>
+    outputFilename(cll::Positional, cll::desc("<output snapshot file>"),
+                   cll::Required);
+static cll::opt<EdgeType> edgeType(
+    "edgeType", cll::desc("Edge data type:"),
+    cll::values(clEnumValN(edgeVoid, "void", "no edge data (default)"),
+                clEnumValN(edgeUint32, "uint32", "uint32 edge data"),
+                clEnumValEnd),
+    cll::init(edgeVoid));
+static cll::opt<bool> transposeGraph("transpose",
+                                     cll::desc("Transpose the graph"),
+                                     cll::init(false));
+static cll::opt<bool> sortByDst("sortByDst",
+                                cll::desc("Sort edges of each node by "
+                                          "destination"),
+                                cll::init(false));
+static cll::opt<bool> inEdges("inEdges",
+                              cll::desc("Also construct and store in-edges"),
+                              cll::init(false));
+static cll::opt<bool>
+    benchmark("benchmark",
+              cll::desc("Compare startup from the input and the snapshot"),
+              cll::init(false));
+static cll::opt<bool> cold("cold",
+                           cll::desc("Evict files from the page cache before "
+                                     "timing (with -benchmark)"),
+                           cll::init(false));
+static cll::opt<int> numThreads("t", cll::desc("Number of threads (default 1)"),
+                                cll::init(1));
+
+//! Drops the (clean) pages of filename from the page cache
+static void evict(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    GALOIS_SYS_DIE("failed opening ", "'", filename, "'");
+  fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+  close(fd);
+}
+
+template <typename GraphTy>
+void constructInEdges(GraphTy&, std::false_type) {}
+
+template <typename GraphTy>
+void constructInEdges(GraphTy& graph, std::true_type) {
+  graph.constructIncomingEdges();
+  if (sortByDst)
+    graph.sortAllInEdgesByDst();
+}
+
+//! Startup as done by applications today
+template <typename GraphTy, bool HasInEdges>
+uint64_t construct(GraphTy& graph) {
+  uint64_t flags = 0;
+  galois::graphs::readGraph(graph, inputFilename);
+  if (transposeGraph) {
+    graph.transpose();
+    flags |= galois::graphs::GraphSnapshot::TRANSPOSED;
+  }
+  if (sortByDst)
+    graph.sortAllEdgesByDst();
+  constructInEdges(graph, std::integral_constant<bool, HasInEdges>());
+  return flags;
+}
+
+//! First use of the graph: visits every edge once
+template <typename GraphTy>
+uint64_t touch(GraphTy& graph) {
+  galois::GAccumulator<uint64_t> sum;
+  galois::do_all(galois::iterate(graph),
+                 [&](typename GraphTy::GraphNode n) {
+                   for (auto e : graph.edges(n, galois::MethodFlag::UNPROTECTED))
+                     sum += graph.getEdgeDst(e);
+                 },
+                 galois::no_stats(), galois::steal());
+  return sum.reduce();
+}
+
+template <typename GraphTy, bool HasInEdges>
+void run() {
+  galois::Timer buildTimer, touchTimer, saveTimer;
+  GraphTy graph;
+
+  if (benchmark && cold)
+    evict(inputFilename);
+  buildTimer.start();
+  uint64_t flags = construct<GraphTy, HasInEdges>(graph);
+  buildTimer.stop();
+  touchTimer.start();
+  uint64_t expected = touch(graph);
+  touchTimer.stop();
+
+  saveTimer.start();
+  graph.saveSnapshot(outputFilename, flags);
+  saveTimer.stop();
+  std::cout << "Wrote " << outputFilename << " (" << graph.size()
+            << " nodes, " << graph.sizeEdges() << " edges) in "
+            << saveTimer.get() << " ms\n";
+
+  if (!benchmark)
+    return;
+
+  galois::Timer loadTimer, loadTouchTimer;
+  GraphTy loaded;
+  if (cold)
+    evict(outputFilename);
+  loadTimer.start();
+  loaded.loadSnapshot(outputFilename);
+  loadTimer.stop();
+  loadTouchTimer.start();
+  uint64_t actual = touch(loaded);
+  loadTouchTimer.stop();
+
+  if (actual != expected)
+    GALOIS_DIE("snapshot does not match input graph");
+
+  std::cout << "Path, Startup(ms), FirstPass(ms), Total(ms)\n";
+  std::cout << "input, " << buildTimer.get() << ", " << touchTimer.get()
+            << ", " << buildTimer.get() + touchTimer.get() << "\n";
+  std::cout << "snapshot, " << loadTimer.get() << ", " << loadTouchTimer.get()
+            << ", " << loadTimer.get() + loadTouchTimer.get() << "\n";
+}
+
+template <typename EdgeTy>
+void run() {
+  typedef typename galois::graphs::LC_CSR_Graph<
+      uint32_t, EdgeTy>::template with_no_lockable<true>::type Graph;
+  typedef galois::graphs::B_LC_CSR_Graph<uint32_t, EdgeTy, false, true>
+      InOutGraph;
+
+  if (inEdges)
+    run<InOutGraph, true>();
+  else
+    run<Graph, false>();
+}
+
+int main(int argc, char** argv) {
+  galois::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  galois::setActiveThreads(numThreads);
+
+  switch (edgeType) {
+  case edgeVoid:
+    run<void>();
+    break;
+  case edgeUint32:
+    run<uint32_t>();
+    break;
+  default:
+    abort();
+  }
+  return 0;
+}